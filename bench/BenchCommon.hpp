@@ -0,0 +1,94 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <thread>
+#include <vector>
+
+#include <Magnum/Math/Vector3.h>
+#include <core/Logger.hpp>
+#include <world/IChunkProvider.hpp>
+#include <world/World.hpp>
+
+namespace mc::bench
+{
+
+class Stopwatch
+{
+public:
+    using clock = std::chrono::steady_clock;
+
+    void restart()
+    {
+        m_start = clock::now();
+    }
+
+    [[nodiscard]] double elapsedSeconds() const
+    {
+        return std::chrono::duration<double>(clock::now() - m_start).count();
+    }
+
+private:
+    clock::time_point m_start{clock::now()};
+};
+
+/**
+ * @brief Exposes the chunks loaded by a World to client-side code such as the mesher.
+ */
+class WorldChunkProvider final : public world::IChunkProvider
+{
+public:
+    explicit WorldChunkProvider(world::World const& world)
+        : m_world{world} {}
+
+    [[nodiscard]] std::optional<std::reference_wrapper<world::Chunk const>> getChunk(Magnum::Vector3i const& chunkPos) const override
+    {
+        if (auto const* chunk = m_world.getChunk(chunkPos))
+            return std::cref(*chunk);
+        return std::nullopt;
+    }
+
+private:
+    world::World const& m_world;
+};
+
+/**
+ * @brief Initializes the logger and silences the per-chunk spam produced by the world.
+ */
+inline void init_logging()
+{
+    core::Logger::init();
+    core::Logger::get()->set_level(spdlog::level::warn);
+}
+
+/**
+ * @brief Loads every chunk within a circular radius through the regular World path and waits for it.
+ *
+ * Uses the same radius test as ChunkLoadingSystem. All chunks are submitted at once, so
+ * they are grouped into region jobs when the world batches regions.
+ *
+ * @return Number of chunks requested.
+ */
+inline std::size_t load_world(world::World& world, Magnum::Vector3i const& center, int radius)
+{
+    float const r = static_cast<float>(radius) + 0.5f;
+    std::vector<Magnum::Vector3i> positions;
+    for (int x = -radius; x <= radius; ++x)
+    {
+        for (int z = -radius; z <= radius; ++z)
+        {
+            if (static_cast<float>(x * x + z * z) > r * r) continue;
+            positions.push_back(center + Magnum::Vector3i{x, 0, z});
+        }
+    }
+    world.submitChunkLoads(positions);
+
+    while (!world.getPendingChunks().empty())
+    {
+        world.integrateFinishedChunks();
+        std::this_thread::sleep_for(std::chrono::milliseconds{1});
+    }
+    return positions.size();
+}
+
+} // namespace mc::bench
@@ -0,0 +1,145 @@
+#include "BenchCommon.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <print>
+#include <string>
+#include <vector>
+
+#include <world/Chunk.hpp>
+#include <world/ChunkGenerator.hpp>
+#include <world/ClimateMap.hpp>
+
+namespace
+{
+using namespace mc::world;
+
+Magnum::Vector3i chunk_at(int i)
+{
+    return {i % 32 - 16, 0, i / 32 - 16};
+}
+
+/**
+ * @brief Microseconds per chunk to run TERRAIN, SURFACE and FEATURES on @p count chunks.
+ */
+double generation_us(ChunkGenerator const& generator, int count)
+{
+    Chunk chunk{{0, 0, 0}};
+    std::vector<ChunkGenerator::Decoration> overflow;
+    mc::bench::Stopwatch stopwatch;
+    for (int i = 0; i < count; ++i)
+    {
+        chunk.reset(chunk_at(i));
+        overflow.clear();
+        generator.generate(chunk);
+        generator.generateFeatures(chunk, overflow);
+    }
+    return stopwatch.elapsedSeconds() * 1e6 / count;
+}
+
+bool same_climate(Climate const& a, Climate const& b)
+{
+    return a.temperature == b.temperature && a.humidity == b.humidity && a.continentalness == b.continentalness;
+}
+
+/**
+ * @brief Largest change of any climate field between neighbouring columns, over a
+ * square of @p side columns crossing chunk borders.
+ */
+float max_climate_step(ClimateMap const& climate, int side)
+{
+    std::vector<Climate> columns(static_cast<std::size_t>(side) * side);
+    climate.sample(-side / 2, -side / 2, side, side, columns);
+
+    float maxStep = 0.0f;
+    auto const step = [&](Climate const& a, Climate const& b) {
+        maxStep = std::max({maxStep,
+            std::abs(a.temperature - b.temperature),
+            std::abs(a.humidity - b.humidity),
+            std::abs(a.continentalness - b.continentalness)});
+    };
+    for (int z = 0; z < side; ++z)
+    {
+        for (int x = 0; x < side; ++x)
+        {
+            auto const& column = columns[static_cast<std::size_t>(z) * side + x];
+            if (x + 1 < side) step(column, columns[static_cast<std::size_t>(z) * side + x + 1]);
+            if (z + 1 < side) step(column, columns[static_cast<std::size_t>(z + 1) * side + x]);
+        }
+    }
+    return maxStep;
+}
+} // namespace
+
+/**
+ * Generates chunks with and without biomes and reports the cost of biome shaping per
+ * chunk, the climate cache hit rate and how the biomes are distributed. Checks that
+ * cached climate matches climate computed from scratch, and that climate changes
+ * smoothly across chunk borders.
+ *
+ * Usage: biome_bench [chunks] [seed]
+ */
+int main(int argc, char** argv)
+{
+    int const count = argc > 1 ? std::stoi(argv[1]) : 1024;
+    int32_t const seed = argc > 2 ? std::stoi(argv[2]) : 1337;
+    constexpr int BIOME_MAP_RADIUS = 4096; ///< Blocks around the origin the distribution is taken over.
+    constexpr int CONTINUITY_SIDE = 256;
+    constexpr float MAX_STEP = 0.05f; ///< The climate noise cannot move further in one block.
+
+    ChunkGenerator const plain{seed};
+    double const plainUs = generation_us(plain, count);
+
+    ChunkGenerator biomes{seed};
+    biomes.setBiomesEnabled(true);
+    double const biomeUs = generation_us(biomes, count);
+    auto const stats = biomes.getClimateMap().getStats();
+
+    std::println("{} chunks: heightmap {:.2f} us/chunk, with biomes {:.2f} us/chunk ({:+.1f}%)",
+        count, plainUs, biomeUs, 100.0 * (biomeUs / plainUs - 1.0));
+    std::println("climate cache: {} lookups, {:.1f}% hits, {} tiles",
+        stats.lookups, 100.0 * stats.hitRate(), stats.tiles);
+
+    std::array<std::size_t, BIOME_COUNT> biomeChunks{};
+    std::size_t sampled = 0;
+    for (int z = -BIOME_MAP_RADIUS; z < BIOME_MAP_RADIUS; z += CHUNK_SIZE_Z)
+    {
+        for (int x = -BIOME_MAP_RADIUS; x < BIOME_MAP_RADIUS; x += CHUNK_SIZE_X)
+        {
+            ++biomeChunks[static_cast<std::size_t>(biomes.getBiome(x, z))];
+            ++sampled;
+        }
+    }
+    for (std::size_t biome = 0; biome < BIOME_COUNT; ++biome)
+    {
+        std::println("{:<14}{:>6.1f}%", biome_name(static_cast<Biome>(biome)),
+            100.0 * static_cast<double>(biomeChunks[biome]) / static_cast<double>(sampled));
+    }
+
+    // A single-tile cache recomputes nearly every tile, so it stands in for no cache
+    ClimateMap const uncached{seed, 1};
+    for (int i = 0; i < count; ++i)
+    {
+        Magnum::Vector3i const origin = chunk_at(i) * Magnum::Vector3i{CHUNK_SIZE_X, 0, CHUNK_SIZE_Z};
+        for (int column = 0; column < CHUNK_SLICE_AREA; column += 37)
+        {
+            int const x = origin.x() + column % CHUNK_SIZE_X;
+            int const z = origin.z() + column / CHUNK_SIZE_X;
+            if (!same_climate(biomes.getClimateMap().sampleAt(x, z), uncached.sampleAt(x, z)))
+            {
+                std::println(stderr, "cached climate differs at [{}, {}]", x, z);
+                return 1;
+            }
+        }
+    }
+
+    float const maxStep = max_climate_step(uncached, CONTINUITY_SIDE);
+    std::println("largest climate step between neighbouring columns: {:.4f}", maxStep);
+    if (maxStep > MAX_STEP)
+    {
+        std::println(stderr, "climate jumps by {:.4f} between neighbouring columns", maxStep);
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,123 @@
+#include "BenchCommon.hpp"
+
+#include <array>
+#include <print>
+#include <string>
+#include <vector>
+
+#include <world/Chunk.hpp>
+#include <world/ChunkGenerator.hpp>
+
+namespace
+{
+using namespace mc::world;
+
+// Reads mimic the mesher (visit every block, test solidity); writes mimic the generator
+// (fill every block of a fresh chunk). Each is measured through three access paths.
+
+std::size_t read_checked(Chunk const& chunk)
+{
+    std::size_t solid = 0;
+    for (int x = 0; x < CHUNK_SIZE_X; ++x)
+        for (int y = 0; y < CHUNK_SIZE_Y; ++y)
+            for (int z = 0; z < CHUNK_SIZE_Z; ++z)
+                solid += chunk.getBlock(x, y, z).isSolid();
+    return solid;
+}
+
+std::size_t read_unchecked(Chunk const& chunk)
+{
+    std::size_t solid = 0;
+    for (int y = 0; y < CHUNK_SIZE_Y; ++y)
+        for (int z = 0; z < CHUNK_SIZE_Z; ++z)
+            for (int x = 0; x < CHUNK_SIZE_X; ++x)
+                solid += chunk.getBlockUnchecked(x, y, z).isSolid();
+    return solid;
+}
+
+std::size_t read_slices(Chunk const& chunk)
+{
+    std::size_t solid = 0;
+    std::array<Block, CHUNK_SLICE_AREA> slice;
+    for (int y = 0; y < CHUNK_SIZE_Y; ++y)
+    {
+        chunk.slice(y, slice);
+        for (auto const& block : slice)
+            solid += block.isSolid();
+    }
+    return solid;
+}
+
+void write_checked(Chunk const& source, Chunk& target)
+{
+    for (int x = 0; x < CHUNK_SIZE_X; ++x)
+        for (int y = 0; y < CHUNK_SIZE_Y; ++y)
+            for (int z = 0; z < CHUNK_SIZE_Z; ++z)
+                target.setBlock(x, y, z, source.getBlockUnchecked(x, y, z));
+}
+
+void write_unchecked(Chunk const& source, Chunk& target)
+{
+    for (int y = 0; y < CHUNK_SIZE_Y; ++y)
+        for (int z = 0; z < CHUNK_SIZE_Z; ++z)
+            for (int x = 0; x < CHUNK_SIZE_X; ++x)
+                target.setBlockUnchecked(x, y, z, source.getBlockUnchecked(x, y, z));
+}
+
+void write_slices(Chunk const& source, Chunk& target)
+{
+    std::array<Block, CHUNK_SLICE_AREA> slice;
+    for (int y = 0; y < CHUNK_SIZE_Y; ++y)
+    {
+        source.slice(y, slice);
+        target.setSlice(y, slice);
+    }
+}
+
+template <typename FN>
+double ns_per_block(std::vector<Chunk> const& chunks, FN&& fn)
+{
+    mc::bench::Stopwatch stopwatch;
+    for (auto const& chunk : chunks)
+        fn(chunk);
+    return stopwatch.elapsedSeconds() * 1e9 / (static_cast<double>(chunks.size()) * CHUNK_VOLUME);
+}
+} // namespace
+
+/**
+ * Compares checked per-block access in the old x/y/z order against unchecked access in
+ * storage order and slice-based bulk access, for mesher-style reads and generator-style writes.
+ *
+ * Usage: chunk_access_bench [chunks] [seed]
+ */
+int main(int argc, char** argv)
+{
+    int const count = argc > 1 ? std::stoi(argv[1]) : 64;
+    int32_t const seed = argc > 2 ? std::stoi(argv[2]) : 1337;
+
+    ChunkGenerator const generator{seed};
+    std::vector<Chunk> chunks;
+    chunks.reserve(count);
+    for (int i = 0; i < count; ++i)
+        chunks.push_back(generator.generate({i % 8, 0, i / 8}));
+
+    std::size_t checksum[3]{};
+    double const readChecked = ns_per_block(chunks, [&](Chunk const& c) { checksum[0] += read_checked(c); });
+    double const readUnchecked = ns_per_block(chunks, [&](Chunk const& c) { checksum[1] += read_unchecked(c); });
+    double const readSlices = ns_per_block(chunks, [&](Chunk const& c) { checksum[2] += read_slices(c); });
+    if (checksum[0] != checksum[1] || checksum[0] != checksum[2])
+    {
+        std::println(stderr, "read paths disagree: {} / {} / {}", checksum[0], checksum[1], checksum[2]);
+        return 1;
+    }
+
+    double const writeChecked = ns_per_block(chunks, [](Chunk const& c) { Chunk t{c.getPosition()}; write_checked(c, t); });
+    double const writeUnchecked = ns_per_block(chunks, [](Chunk const& c) { Chunk t{c.getPosition()}; write_unchecked(c, t); });
+    double const writeSlices = ns_per_block(chunks, [](Chunk const& c) { Chunk t{c.getPosition()}; write_slices(c, t); });
+
+    std::println("{} generated chunks, ns per block", count);
+    std::println("{:<28}{:>10}{:>12}{:>10}", "", "checked", "unchecked", "slices");
+    std::println("{:<28}{:>10.2f}{:>12.2f}{:>10.2f}", "meshing-style reads", readChecked, readUnchecked, readSlices);
+    std::println("{:<28}{:>10.2f}{:>12.2f}{:>10.2f}", "generation-style writes", writeChecked, writeUnchecked, writeSlices);
+    return 0;
+}
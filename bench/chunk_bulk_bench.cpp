@@ -0,0 +1,184 @@
+#include "BenchCommon.hpp"
+
+#include <array>
+#include <print>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <world/Chunk.hpp>
+#include <world/ChunkGenerator.hpp>
+#include <world/PackedKernels.hpp>
+
+namespace
+{
+using namespace mc::world;
+
+// Per-block reference implementations, the baseline each bulk operation is timed against
+
+void replace_per_block(Chunk& chunk, BlockType from, BlockType to)
+{
+    for (int y = 0; y < CHUNK_SIZE_Y; ++y)
+        for (int z = 0; z < CHUNK_SIZE_Z; ++z)
+            for (int x = 0; x < CHUNK_SIZE_X; ++x)
+                if (chunk.getBlockUnchecked(x, y, z).type == from)
+                    chunk.setBlockUnchecked(x, y, z, Block{to});
+}
+
+void fill_per_block(Chunk& chunk, Magnum::Vector3i const& min, Magnum::Vector3i const& max, Block block)
+{
+    for (int y = min.y(); y <= max.y(); ++y)
+        for (int z = min.z(); z <= max.z(); ++z)
+            for (int x = min.x(); x <= max.x(); ++x)
+                chunk.setBlock(x, y, z, block);
+}
+
+std::array<std::size_t, BLOCK_TYPE_COUNT> count_per_block(Chunk const& chunk)
+{
+    std::array<std::size_t, BLOCK_TYPE_COUNT> counts{};
+    for (int y = 0; y < CHUNK_SIZE_Y; ++y)
+        for (int z = 0; z < CHUNK_SIZE_Z; ++z)
+            for (int x = 0; x < CHUNK_SIZE_X; ++x)
+                ++counts[static_cast<std::size_t>(chunk.getBlockUnchecked(x, y, z).type)];
+    return counts;
+}
+
+void masks_per_block(Chunk const& chunk, BlockFlag flag, std::span<ColumnMask, CHUNK_SLICE_AREA> out)
+{
+    std::ranges::fill(out, ColumnMask{});
+    for (int y = 0; y < CHUNK_SIZE_Y; ++y)
+        for (int z = 0; z < CHUNK_SIZE_Z; ++z)
+            for (int x = 0; x < CHUNK_SIZE_X; ++x)
+                if (has_flag(chunk.getBlockUnchecked(x, y, z).flags(), flag))
+                    out[static_cast<std::size_t>(z) * CHUNK_SIZE_X + x][y / 64] |= uint64_t{1} << (y % 64);
+}
+
+struct Timings
+{
+    double bulk = 0.0;
+    double perBlock = 0.0;
+};
+
+void print_row(char const* name, Timings const& t, std::size_t chunks)
+{
+    double const bulkUs = t.bulk * 1e6 / static_cast<double>(chunks);
+    double const perBlockUs = t.perBlock * 1e6 / static_cast<double>(chunks);
+    std::println("{:<18}{:>12.2f}{:>12.2f}{:>10.1f}x", name, bulkUs, perBlockUs, perBlockUs / bulkUs);
+}
+} // namespace
+
+/**
+ * Times the packed kernels (scalar and AVX2) and the bulk Chunk operations built on
+ * them against per-block reference implementations. Their results are checked
+ * against the same references by the unit tests.
+ *
+ * Usage: chunk_bulk_bench [chunks] [seed]
+ */
+int main(int argc, char** argv)
+{
+    int const count = argc > 1 ? std::stoi(argv[1]) : 64;
+    int32_t const seed = argc > 2 ? std::stoi(argv[2]) : 1337;
+    std::mt19937_64 rng{static_cast<uint64_t>(seed)};
+
+    bool const hasAvx2 = packed::best_isa() == packed::Isa::AVX2;
+    std::vector<packed::Isa> isas{packed::Isa::SCALAR};
+    if (hasAvx2)
+        isas.push_back(packed::Isa::AVX2);
+    std::println("timing {}", hasAvx2 ? "scalar and AVX2 kernels" : "scalar kernels only, no AVX2 on this CPU");
+
+    // Kernel throughput on a 4-bit section, the common width of surface sections
+    {
+        std::vector<uint64_t> words(SECTION_VOLUME / 16);
+        for (auto& word : words)
+            word = rng();
+        std::vector<uint8_t> const lut{0, 1, 1, 0, 1, 0, 0, 1, 1, 1, 0, 0, 0, 1, 0, 1};
+        std::vector<uint64_t> out(SECTION_MASK_WORDS);
+        constexpr int ROUNDS = 20000;
+        for (auto isa : isas)
+        {
+            mc::bench::Stopwatch stopwatch;
+            for (int i = 0; i < ROUNDS; ++i)
+                packed::match(words, 4, SECTION_VOLUME, lut, out, isa);
+            double const matchNs = stopwatch.elapsedSeconds() * 1e9 / ROUNDS;
+            stopwatch.restart();
+            for (int i = 0; i < ROUNDS; ++i)
+                packed::replace(words, 4, SECTION_VOLUME, static_cast<uint16_t>(i & 15), static_cast<uint16_t>((i + 5) & 15), isa);
+            double const replaceNs = stopwatch.elapsedSeconds() * 1e9 / ROUNDS;
+            std::println("{:<7} 4-bit section: match {:8.1f} ns, replace {:8.1f} ns", isa == packed::Isa::AVX2 ? "AVX2" : "scalar", matchNs, replaceNs);
+        }
+    }
+
+    ChunkGenerator const generator{seed};
+    std::vector<Chunk> chunks;
+    chunks.reserve(count);
+    for (int i = 0; i < count; ++i)
+        chunks.push_back(generator.generate({i % 8, 0, i / 8}));
+
+    Timings countTime, maskTime, replaceTime, fillTime;
+    std::array<ColumnMask, CHUNK_SLICE_AREA> masks;
+    std::array<ColumnMask, CHUNK_SLICE_AREA> expectedMasks;
+    std::uniform_int_distribution<int> coordinate{0, CHUNK_SIZE_X - 1};
+    std::uniform_int_distribution<int> height{0, CHUNK_SIZE_Y - 1};
+    std::size_t blocksCounted = 0;
+    for (auto const& source : chunks)
+    {
+        mc::bench::Stopwatch stopwatch;
+        auto const counts = source.countBlocksByType();
+        countTime.bulk += stopwatch.elapsedSeconds();
+        stopwatch.restart();
+        auto const expectedCounts = count_per_block(source);
+        countTime.perBlock += stopwatch.elapsedSeconds();
+        blocksCounted += counts[0] + expectedCounts[0];
+
+        for (auto flag : {BlockFlag::SOLID, BlockFlag::OCCLUDING})
+        {
+            stopwatch.restart();
+            source.buildColumnMasks(flag, masks);
+            maskTime.bulk += stopwatch.elapsedSeconds();
+            stopwatch.restart();
+            masks_per_block(source, flag, expectedMasks);
+            maskTime.perBlock += stopwatch.elapsedSeconds();
+        }
+
+        // DIRT -> STONE keeps heightmaps, GRASS -> AIR lowers them
+        for (auto [from, to] : {std::pair{BlockType::DIRT, BlockType::STONE}, std::pair{BlockType::GRASS, BlockType::AIR}})
+        {
+            Chunk bulk = source;
+            Chunk reference = source;
+            stopwatch.restart();
+            bulk.replaceBlocks(from, to);
+            replaceTime.bulk += stopwatch.elapsedSeconds();
+            stopwatch.restart();
+            replace_per_block(reference, from, to);
+            replaceTime.perBlock += stopwatch.elapsedSeconds();
+        }
+
+        // Random boxes, including full-width and multi-section ones
+        Chunk bulk = source;
+        Chunk reference = source;
+        for (int i = 0; i < 8; ++i)
+        {
+            int const x0 = i % 4 == 0 ? 0 : coordinate(rng), x1 = i % 4 == 0 ? CHUNK_SIZE_X - 1 : coordinate(rng);
+            int const z0 = i % 2 == 0 ? 0 : coordinate(rng), z1 = i % 2 == 0 ? CHUNK_SIZE_Z - 1 : coordinate(rng);
+            int const y0 = height(rng), y1 = height(rng);
+            Magnum::Vector3i const min{std::min(x0, x1), std::min(y0, y1), std::min(z0, z1)};
+            Magnum::Vector3i const max{std::max(x0, x1), std::max(y0, y1), std::max(z0, z1)};
+            Block const block{static_cast<BlockType>(rng() % BLOCK_TYPE_COUNT)};
+
+            stopwatch.restart();
+            bulk.fillRegion(min, max, block);
+            fillTime.bulk += stopwatch.elapsedSeconds();
+            stopwatch.restart();
+            fill_per_block(reference, min, max, block);
+            fillTime.perBlock += stopwatch.elapsedSeconds();
+        }
+    }
+
+    std::println("{} generated chunks, {} air blocks; us per chunk", count, blocksCounted / 2);
+    std::println("{:<18}{:>12}{:>12}{:>11}", "", "bulk", "per-block", "speedup");
+    print_row("count by type", countTime, chunks.size());
+    print_row("column masks x2", maskTime, chunks.size());
+    print_row("replace x2", replaceTime, chunks.size());
+    print_row("fill 8 boxes", fillTime, chunks.size());
+    return 0;
+}
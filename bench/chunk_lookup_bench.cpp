@@ -0,0 +1,80 @@
+#include "BenchCommon.hpp"
+
+#include <print>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <concurrencpp/concurrencpp.h>
+#include <ecs/events/EventBus.hpp>
+#include <world/Chunk.hpp>
+#include <world/World.hpp>
+
+namespace
+{
+using namespace mc;
+
+template <typename FN>
+double ns_per_lookup(std::vector<Magnum::Vector3i> const& queries, int rounds, std::size_t& hits, FN&& lookup)
+{
+    bench::Stopwatch stopwatch;
+    for (int round = 0; round < rounds; ++round)
+        for (auto const& pos : queries)
+            hits += lookup(pos) != nullptr;
+    return stopwatch.elapsedSeconds() * 1e9 / (static_cast<double>(queries.size()) * rounds);
+}
+} // namespace
+
+/**
+ * Compares World::getChunk (toroidal grid around the player, map fallback) against a
+ * plain find in the hashed chunk map. Queries are chunk positions of random block
+ * positions around the player, like CollisionSystem issues; a few land outside the grid.
+ *
+ * Usage: chunk_lookup_bench [radius] [seed]
+ */
+int main(int argc, char** argv)
+{
+    int const radius = argc > 1 ? std::stoi(argv[1]) : 16;
+    int32_t const seed = argc > 2 ? std::stoi(argv[2]) : 1337;
+    constexpr int ROUNDS = 20;
+    constexpr int GRID_MARGIN = 2; // Same buffer ChunkLoadingSystem keeps before unloading
+
+    bench::init_logging();
+    concurrencpp::runtime runtime;
+    ecs::EventBus eventBus;
+    world::World world{runtime.thread_pool_executor(), eventBus, seed};
+    world.recenterChunkGrid({0, 0, 0}, static_cast<uint8_t>(radius + GRID_MARGIN));
+    bench::load_world(world, {0, 0, 0}, radius);
+
+    std::mt19937 rng{static_cast<uint32_t>(seed)};
+    int const extent = (radius + 2 * GRID_MARGIN) * world::CHUNK_SIZE_X;
+    std::uniform_int_distribution<int> coord{-extent, extent - 1};
+    std::vector<Magnum::Vector3i> queries(1 << 20);
+    for (auto& query : queries)
+        query = world::Chunk::getChunkOfPosition(Magnum::Vector3i{coord(rng), 64, coord(rng)});
+
+    auto const& chunks = world.getChunks();
+    std::size_t mapHits = 0;
+    std::size_t gridHits = 0;
+    double const mapNs = ns_per_lookup(queries, ROUNDS, mapHits, [&chunks](Magnum::Vector3i const& pos) -> world::Chunk const* {
+        auto it = chunks.find(pos);
+        return it != chunks.end() ? it->second : nullptr;
+    });
+    double const gridNs = ns_per_lookup(queries, ROUNDS, gridHits, [&world](Magnum::Vector3i const& pos) {
+        return world.getChunk(pos);
+    });
+
+    if (mapHits != gridHits)
+    {
+        std::println(stderr, "lookup paths disagree: {} / {} hits", mapHits, gridHits);
+        return 1;
+    }
+
+    std::println("radius {}: {} chunks loaded, {} queries x {} rounds, {:.1f}% hits",
+        radius, world.getLoadedChunkCount(), queries.size(), ROUNDS,
+        100.0 * static_cast<double>(mapHits) / (static_cast<double>(queries.size()) * ROUNDS));
+    std::println("hashed map : {:6.2f} ns/lookup ({:7.1f} M/s)", mapNs, 1e3 / mapNs);
+    std::println("chunk grid : {:6.2f} ns/lookup ({:7.1f} M/s)", gridNs, 1e3 / gridNs);
+    std::println("speedup    : {:6.2f}x", mapNs / gridNs);
+    return 0;
+}
@@ -0,0 +1,72 @@
+#include "BenchCommon.hpp"
+
+#include <print>
+#include <ranges>
+#include <string>
+
+#include <concurrencpp/concurrencpp.h>
+#include <ecs/events/EventBus.hpp>
+#include <world/Chunk.hpp>
+#include <world/World.hpp>
+
+/**
+ * Loads a world of the given radius (default 32) through World and compares the
+ * memory held by palette-compressed chunks, with identical sections interned, against
+ * the old dense block array.
+ * The world is then walked one radius along +X, unloading behind and loading ahead,
+ * to report how well the chunk pool recycles unloaded chunks.
+ *
+ * Usage: chunk_memory_bench [radius] [seed]
+ */
+int main(int argc, char** argv)
+{
+    using namespace mc;
+
+    int const radius = argc > 1 ? std::stoi(argv[1]) : 32;
+    int32_t const seed = argc > 2 ? std::stoi(argv[2]) : 1337;
+
+    bench::init_logging();
+    concurrencpp::runtime runtime;
+    ecs::EventBus eventBus;
+    world::World world{runtime.thread_pool_executor(), eventBus, seed};
+
+    bench::Stopwatch stopwatch;
+    std::size_t const requested = bench::load_world(world, {0, 0, 0}, radius);
+    double const loadSeconds = stopwatch.elapsedSeconds();
+
+    auto const sections = world.getSectionTableStats();
+    std::size_t palettedBytes = sections.memoryUsage;
+    std::size_t sharedSections = 0;
+    for (auto const* chunk : world.getChunks() | std::views::values)
+    {
+        palettedBytes += chunk->memoryUsage();
+        sharedSections += static_cast<std::size_t>(chunk->getSharedSectionCount());
+    }
+
+    std::size_t const chunks = world.getLoadedChunkCount();
+    std::size_t const denseBytes = chunks * (sizeof(Magnum::Vector3i) + world::CHUNK_VOLUME * sizeof(world::Block));
+    auto const mib = [](std::size_t bytes) { return static_cast<double>(bytes) / (1024.0 * 1024.0); };
+
+    std::println("radius {} seed {}: {} chunks requested, {} loaded in {:.2f} s", radius, seed, requested, chunks, loadSeconds);
+    std::println("dense    : {:10.2f} MiB ({:.1f} KiB/chunk)", mib(denseBytes), static_cast<double>(denseBytes) / 1024.0 / chunks);
+    std::println("paletted : {:10.2f} MiB ({:.1f} KiB/chunk)", mib(palettedBytes), static_cast<double>(palettedBytes) / 1024.0 / chunks);
+    std::println("ratio    : {:10.2f}x", static_cast<double>(denseBytes) / static_cast<double>(palettedBytes));
+    std::println("sections : {} of {} shared; {} interned sections stand in for {} non-air ones ({:.1f}% hits, {:.2f} MiB)",
+        sharedSections,
+        chunks * world::CHUNK_SECTION_COUNT,
+        sections.uniqueSections,
+        sections.lookups,
+        sections.lookups == 0 ? 0.0 : 100.0 * static_cast<double>(sections.hits) / static_cast<double>(sections.lookups),
+        mib(sections.memoryUsage));
+
+    for (int x = 1; x <= radius; ++x)
+    {
+        world.unloadChunksOutsideRadius({x, 0, 0}, static_cast<uint8_t>(radius));
+        bench::load_world(world, {x, 0, 0}, radius);
+    }
+
+    auto const& pool = world.getChunkPoolStats();
+    std::println("pool     : {} chunks allocated, {} in use ({:.1f}% occupancy), {:.1f}% of {} acquisitions reused",
+        pool.capacity, pool.inUse, pool.occupancy() * 100.0, pool.reuseRate() * 100.0, pool.acquisitions);
+    return 0;
+}
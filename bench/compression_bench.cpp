@@ -0,0 +1,172 @@
+#include "BenchCommon.hpp"
+
+#include <cstddef>
+#include <print>
+#include <string>
+#include <vector>
+
+#include <world/Chunk.hpp>
+#include <world/ChunkCompressor.hpp>
+#include <world/ChunkGenerator.hpp>
+#include <world/ChunkSerializer.hpp>
+#include <world/RegionFile.hpp>
+
+namespace
+{
+using namespace mc::world;
+
+struct Config
+{
+    std::string name;
+    CompressionSettings settings;
+    bool dictionary = false;
+};
+
+/**
+ * @brief Encoded chunks of a square of @p side chunks starting at chunk @p origin.
+ */
+void encode_area(ChunkGenerator const& generator, Magnum::Vector3i const& origin, int side, std::vector<std::vector<std::byte>>& out)
+{
+    Chunk chunk{origin};
+    std::vector<ChunkGenerator::Decoration> overflow;
+    for (int z = 0; z < side; ++z)
+    {
+        for (int x = 0; x < side; ++x)
+        {
+            chunk.reset(origin + Magnum::Vector3i{x, 0, z});
+            generator.generate(chunk);
+            generator.generateFeatures(chunk, overflow);
+            out.push_back(ChunkSerializer::encode(chunk));
+        }
+    }
+}
+
+/// Region file sectors a record of @p bytes takes.
+std::size_t sectors_for(std::size_t bytes)
+{
+    return (bytes + sizeof(uint32_t) + REGION_SECTOR_SIZE - 1) / REGION_SECTOR_SIZE;
+}
+} // namespace
+
+/**
+ * Encodes generated chunks and compresses them with every codec and a few levels, Zstd
+ * also with a dictionary trained on chunks from other parts of the world. Reports the
+ * compression ratio over the encoded chunks, the region file sectors a chunk takes, and
+ * compression and decompression throughput of encoded bytes. Checks that every chunk
+ * decompresses back to its encoded bytes.
+ *
+ * Usage: compression_bench [side in chunks] [repetitions] [seed]
+ */
+int main(int argc, char** argv)
+{
+    int const side = argc > 1 ? std::stoi(argv[1]) : 24;
+    int const repetitions = argc > 2 ? std::stoi(argv[2]) : 4;
+    int32_t const seed = argc > 3 ? std::stoi(argv[3]) : 1337;
+
+    ChunkGenerator generator{seed};
+    generator.setBiomesEnabled(true);
+
+    // Trained and measured on different areas, as a world's dictionary is trained once
+    // and then used on chunks it has never seen
+    std::vector<std::vector<std::byte>> samples;
+    encode_area(generator, {-2000, 0, 1500}, 12, samples);
+    encode_area(generator, {900, 0, -700}, 12, samples);
+    std::vector<std::vector<std::byte>> chunks;
+    encode_area(generator, {-side / 2, 0, -side / 2}, side, chunks);
+    encode_area(generator, {3000, 0, 3000}, side, chunks);
+
+    mc::bench::Stopwatch stopwatch;
+    auto dictionary = ChunkCompressor::trainDictionary(samples);
+    double const trainMs = stopwatch.elapsedSeconds() * 1e3;
+
+    std::size_t encodedBytes = 0;
+    std::size_t encodedSectors = 0;
+    for (auto const& chunk : chunks)
+    {
+        encodedBytes += chunk.size();
+        encodedSectors += sectors_for(chunk.size());
+    }
+    double const count = static_cast<double>(chunks.size());
+    double const megabytes = static_cast<double>(encodedBytes) * repetitions / 1e6;
+    std::println("{} chunks, {:.0f} encoded bytes/chunk; {} byte dictionary trained on {} chunks in {:.1f} ms",
+        chunks.size(), static_cast<double>(encodedBytes) / count, dictionary.size(), samples.size(), trainMs);
+
+    std::vector<Config> const configs{
+        {"none", {CompressionCodec::NONE, 0}},
+        {"lz4", {CompressionCodec::LZ4, 0}},
+        {"lz4hc 9", {CompressionCodec::LZ4, 9}},
+        {"zstd 1", {CompressionCodec::ZSTD, 1}},
+        {"zstd 3", {CompressionCodec::ZSTD, 3}},
+        {"zstd 19", {CompressionCodec::ZSTD, 19}},
+        {"zstd 3 dict", {CompressionCodec::ZSTD, 3}, true},
+        {"zstd 19 dict", {CompressionCodec::ZSTD, 19}, true},
+    };
+
+    int failures = 0;
+    std::println("{:<14}{:>8}{:>12}{:>14}{:>16}", "codec", "ratio", "sectors", "compress MB/s", "decompress MB/s");
+    for (auto const& config : configs)
+    {
+        ChunkCompressor const compressor{config.settings, config.dictionary ? dictionary : std::vector<std::byte>{}};
+        std::vector<std::vector<std::byte>> frames(chunks.size());
+
+        stopwatch.restart();
+        for (int r = 0; r < repetitions; ++r)
+        {
+            for (std::size_t i = 0; i < chunks.size(); ++i)
+            {
+                frames[i].clear();
+                compressor.compress(chunks[i], frames[i]);
+            }
+        }
+        double const compressSeconds = stopwatch.elapsedSeconds();
+
+        std::vector<std::byte> decompressed;
+        std::size_t mismatches = 0;
+        stopwatch.restart();
+        for (int r = 0; r < repetitions; ++r)
+        {
+            for (std::size_t i = 0; i < chunks.size(); ++i)
+            {
+                compressor.decompress(frames[i], decompressed);
+                if (r == 0 && decompressed != chunks[i]) ++mismatches;
+            }
+        }
+        double const decompressSeconds = stopwatch.elapsedSeconds();
+
+        std::size_t compressedBytes = 0;
+        std::size_t sectors = 0;
+        for (auto const& frame : frames)
+        {
+            compressedBytes += frame.size();
+            sectors += sectors_for(frame.size());
+        }
+        std::println("{:<14}{:>8.2f}{:>12.2f}{:>14.0f}{:>16.0f}", config.name,
+            static_cast<double>(encodedBytes) / static_cast<double>(compressedBytes),
+            static_cast<double>(sectors) / count, megabytes / compressSeconds, megabytes / decompressSeconds);
+
+        if (mismatches > 0)
+        {
+            std::println(stderr, "FAILED: {} chunks differ after {}", mismatches, config.name);
+            ++failures;
+        }
+    }
+    std::println("uncompressed chunks take {:.2f} sectors", static_cast<double>(encodedSectors) / count);
+
+    // A world must not read frames made with a dictionary it does not have
+    std::vector<std::byte> frame;
+    ChunkCompressor{{CompressionCodec::ZSTD, 3}, dictionary}.compress(chunks.front(), frame);
+    try
+    {
+        std::vector<std::byte> out;
+        ChunkCompressor{{CompressionCodec::ZSTD, 3}}.decompress(frame, out);
+        std::println(stderr, "FAILED: a frame needing a dictionary decompressed without it");
+        ++failures;
+    }
+    catch (ChunkFormatError const&)
+    {
+    }
+
+    if (failures > 0) return 1;
+    std::println("every chunk decompresses unchanged");
+    return 0;
+}
@@ -0,0 +1,109 @@
+#include "BenchCommon.hpp"
+
+#include <format>
+#include <print>
+#include <string>
+#include <vector>
+
+#include <world/Chunk.hpp>
+#include <world/ChunkGenerator.hpp>
+
+namespace
+{
+using namespace mc::world;
+
+Magnum::Vector3i chunk_at(int i)
+{
+    return {i % 16, 0, i / 16};
+}
+
+/**
+ * @brief Microseconds per chunk to generate @p count chunks into a reused chunk.
+ */
+double generation_us(ChunkGenerator const& generator, int count)
+{
+    Chunk chunk{{0, 0, 0}};
+    mc::bench::Stopwatch stopwatch;
+    for (int i = 0; i < count; ++i)
+    {
+        chunk.reset(chunk_at(i));
+        generator.generate(chunk);
+    }
+    return stopwatch.elapsedSeconds() * 1e6 / count;
+}
+
+std::size_t differing_blocks(Chunk const& a, Chunk const& b)
+{
+    std::size_t differing = 0;
+    for (int y = 0; y < CHUNK_SIZE_Y; ++y)
+        for (int z = 0; z < CHUNK_SIZE_Z; ++z)
+            for (int x = 0; x < CHUNK_SIZE_X; ++x)
+                differing += a.getBlockUnchecked(x, y, z).type != b.getBlockUnchecked(x, y, z).type ? 1 : 0;
+    return differing;
+}
+
+/**
+ * @brief Air blocks below the highest solid block of their column: caves and overhangs.
+ */
+std::size_t enclosed_air(Chunk const& chunk)
+{
+    std::size_t air = 0;
+    for (int z = 0; z < CHUNK_SIZE_Z; ++z)
+        for (int x = 0; x < CHUNK_SIZE_X; ++x)
+            for (int y = 0; y < chunk.getHeight(HeightmapType::HIGHEST_SOLID, x, z); ++y)
+                air += chunk.getBlockUnchecked(x, y, z).type == BlockType::AIR ? 1 : 0;
+    return air;
+}
+} // namespace
+
+/**
+ * Generates density terrain on lattices of increasing spacing and reports 3D noise
+ * evaluations and time per chunk, against heightmap terrain, along with how many blocks
+ * differ from the full-resolution (1x1x1) density field.
+ *
+ * Usage: density_bench [chunks] [seed]
+ */
+int main(int argc, char** argv)
+{
+    int const count = argc > 1 ? std::stoi(argv[1]) : 256;
+    int32_t const seed = argc > 2 ? std::stoi(argv[2]) : 1337;
+    constexpr int COMPARED_CHUNKS = 16;
+
+    ChunkGenerator const heightmap{seed};
+    double const heightmapUs = generation_us(heightmap, count);
+    std::println("{} chunks; heightmap terrain {:.2f} us per chunk", count, heightmapUs);
+
+    ChunkGenerator reference{seed};
+    reference.setTerrainShape(TerrainShape::DENSITY, {1, 1, 1});
+    std::vector<Chunk> referenceChunks;
+    for (int i = 0; i < COMPARED_CHUNKS; ++i)
+        referenceChunks.push_back(reference.generate(chunk_at(i)));
+
+    std::println("{:<10}{:>14}{:>14}{:>12}{:>10}{:>12}{:>14}", "lattice", "max samples", "samples", "us/chunk", "x hmap", "differing", "enclosed air");
+    for (DensityLattice const lattice : {DensityLattice{1, 1, 1}, DensityLattice{2, 4, 2}, DensityLattice{4, 8, 4}, DensityLattice{8, 16, 8}})
+    {
+        ChunkGenerator generator{seed};
+        generator.setTerrainShape(TerrainShape::DENSITY, lattice);
+        double const us = generation_us(generator, count);
+        double const samples = static_cast<double>(generator.getDensitySampleCount()) / count;
+
+        std::size_t differing = 0;
+        std::size_t air = 0;
+        for (int i = 0; i < COMPARED_CHUNKS; ++i)
+        {
+            auto const chunk = generator.generate(chunk_at(i));
+            differing += differing_blocks(chunk, referenceChunks[i]);
+            air += enclosed_air(chunk);
+        }
+
+        std::println("{:<10}{:>14}{:>14.0f}{:>12.2f}{:>9.2f}x{:>11.3f}%{:>14}",
+            std::format("{}x{}x{}", lattice.x, lattice.y, lattice.z),
+            generator.getDensitySamplesPerChunk(),
+            samples,
+            us,
+            us / heightmapUs,
+            100.0 * static_cast<double>(differing) / (static_cast<double>(COMPARED_CHUNKS) * CHUNK_VOLUME),
+            air / COMPARED_CHUNKS);
+    }
+    return 0;
+}
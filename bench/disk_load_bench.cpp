@@ -0,0 +1,209 @@
+#include "BenchCommon.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <filesystem>
+#include <optional>
+#include <print>
+#include <ranges>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <concurrencpp/concurrencpp.h>
+#include <ecs/events/EventBus.hpp>
+#include <world/Chunk.hpp>
+#include <world/ChunkGenerator.hpp>
+#include <world/World.hpp>
+
+namespace
+{
+using namespace mc;
+
+constexpr world::Block MARK{world::BlockType::LOG};
+
+double to_ms(std::chrono::nanoseconds duration)
+{
+    return std::chrono::duration<double, std::milli>(duration).count();
+}
+
+void print_latency(std::string_view name, utils::LatencyHistogram const& latency, uint64_t count)
+{
+    if (count == 0) return;
+    std::println("{:<14}{:>8}{:>12.2f}{:>12.2f}{:>12.2f}", name, count,
+        to_ms(latency.percentile(0.5)), to_ms(latency.percentile(0.99)), to_ms(latency.max()));
+}
+
+bool same_blocks(world::Chunk const& chunk, world::Chunk const& expected)
+{
+    for (int y = 0; y < world::CHUNK_SIZE_Y; ++y)
+    {
+        for (int z = 0; z < world::CHUNK_SIZE_Z; ++z)
+        {
+            for (int x = 0; x < world::CHUNK_SIZE_X; ++x)
+            {
+                if (chunk.getBlock(x, y, z).type != expected.getBlock(x, y, z).type) return false;
+            }
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief Leaves a chunk outside @p saved grew into a saved one and that are still there.
+ */
+std::optional<world::ChunkGenerator::Decoration> find_overflow_leaves(world::World const& world, std::vector<Magnum::Vector3i> const& saved)
+{
+    std::vector<world::ChunkGenerator::Decoration> overflow;
+    for (auto const& target : saved)
+    {
+        for (int dz = -1; dz <= 1; ++dz)
+        {
+            for (int dx = -1; dx <= 1; ++dx)
+            {
+                Magnum::Vector3i const source = target + Magnum::Vector3i{dx, 0, dz};
+                if (std::ranges::find(saved, source) != saved.end()) continue;
+
+                world::Chunk chunk{source};
+                world.getGenerator().generate(chunk);
+                overflow.clear();
+                world.getGenerator().generateFeatures(chunk, overflow);
+                for (auto const& decoration : overflow)
+                {
+                    if (decoration.chunkPos == target && decoration.block.type == world::BlockType::LEAVES
+                        && world.getChunk(target)->getBlock(decoration.x, decoration.y, decoration.z).type == world::BlockType::LEAVES)
+                        return decoration;
+                }
+            }
+        }
+    }
+    return std::nullopt;
+}
+} // namespace
+
+/**
+ * Loads a disc of chunks into a World saving into region files, marks every chunk of a
+ * smaller disc as a player's edit would, breaks leaves a tree outside it grew into it,
+ * and saves those. Then loads a wider disc into a new World on the same directory, as a
+ * restarted server would, and reports how many chunks came from disk and from the
+ * generator, with the load latency of each source.
+ *
+ * Checks that every saved chunk is read back with its edits, none is generated again,
+ * and every chunk holds the blocks a World generating all of them holds, so chunks
+ * generated next to saved ones still get the features those placed across the border,
+ * while saved chunks do not get those they already held back over the edits.
+ *
+ * Usage: disk_load_bench [saved radius] [ring width] [seed]
+ */
+int main(int argc, char** argv)
+{
+    int const radius = argc > 1 ? std::stoi(argv[1]) : 10;
+    int const ring = argc > 2 ? std::stoi(argv[2]) : 4;
+    int32_t const seed = argc > 3 ? std::stoi(argv[3]) : 1337;
+    auto const directory = std::filesystem::temp_directory_path() / "mc_disk_load_bench";
+    std::filesystem::remove_all(directory);
+
+    bench::init_logging();
+    concurrencpp::runtime runtime;
+    auto readExecutor = runtime.make_executor<concurrencpp::thread_pool_executor>("bench reads", 2, std::chrono::seconds{10});
+    auto writeExecutor = runtime.make_executor<concurrencpp::thread_pool_executor>("bench writes", 1, std::chrono::seconds{10});
+    auto const gridRadius = static_cast<uint8_t>(radius + ring + 2);
+
+    std::vector<Magnum::Vector3i> saved;
+    std::optional<world::ChunkGenerator::Decoration> brokenLeaves;
+    {
+        ecs::EventBus eventBus;
+        world::World world{runtime.thread_pool_executor(), eventBus, seed};
+        world.enablePersistence(directory, readExecutor, writeExecutor);
+        world.recenterChunkGrid({0, 0, 0}, gridRadius);
+        // One ring wider, so that chunks outside the saved disc grow trees into it
+        bench::load_world(world, {0, 0, 0}, radius + 1);
+        float const r = static_cast<float>(radius) + 0.5f;
+        for (auto const& chunkPos : world.getChunks() | std::views::keys)
+        {
+            if (static_cast<float>(chunkPos.x() * chunkPos.x() + chunkPos.z() * chunkPos.z()) <= r * r)
+                saved.push_back(chunkPos);
+        }
+        std::ranges::sort(saved, {}, [](Magnum::Vector3i const& pos) { return std::pair{pos.z(), pos.x()}; });
+        for (auto const& chunkPos : saved)
+        {
+            world.getChunks().at(chunkPos)->setBlock(7, 250, 7, MARK);
+            world.markChunkDirty(chunkPos);
+        }
+
+        // The chunk they grew from is generated again after the restart
+        brokenLeaves = find_overflow_leaves(world, saved);
+        if (brokenLeaves)
+            world.getChunks().at(brokenLeaves->chunkPos)->setBlock(brokenLeaves->x, brokenLeaves->y, brokenLeaves->z, world::Block{world::BlockType::AIR});
+        world.saveAll();
+    }
+
+    // Restarted on the same directory
+    ecs::EventBus eventBus;
+    world::World world{runtime.thread_pool_executor(), eventBus, seed};
+    world.enablePersistence(directory, readExecutor, writeExecutor);
+    world.recenterChunkGrid({0, 0, 0}, gridRadius);
+    bench::Stopwatch stopwatch;
+    std::size_t const requested = bench::load_world(world, {0, 0, 0}, radius + ring);
+    double const loadMs = stopwatch.elapsedSeconds() * 1e3;
+
+    using world::World;
+    auto const& stats = world.getLoadStats();
+    std::println("{} chunks loaded in {:.1f} ms: {} hits, {} misses ({:.0f}% hit rate), {} unreadable",
+        requested, loadMs, stats.hits, stats.misses, stats.hitRate() * 100.0, stats.failures);
+    std::println("{:<14}{:>8}{:>12}{:>12}{:>12}", "source", "chunks", "p50 ms", "p99 ms", "max ms");
+    print_latency("disk", world.getLoadLatency(World::LoadSource::DISK), stats.committed[static_cast<std::size_t>(World::LoadSource::DISK)]);
+    print_latency("pending save", world.getLoadLatency(World::LoadSource::PENDING_SAVE), stats.committed[static_cast<std::size_t>(World::LoadSource::PENDING_SAVE)]);
+    print_latency("generator", world.getLoadLatency(World::LoadSource::GENERATOR), stats.committed[static_cast<std::size_t>(World::LoadSource::GENERATOR)]);
+
+    int failures = 0;
+    if (!brokenLeaves)
+    {
+        std::println(stderr, "FAILED: no tree outside the saved disc grows into it");
+        ++failures;
+    }
+    if (stats.hits != saved.size() || stats.hits + stats.misses != requested || stats.failures > 0
+        || stats.committed[static_cast<std::size_t>(World::LoadSource::DISK)] != saved.size())
+    {
+        std::println(stderr, "FAILED: expected {} chunks from disk and {} generated", saved.size(), requested - saved.size());
+        ++failures;
+    }
+
+    // The same area generated from scratch
+    ecs::EventBus referenceBus;
+    world::World reference{runtime.thread_pool_executor(), referenceBus, seed};
+    reference.recenterChunkGrid({0, 0, 0}, gridRadius);
+    bench::load_world(reference, {0, 0, 0}, radius + ring);
+
+    std::vector<Magnum::Vector3i> mismatches;
+    for (auto const& [chunkPos, chunk] : world.getChunks())
+    {
+        auto const* generated = reference.getChunk(chunkPos);
+        if (generated == nullptr)
+        {
+            mismatches.push_back(chunkPos);
+            continue;
+        }
+
+        world::Chunk expected{*generated};
+        if (std::ranges::find(saved, chunkPos) != saved.end())
+            expected.setBlock(7, 250, 7, MARK);
+        if (brokenLeaves && brokenLeaves->chunkPos == chunkPos)
+            expected.setBlock(brokenLeaves->x, brokenLeaves->y, brokenLeaves->z, world::Block{world::BlockType::AIR});
+        if (!same_blocks(*chunk, expected))
+            mismatches.push_back(chunkPos);
+    }
+    if (!mismatches.empty() || world.getLoadedChunkCount() != requested)
+    {
+        std::println(stderr, "FAILED: {} of {} chunks differ from a World generating them, first [{}, {}]",
+            mismatches.size(), world.getLoadedChunkCount(),
+            mismatches.empty() ? 0 : mismatches.front().x(), mismatches.empty() ? 0 : mismatches.front().z());
+        ++failures;
+    }
+
+    std::filesystem::remove_all(directory);
+    if (failures > 0) return 1;
+    std::println("every saved chunk loads from disk and every other one generates as without saves");
+    return 0;
+}
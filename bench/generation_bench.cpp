@@ -0,0 +1,238 @@
+#include "BenchCommon.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstdlib>
+#include <memory>
+#include <new>
+#include <optional>
+#include <print>
+#include <span>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <utils/IVec3Hasher.hpp>
+#include <world/Chunk.hpp>
+#include <world/ChunkGenerator.hpp>
+
+namespace
+{
+std::atomic<uint64_t> g_allocations{0};
+std::atomic<uint64_t> g_allocatedBytes{0};
+
+void* counted_alloc(std::size_t size, std::size_t alignment)
+{
+    g_allocations.fetch_add(1, std::memory_order_relaxed);
+    g_allocatedBytes.fetch_add(size, std::memory_order_relaxed);
+    size = std::max<std::size_t>(size, 1);
+    void* memory = alignment <= alignof(std::max_align_t)
+        ? std::malloc(size)
+        : std::aligned_alloc(alignment, (size + alignment - 1) / alignment * alignment);
+    if (memory == nullptr)
+        throw std::bad_alloc{};
+    return memory;
+}
+} // namespace
+
+// Every allocation of the process is counted; the nothrow forms call these
+void* operator new(std::size_t size) { return counted_alloc(size, alignof(std::max_align_t)); }
+void* operator new[](std::size_t size) { return counted_alloc(size, alignof(std::max_align_t)); }
+void* operator new(std::size_t size, std::align_val_t alignment) { return counted_alloc(size, static_cast<std::size_t>(alignment)); }
+void* operator new[](std::size_t size, std::align_val_t alignment) { return counted_alloc(size, static_cast<std::size_t>(alignment)); }
+void operator delete(void* memory) noexcept { std::free(memory); }
+void operator delete[](void* memory) noexcept { std::free(memory); }
+void operator delete(void* memory, std::size_t) noexcept { std::free(memory); }
+void operator delete[](void* memory, std::size_t) noexcept { std::free(memory); }
+void operator delete(void* memory, std::align_val_t) noexcept { std::free(memory); }
+void operator delete[](void* memory, std::align_val_t) noexcept { std::free(memory); }
+void operator delete(void* memory, std::size_t, std::align_val_t) noexcept { std::free(memory); }
+void operator delete[](void* memory, std::size_t, std::align_val_t) noexcept { std::free(memory); }
+
+namespace
+{
+using namespace mc;
+using world::ChunkGenerator;
+
+/**
+ * @brief Fixed chunk set: a block around spawn and two far away, negative coordinates included.
+ */
+std::vector<Magnum::Vector3i> benchmark_chunks()
+{
+    constexpr int SIDE = 12;
+    std::vector<Magnum::Vector3i> chunks;
+    for (Magnum::Vector3i const corner : {Magnum::Vector3i{-SIDE / 2, 0, -SIDE / 2}, Magnum::Vector3i{4096, 0, 4096}, Magnum::Vector3i{-30000, 0, 20000}})
+    {
+        for (int z = 0; z < SIDE; ++z)
+            for (int x = 0; x < SIDE; ++x)
+                chunks.push_back(corner + Magnum::Vector3i{x, 0, z});
+    }
+    return chunks;
+}
+
+/**
+ * @brief Hash of a chunk's blocks and of the decorations its features hand to neighbours.
+ *
+ * Hashes block by block rather than the sections' encodings, so it only changes when
+ * the generated world does.
+ */
+uint64_t chunk_hash(world::Chunk const& chunk, std::span<ChunkGenerator::Decoration const> overflow)
+{
+    uint64_t hash = utils::IVec3Hasher{}(chunk.getPosition());
+    for (int y = 0; y < world::CHUNK_SIZE_Y; ++y)
+        for (int z = 0; z < world::CHUNK_SIZE_Z; ++z)
+            for (int x = 0; x < world::CHUNK_SIZE_X; ++x)
+                hash = utils::mix64(hash ^ static_cast<uint64_t>(chunk.getBlockUnchecked(x, y, z).type));
+
+    for (auto const& decoration : overflow)
+    {
+        hash = utils::mix64(hash ^ utils::IVec3Hasher{}(decoration.chunkPos));
+        hash = utils::mix64(hash ^ (uint64_t{decoration.x} | uint64_t{decoration.y} << 8 | uint64_t{decoration.z} << 16 |
+                                       static_cast<uint64_t>(decoration.block.type) << 24));
+    }
+    return hash;
+}
+
+/**
+ * @brief Runs TERRAIN, SURFACE and FEATURES on every chunk with @p threads workers.
+ *
+ * @param hashes If not empty, receives each chunk's hash; hashing is left out of timed runs
+ */
+void generate_all(ChunkGenerator const& generator, std::span<Magnum::Vector3i const> chunks, std::size_t threads, std::span<uint64_t> hashes)
+{
+    std::atomic<std::size_t> next{0};
+    auto const work = [&]() {
+        world::Chunk chunk{{0, 0, 0}};
+        std::vector<ChunkGenerator::Decoration> overflow;
+        for (std::size_t i = next.fetch_add(1); i < chunks.size(); i = next.fetch_add(1))
+        {
+            chunk.reset(chunks[i]);
+            overflow.clear();
+            generator.generate(chunk);
+            generator.generateFeatures(chunk, overflow);
+            if (!hashes.empty())
+                hashes[i] = chunk_hash(chunk, overflow);
+        }
+    };
+
+    std::vector<std::jthread> workers;
+    for (std::size_t i = 1; i < threads; ++i)
+        workers.emplace_back(work);
+    work();
+}
+
+/**
+ * @brief Generator configured like World's.
+ */
+std::unique_ptr<ChunkGenerator> make_generator(int32_t seed)
+{
+    auto generator = std::make_unique<ChunkGenerator>(seed);
+    generator->setBiomesEnabled(true);
+    return generator;
+}
+
+struct Run
+{
+    std::size_t threads;
+    double seconds;
+    uint64_t allocations;
+    uint64_t allocatedBytes;
+    std::size_t mismatches;
+};
+} // namespace
+
+/**
+ * Generates a fixed set of chunks from a fixed seed with 1, 2, 4, ... up to every hardware
+ * thread, and checks every chunk's content hash against the single-threaded run (and the
+ * whole set's digest against an expected one, when given). Prints chunks/s, ns per
+ * column and allocations per chunk for each thread count as JSON, and exits with 1 if
+ * any chunk differs.
+ *
+ * Usage: generation_bench [repetitions] [seed] [expected digest, hex]
+ */
+int main(int argc, char** argv)
+{
+    int const repetitions = argc > 1 ? std::max(1, std::stoi(argv[1])) : 4;
+    int32_t const seed = argc > 2 ? std::stoi(argv[2]) : 1337;
+    std::optional<uint64_t> const expectedDigest = argc > 3 ? std::optional{std::stoull(argv[3], nullptr, 16)} : std::nullopt;
+
+    bench::init_logging();
+    auto const chunks = benchmark_chunks();
+
+    std::vector<uint64_t> reference(chunks.size());
+    generate_all(*make_generator(seed), chunks, 1, reference);
+    uint64_t digest = 0;
+    for (uint64_t const hash : reference)
+        digest = utils::mix64(digest ^ hash);
+
+    std::size_t const hardware = std::max(1u, std::thread::hardware_concurrency());
+    std::vector<std::size_t> threadCounts;
+    for (std::size_t threads = 1; threads < hardware; threads *= 2)
+        threadCounts.push_back(threads);
+    threadCounts.push_back(hardware);
+
+    std::vector<Run> runs;
+    std::vector<uint64_t> hashes(chunks.size());
+    for (std::size_t const threads : threadCounts)
+    {
+        // A fresh generator per run, so none starts with the climate cache of another
+        Run run{threads, 0.0, 0, 0, 0};
+        {
+            auto const generator = make_generator(seed);
+            uint64_t const allocations = g_allocations.load();
+            uint64_t const allocatedBytes = g_allocatedBytes.load();
+            bench::Stopwatch stopwatch;
+            for (int i = 0; i < repetitions; ++i)
+                generate_all(*generator, chunks, threads, {});
+            run.seconds = stopwatch.elapsedSeconds();
+            run.allocations = g_allocations.load() - allocations;
+            run.allocatedBytes = g_allocatedBytes.load() - allocatedBytes;
+        }
+
+        generate_all(*make_generator(seed), chunks, threads, hashes);
+        for (std::size_t i = 0; i < chunks.size(); ++i)
+        {
+            if (hashes[i] != reference[i])
+            {
+                std::println(stderr, "chunk [{}, {}] differs with {} threads", chunks[i].x(), chunks[i].z(), threads);
+                ++run.mismatches;
+            }
+        }
+        runs.push_back(run);
+    }
+
+    bool const digestMatches = !expectedDigest || *expectedDigest == digest;
+    bool const deterministic = std::ranges::all_of(runs, [](Run const& run) { return run.mismatches == 0; });
+
+    double const generated = static_cast<double>(chunks.size()) * repetitions;
+    std::println("{{");
+    std::println("  \"benchmark\": \"generation\",");
+    std::println("  \"seed\": {},", seed);
+    std::println("  \"chunks\": {},", chunks.size());
+    std::println("  \"repetitions\": {},", repetitions);
+    std::println("  \"digest\": \"{:016x}\",", digest);
+    std::println("  \"digest_matches\": {},", digestMatches);
+    std::println("  \"deterministic\": {},", deterministic);
+    std::println("  \"runs\": [");
+    for (std::size_t i = 0; i < runs.size(); ++i)
+    {
+        auto const& run = runs[i];
+        std::println("    {{\"threads\": {}, \"seconds\": {:.6f}, \"chunks_per_second\": {:.1f}, \"ns_per_column\": {:.2f}, "
+                     "\"allocations_per_chunk\": {:.2f}, \"allocated_bytes_per_chunk\": {:.0f}, \"mismatched_chunks\": {}}}{}",
+            run.threads,
+            run.seconds,
+            generated / run.seconds,
+            run.seconds * 1e9 / (generated * world::CHUNK_SLICE_AREA),
+            static_cast<double>(run.allocations) / generated,
+            static_cast<double>(run.allocatedBytes) / generated,
+            run.mismatches,
+            i + 1 < runs.size() ? "," : "");
+    }
+    std::println("  ]");
+    std::println("}}");
+
+    if (!digestMatches)
+        std::println(stderr, "digest {:016x} differs from the expected {:016x}", digest, *expectedDigest);
+    return deterministic && digestMatches ? 0 : 1;
+}
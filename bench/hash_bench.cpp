@@ -0,0 +1,225 @@
+#include "BenchCommon.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <functional>
+#include <print>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include <Magnum/Math/Vector3.h>
+#include <tsl/hopscotch_set.h>
+#include <utils/IVec3Hasher.hpp>
+
+namespace
+{
+using Magnum::Vector3i;
+
+// The previous IVec3Hasher, kept here as the baseline
+struct XorShiftHasher
+{
+    std::size_t operator()(Vector3i const& v) const
+    {
+        std::size_t h1 = std::hash<int>()(v.x());
+        std::size_t h2 = std::hash<int>()(v.y());
+        std::size_t h3 = std::hash<int>()(v.z());
+        return h1 ^ (h2 << 1) ^ (h3 << 2);
+    }
+};
+
+std::vector<Vector3i> disc(Vector3i const& center, int radius)
+{
+    std::vector<Vector3i> positions;
+    float const r = static_cast<float>(radius) + 0.5f;
+    for (int x = -radius; x <= radius; ++x)
+        for (int z = -radius; z <= radius; ++z)
+            if (static_cast<float>(x * x + z * z) <= r * r)
+                positions.push_back(center + Vector3i{x, 0, z});
+    return positions;
+}
+
+struct Distribution
+{
+    std::size_t distinctHashes = 0;
+    std::size_t buckets = 0;
+    std::size_t maxBucket = 0;
+    double meanChain = 0.0; ///< Average keys compared by a successful unordered_map lookup.
+    double meanProbe = 0.0; ///< Average slots probed by a linear-probing table masked to a power of two.
+};
+
+template <typename HASHER>
+Distribution measure_distribution(std::vector<Vector3i> const& keys)
+{
+    HASHER const hasher;
+    Distribution result;
+
+    std::unordered_set<std::size_t> hashes;
+    for (auto const& key : keys)
+        hashes.insert(hasher(key));
+    result.distinctHashes = hashes.size();
+
+    std::unordered_map<Vector3i, int, HASHER> map;
+    for (auto const& key : keys)
+        map.emplace(key, 0);
+    result.buckets = map.bucket_count();
+    double comparisons = 0.0;
+    for (std::size_t b = 0; b < map.bucket_count(); ++b)
+    {
+        std::size_t const size = map.bucket_size(b);
+        result.maxBucket = std::max(result.maxBucket, size);
+        comparisons += static_cast<double>(size * (size + 1)) / 2.0;
+    }
+    result.meanChain = comparisons / static_cast<double>(keys.size());
+
+    // Power-of-two table at <= 50% load, indexed by the low hash bits like tsl::hopscotch_set
+    std::size_t const capacity = std::bit_ceil(keys.size() * 2);
+    std::vector<bool> used(capacity, false);
+    std::size_t probes = 0;
+    for (auto const& key : keys)
+    {
+        std::size_t slot = hasher(key) & (capacity - 1);
+        for (++probes; used[slot]; ++probes)
+            slot = (slot + 1) & (capacity - 1);
+        used[slot] = true;
+    }
+    result.meanProbe = static_cast<double>(probes) / static_cast<double>(keys.size());
+    return result;
+}
+
+struct Latency
+{
+    double world = 0.0; ///< ns per op: chunk map churn while walking + 3x3 neighbour lookups.
+    double render = 0.0; ///< ns per op: visible set rebuild + mesh map lookups.
+    double loading = 0.0; ///< ns per op: candidate set of unloaded chunks around the player.
+    std::size_t checksum = 0;
+};
+
+template <typename HASHER>
+Latency measure_latency(int radius, int steps)
+{
+    Latency result;
+
+    // World::m_chunks while the player walks: load the disc ahead, unload behind, and
+    // look up every loaded chunk's neighbours the way meshing and collision do
+    {
+        std::unordered_map<Vector3i, int, HASHER> chunks;
+        std::size_t ops = 0;
+        mc::bench::Stopwatch stopwatch;
+        for (int step = 0; step < steps; ++step)
+        {
+            Vector3i const center{step, 0, step / 2};
+            for (auto const& pos : disc(center, radius))
+            {
+                chunks.try_emplace(pos, step);
+                ++ops;
+            }
+            std::erase_if(chunks, [&](auto const& entry) {
+                Vector3i const d = entry.first - center;
+                return d.x() * d.x() + d.z() * d.z() > (radius + 2) * (radius + 2);
+            });
+            for (auto const& pos : disc(center, radius))
+            {
+                for (int dz = -1; dz <= 1; ++dz)
+                    for (int dx = -1; dx <= 1; ++dx)
+                        result.checksum += chunks.contains(pos + Vector3i{dx, 0, dz});
+                ops += 9;
+            }
+        }
+        result.world = stopwatch.elapsedSeconds() * 1e9 / static_cast<double>(ops);
+    }
+
+    // RenderSystem: rebuild m_visibleChunks every frame and find each in m_chunkToMesh
+    {
+        std::unordered_map<Vector3i, std::vector<int>, HASHER> chunkToMesh;
+        for (auto const& pos : disc({0, 0, 0}, radius + steps))
+            chunkToMesh[pos].push_back(1);
+
+        tsl::hopscotch_set<Vector3i, HASHER> visible;
+        visible.reserve((2 * radius + 1) * (2 * radius + 1));
+        std::size_t ops = 0;
+        mc::bench::Stopwatch stopwatch;
+        for (int frame = 0; frame < steps * 4; ++frame)
+        {
+            Vector3i const center{frame / 4, 0, frame / 8};
+            visible.clear();
+            for (int dx = -radius; dx <= radius; ++dx)
+                for (int dz = -radius; dz <= radius; ++dz)
+                    visible.emplace(center.x() + dx, 0, center.z() + dz);
+            for (auto const& pos : visible)
+            {
+                auto it = chunkToMesh.find(pos);
+                result.checksum += it != chunkToMesh.end() ? it->second.size() : 0;
+            }
+            ops += 2 * visible.size();
+        }
+        result.render = stopwatch.elapsedSeconds() * 1e9 / static_cast<double>(ops);
+    }
+
+    // ChunkLoadingSystem::loadChunksInRadius: collect not-yet-loaded chunks of the new disc
+    {
+        std::unordered_set<Vector3i, HASHER> loaded;
+        for (auto const& pos : disc({0, 0, 0}, radius))
+            loaded.insert(pos);
+
+        std::size_t ops = 0;
+        mc::bench::Stopwatch stopwatch;
+        for (int step = 1; step <= steps; ++step)
+        {
+            tsl::hopscotch_set<Vector3i, HASHER> candidates;
+            candidates.reserve((2 * radius + 1) * (2 * radius + 1));
+            for (auto const& pos : disc({step, 0, 0}, radius))
+            {
+                ops += 1;
+                if (!loaded.contains(pos))
+                    candidates.insert(pos);
+            }
+            for (auto const& pos : candidates)
+                loaded.insert(pos);
+            result.checksum += candidates.size();
+        }
+        result.loading = stopwatch.elapsedSeconds() * 1e9 / static_cast<double>(ops);
+    }
+
+    return result;
+}
+
+template <typename HASHER>
+Latency report(char const* name, std::vector<Vector3i> const& keys, int radius, int steps)
+{
+    Distribution const d = measure_distribution<HASHER>(keys);
+    Latency const l = measure_latency<HASHER>(radius, steps);
+    std::println("{:<10}{:>10}{:>10}{:>8}{:>10.2f}{:>10.2f}{:>10.1f}{:>10.1f}{:>10.1f}",
+        name, d.distinctHashes, d.buckets, d.maxBucket, d.meanChain, d.meanProbe, l.world, l.render, l.loading);
+    return l;
+}
+} // namespace
+
+/**
+ * Compares the Morton + finalizer IVec3Hasher with the previous xor/shift hash on the
+ * chunk coordinates the game actually uses: bucket distribution and probe lengths for a
+ * loaded disc of chunks, and lookup latency for the World, RenderSystem and
+ * ChunkLoadingSystem access patterns.
+ *
+ * Usage: hash_bench [radius] [steps]
+ */
+int main(int argc, char** argv)
+{
+    int const radius = argc > 1 ? std::stoi(argv[1]) : 24;
+    int const steps = argc > 2 ? std::stoi(argv[2]) : 64;
+
+    auto const keys = disc({0, 0, 0}, radius);
+    std::println("{} chunk positions (disc of radius {}), {} walk steps; latencies in ns/op", keys.size(), radius, steps);
+    std::println("{:<10}{:>10}{:>10}{:>8}{:>10}{:>10}{:>10}{:>10}{:>10}",
+        "hasher", "distinct", "buckets", "max", "chain", "probe", "world", "render", "loading");
+
+    Latency const legacy = report<XorShiftHasher>("xor-shift", keys, radius, steps);
+    Latency const morton = report<mc::utils::IVec3Hasher>("morton", keys, radius, steps);
+    if (legacy.checksum != morton.checksum)
+    {
+        std::println(stderr, "hashers disagree on container contents: {} / {}", legacy.checksum, morton.checksum);
+        return 1;
+    }
+    return 0;
+}
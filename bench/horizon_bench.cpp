@@ -0,0 +1,142 @@
+#include "BenchCommon.hpp"
+
+#include <algorithm>
+#include <print>
+#include <ranges>
+#include <string>
+#include <vector>
+
+#include <world/Chunk.hpp>
+#include <world/ChunkGenerator.hpp>
+#include <world/HorizonMap.hpp>
+
+namespace
+{
+using namespace mc::world;
+
+/**
+ * @brief Microseconds per chunk to generate real chunks up to their features.
+ */
+double chunk_us(ChunkGenerator const& generator, int count)
+{
+    Chunk chunk{{0, 0, 0}};
+    std::vector<ChunkGenerator::Decoration> overflow;
+    mc::bench::Stopwatch stopwatch;
+    for (int i = 0; i < count; ++i)
+    {
+        chunk.reset({i % 16, 0, i / 16});
+        overflow.clear();
+        generator.generate(chunk);
+        generator.generateFeatures(chunk, overflow);
+    }
+    return stopwatch.elapsedSeconds() * 1e6 / count;
+}
+
+/**
+ * @brief Tile samples whose height differs from the generator's own height at that column.
+ */
+std::size_t mismatched_samples(ChunkGenerator const& generator, HorizonMap const& horizon)
+{
+    std::size_t mismatches = 0;
+    for (auto const& tile : horizon.getTiles() | std::views::values)
+    {
+        int const step = horizon_step(tile.level());
+        for (int sz = 0; sz < HORIZON_TILE_SAMPLES; sz += 4)
+        {
+            for (int sx = 0; sx < HORIZON_TILE_SAMPLES; sx += 4)
+            {
+                int height = 0;
+                generator.sampleHeights(tile.origin().x() + sx * step, tile.origin().z() + sz * step, 1, 1, {&height, 1});
+                mismatches += std::clamp(height, 0, CHUNK_SIZE_Y - 1) != tile.heightAt(sx, sz) ? 1 : 0;
+            }
+        }
+    }
+    return mismatches;
+}
+
+double covered_chunks(HorizonMap const& horizon)
+{
+    double chunks = 0.0;
+    for (auto const& tile : horizon.getTiles() | std::views::values)
+    {
+        double const side = static_cast<double>(horizon_tile_side(tile.level())) / CHUNK_SIZE_X;
+        chunks += side * side;
+    }
+    return chunks;
+}
+} // namespace
+
+/**
+ * Builds the horizon rings around a player with the given loaded radius, compares their
+ * cost with generating the same area as real chunks, then walks the player across the
+ * world and reports how many tiles each step generates and how long it takes. Then
+ * teleports it with a small tile budget, checking that tiles out of range are dropped all
+ * the same, and that every sampled height equals the generator's height at that column.
+ *
+ * Usage: horizon_bench [loaded radius] [steps] [seed]
+ */
+int main(int argc, char** argv)
+{
+    int const radius = argc > 1 ? std::stoi(argv[1]) : 16;
+    int const steps = argc > 2 ? std::stoi(argv[2]) : 256;
+    int32_t const seed = argc > 3 ? std::stoi(argv[3]) : 1337;
+
+    ChunkGenerator generator{seed};
+    generator.setBiomesEnabled(true);
+    double const chunkUs = chunk_us(generator, 256);
+
+    HorizonMap horizon{generator, {.innerRadius = radius}};
+    mc::bench::Stopwatch stopwatch;
+    auto const initial = horizon.update({0, 0, 0});
+    double const buildMs = stopwatch.elapsedSeconds() * 1e3;
+    double const chunks = covered_chunks(horizon);
+
+    std::println("loaded radius {}, {} levels reaching {} chunks out", radius, HorizonOptions{}.levels,
+        horizon.ringRadius(HorizonOptions{}.levels - 1) * horizon_tile_side(HorizonOptions{}.levels - 1) / CHUNK_SIZE_X);
+    std::println("initial build: {} tiles, {:.0f} chunks of terrain, {:.2f} ms ({:.1f} KiB)",
+        initial.added.size(), chunks, buildMs, static_cast<double>(initial.added.size() * sizeof(HorizonTile)) / 1024.0);
+    std::println("as real chunks: {:.2f} us/chunk, {:.0f} ms; horizon is {:.0f}x cheaper",
+        chunkUs, chunks * chunkUs / 1e3, chunks * chunkUs / 1e3 / buildMs);
+
+    std::size_t maxAdded = 0;
+    double maxStepMs = 0.0;
+    std::size_t added = 0;
+    for (int step = 1; step <= steps; ++step)
+    {
+        stopwatch.restart();
+        auto const update = horizon.update({step, 0, step / 2});
+        maxStepMs = std::max(maxStepMs, stopwatch.elapsedSeconds() * 1e3);
+        maxAdded = std::max(maxAdded, update.added.size());
+        added += update.added.size();
+        if (!update.complete)
+        {
+            std::println(stderr, "unbudgeted update left tiles missing");
+            return 1;
+        }
+    }
+    std::println("walking {} chunks: {:.2f} tiles per step (max {}), max {:.3f} ms per step, {} tiles kept",
+        steps, static_cast<double>(added) / steps, maxAdded, maxStepMs, horizon.getTiles().size());
+
+    // Teleports far faster than a small budget generates tiles; only the current rings stay
+    std::size_t maxTiles = 0;
+    for (int jump = 1; jump <= 16; ++jump)
+    {
+        Magnum::Vector3i const playerChunk{jump * 512, 0, -jump * 256};
+        horizon.update(playerChunk, 8);
+        maxTiles = std::max(maxTiles, horizon.getTiles().size());
+        if (horizon.getTiles().size() > horizon.wantedTiles(playerChunk).size())
+        {
+            std::println(stderr, "a budgeted update kept {} tiles out of range", horizon.getTiles().size() - horizon.wantedTiles(playerChunk).size());
+            return 1;
+        }
+    }
+    std::println("16 teleports at 8 tiles per update: at most {} tiles kept", maxTiles);
+
+    if (std::size_t const mismatches = mismatched_samples(generator, horizon); mismatches > 0)
+    {
+        std::println(stderr, "{} horizon samples differ from the terrain height", mismatches);
+        return 1;
+    }
+    std::println("every checked sample matches the terrain height");
+    return 0;
+}
@@ -0,0 +1,95 @@
+#include "BenchCommon.hpp"
+
+#include <print>
+#include <string>
+#include <vector>
+
+#include <concurrencpp/concurrencpp.h>
+#include <ecs/events/EventBus.hpp>
+#include <render/ChunkMeshBuilder.hpp>
+#include <render/Vertex.hpp>
+#include <world/Chunk.hpp>
+#include <world/World.hpp>
+
+namespace
+{
+struct MeshRun
+{
+    double seconds = 0.0;
+    std::size_t vertices = 0;
+};
+
+MeshRun build_meshes(
+    std::vector<mc::world::Chunk const*> const& chunks,
+    mc::world::IChunkProvider const& provider,
+    bool skipHiddenSections)
+{
+    MeshRun run;
+    mc::bench::Stopwatch stopwatch;
+    for (auto const* chunk : chunks)
+    {
+        auto const vertsByTex = mc::render::ChunkMeshBuilder::buildVertexData(*chunk, provider, skipHiddenSections);
+        for (auto const& verts : vertsByTex)
+        {
+            run.vertices += verts.size();
+        }
+    }
+    run.seconds = stopwatch.elapsedSeconds();
+    return run;
+}
+} // namespace
+
+/**
+ * Builds vertex data for every chunk of a loaded world whose neighbours are loaded too,
+ * once scanning every section and once skipping sections that cannot produce faces.
+ *
+ * Usage: mesh_bench [radius] [seed]
+ */
+int main(int argc, char** argv)
+{
+    using namespace mc;
+
+    int const radius = argc > 1 ? std::stoi(argv[1]) : 8;
+    int32_t const seed = argc > 2 ? std::stoi(argv[2]) : 1337;
+
+    bench::init_logging();
+    concurrencpp::runtime runtime;
+    ecs::EventBus eventBus;
+    world::World world{runtime.thread_pool_executor(), eventBus, seed};
+    bench::load_world(world, {0, 0, 0}, radius);
+    bench::WorldChunkProvider const provider{world};
+
+    std::vector<world::Chunk const*> chunks;
+    std::size_t uniformSections = 0;
+    int const inner = radius - 1;
+    for (int x = -inner; x <= inner; ++x)
+    {
+        for (int z = -inner; z <= inner; ++z)
+        {
+            if (x * x + z * z > inner * inner) continue;
+            if (auto const* chunk = world.getChunk({x, 0, z}))
+            {
+                chunks.push_back(chunk);
+                for (int i = 0; i < world::CHUNK_SECTION_COUNT; ++i)
+                {
+                    uniformSections += chunk->getSection(i).isUniform() ? 1 : 0;
+                }
+            }
+        }
+    }
+
+    auto const full = build_meshes(chunks, provider, false);
+    auto const skipping = build_meshes(chunks, provider, true);
+    if (full.vertices != skipping.vertices)
+    {
+        std::println(stderr, "vertex count mismatch: {} (full) vs {} (skipping)", full.vertices, skipping.vertices);
+        return 1;
+    }
+
+    std::size_t const sections = chunks.size() * world::CHUNK_SECTION_COUNT;
+    std::println("{} chunks meshed, {} vertices, {}/{} uniform sections", chunks.size(), full.vertices, uniformSections, sections);
+    std::println("full scan        : {:8.3f} ms/chunk", full.seconds * 1000.0 / chunks.size());
+    std::println("section skipping : {:8.3f} ms/chunk", skipping.seconds * 1000.0 / chunks.size());
+    std::println("speedup          : {:8.2f}x", full.seconds / skipping.seconds);
+    return 0;
+}
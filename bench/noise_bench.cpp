@@ -0,0 +1,155 @@
+#include "BenchCommon.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstdlib>
+#include <print>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <world/Chunk.hpp>
+#include <world/ChunkGenerator.hpp>
+
+namespace
+{
+using namespace mc::world;
+
+constexpr int MIN_HEIGHT = 64 - 24; ///< Lowest surface the height shaping can produce.
+constexpr int MAX_HEIGHT = 64 + 24; ///< Highest surface the height shaping can produce.
+constexpr int REGION_CHUNKS = 4; ///< Region side, in chunks, for the region-wide grid.
+
+char const* backend_name(NoiseBackend backend)
+{
+    return backend == NoiseBackend::FAST_NOISE_2 ? "FastNoise2" : "FastNoiseLite";
+}
+
+Magnum::Vector3i chunk_at(int i)
+{
+    return {i % 16, 0, i / 16};
+}
+
+std::vector<int> chunk_heights(ChunkGenerator const& generator, int count)
+{
+    std::vector<int> heights(static_cast<std::size_t>(count) * CHUNK_SLICE_AREA);
+    for (int i = 0; i < count; ++i)
+    {
+        auto const pos = chunk_at(i);
+        generator.sampleHeights(pos.x() * CHUNK_SIZE_X, pos.z() * CHUNK_SIZE_Z, CHUNK_SIZE_X, CHUNK_SIZE_Z,
+            std::span{heights}.subspan(static_cast<std::size_t>(i) * CHUNK_SLICE_AREA, CHUNK_SLICE_AREA));
+    }
+    return heights;
+}
+
+struct HeightStats
+{
+    int min = CHUNK_SIZE_Y;
+    int max = -1;
+    double mean = 0.0;
+};
+
+HeightStats height_stats(std::vector<int> const& heights)
+{
+    HeightStats stats;
+    for (int const height : heights)
+    {
+        stats.min = std::min(stats.min, height);
+        stats.max = std::max(stats.max, height);
+        stats.mean += height;
+    }
+    stats.mean /= static_cast<double>(heights.size());
+    return stats;
+}
+
+struct Throughput
+{
+    double heightsPerChunkUs = 0.0;
+    double regionPerChunkUs = 0.0;
+    double chunksPerSecond = 0.0;
+};
+
+Throughput measure(ChunkGenerator const& generator, int count)
+{
+    Throughput result;
+
+    std::array<int, CHUNK_SLICE_AREA> heights;
+    mc::bench::Stopwatch stopwatch;
+    for (int i = 0; i < count; ++i)
+    {
+        auto const pos = chunk_at(i);
+        generator.sampleHeights(pos.x() * CHUNK_SIZE_X, pos.z() * CHUNK_SIZE_Z, CHUNK_SIZE_X, CHUNK_SIZE_Z, heights);
+    }
+    result.heightsPerChunkUs = stopwatch.elapsedSeconds() * 1e6 / count;
+
+    // The same columns, sampled one region grid at a time
+    constexpr int REGION_SIZE = REGION_CHUNKS * CHUNK_SIZE_X;
+    std::vector<int> regionHeights(REGION_SIZE * REGION_SIZE);
+    int const regions = std::max(1, count / (REGION_CHUNKS * REGION_CHUNKS));
+    stopwatch.restart();
+    for (int i = 0; i < regions; ++i)
+    {
+        generator.sampleHeights(i % 4 * REGION_SIZE, i / 4 * REGION_SIZE, REGION_SIZE, REGION_SIZE, regionHeights);
+    }
+    result.regionPerChunkUs = stopwatch.elapsedSeconds() * 1e6 / (regions * REGION_CHUNKS * REGION_CHUNKS);
+
+    Chunk chunk{{0, 0, 0}};
+    stopwatch.restart();
+    for (int i = 0; i < count; ++i)
+    {
+        chunk.reset(chunk_at(i));
+        generator.generate(chunk);
+    }
+    result.chunksPerSecond = count / stopwatch.elapsedSeconds();
+    return result;
+}
+} // namespace
+
+/**
+ * Compares the FastNoiseLite and FastNoise2 terrain backends of ChunkGenerator.
+ * FastNoise2 uses different gradients, so heights are checked against the range the
+ * shaping allows and reported as a deviation, not compared column by column. Then both
+ * are timed sampling chunk heights, sampling 4x4-chunk region grids and generating chunks.
+ *
+ * Usage: noise_bench [chunks] [seed]
+ */
+int main(int argc, char** argv)
+{
+    int const count = argc > 1 ? std::stoi(argv[1]) : 1024;
+    int32_t const seed = argc > 2 ? std::stoi(argv[2]) : 1337;
+
+    ChunkGenerator const lite{seed, NoiseBackend::FAST_NOISE_LITE};
+    ChunkGenerator const grid{seed, NoiseBackend::FAST_NOISE_2};
+
+    auto const liteHeights = chunk_heights(lite, count);
+    auto const gridHeights = chunk_heights(grid, count);
+    for (auto [generator, heights] : {std::pair{&lite, &liteHeights}, std::pair{&grid, &gridHeights}})
+    {
+        auto const stats = height_stats(*heights);
+        std::println("{:<14} heights {:3}..{:3}, mean {:6.2f}", backend_name(generator->getBackend()), stats.min, stats.max, stats.mean);
+        if (stats.min < MIN_HEIGHT || stats.max > MAX_HEIGHT)
+        {
+            std::println(stderr, "heights outside of [{}, {}]", MIN_HEIGHT, MAX_HEIGHT);
+            return 1;
+        }
+    }
+
+    double meanDeviation = 0.0;
+    int maxDeviation = 0;
+    for (std::size_t i = 0; i < liteHeights.size(); ++i)
+    {
+        int const deviation = std::abs(liteHeights[i] - gridHeights[i]);
+        meanDeviation += deviation;
+        maxDeviation = std::max(maxDeviation, deviation);
+    }
+    meanDeviation /= static_cast<double>(liteHeights.size());
+    std::println("deviation      mean {:.2f}, max {} blocks over {} columns", meanDeviation, maxDeviation, liteHeights.size());
+
+    std::println("{} chunks; us per chunk", count);
+    std::println("{:<14}{:>12}{:>12}{:>14}", "", "heights", "4x4 region", "chunks/s");
+    for (auto const* generator : {&lite, &grid})
+    {
+        auto const result = measure(*generator, count);
+        std::println("{:<14}{:>12.2f}{:>12.2f}{:>14.0f}", backend_name(generator->getBackend()), result.heightsPerChunkUs, result.regionPerChunkUs, result.chunksPerSecond);
+    }
+    return 0;
+}
@@ -0,0 +1,190 @@
+#include "BenchCommon.hpp"
+
+#include <chrono>
+#include <cstddef>
+#include <filesystem>
+#include <future>
+#include <print>
+#include <ranges>
+#include <string>
+#include <vector>
+
+#include <concurrencpp/concurrencpp.h>
+#include <ecs/events/EventBus.hpp>
+#include <world/Chunk.hpp>
+#include <world/ChunkCompressor.hpp>
+#include <world/ChunkSerializer.hpp>
+#include <world/RegionStorage.hpp>
+#include <world/World.hpp>
+
+namespace
+{
+using namespace mc;
+
+constexpr world::Block FIRST_MARK{world::BlockType::LOG};
+constexpr world::Block SECOND_MARK{world::BlockType::LEAVES};
+
+double to_us(std::chrono::nanoseconds duration)
+{
+    return std::chrono::duration<double, std::micro>(duration).count();
+}
+
+/**
+ * @brief Marks a block high above the terrain of every loaded chunk, the way a player's
+ * edit would, and flags the chunks as modified.
+ */
+void modify_all(world::World& world, world::Block mark, int x)
+{
+    std::vector<Magnum::Vector3i> positions;
+    for (auto const& chunkPos : world.getChunks() | std::views::keys)
+        positions.push_back(chunkPos);
+    for (auto const& chunkPos : positions)
+    {
+        world.getChunks().at(chunkPos)->setBlock(x, 250, 7, mark);
+        world.markChunkDirty(chunkPos);
+    }
+}
+
+bool has_marks(world::Chunk const& chunk)
+{
+    return chunk.getBlock(7, 250, 7).type == FIRST_MARK.type && chunk.getBlock(8, 250, 7).type == SECOND_MARK.type;
+}
+} // namespace
+
+/**
+ * Loads a square of chunks into a World saving into region files, modifies every chunk
+ * and measures:
+ *  - the periodic autosave, as the time each tick spends handing chunks over;
+ *  - unloading every modified chunk, on the World thread, against encoding, compressing
+ *    and writing them right there as a synchronous save would;
+ *  - reloading them while their writes are held back, which must restore them all from
+ *    the in-flight buffer without generating or reading anything.
+ * Then lets the writes through and checks that every chunk reads back from disk with
+ * both modifications.
+ *
+ * Usage: persistence_bench [radius] [slice budget in us] [seed]
+ */
+int main(int argc, char** argv)
+{
+    int const radius = argc > 1 ? std::stoi(argv[1]) : 12;
+    int const sliceUs = argc > 2 ? std::stoi(argv[2]) : 500;
+    int32_t const seed = argc > 3 ? std::stoi(argv[3]) : 1337;
+    auto const directory = std::filesystem::temp_directory_path() / "mc_persistence_bench";
+    std::filesystem::remove_all(directory);
+
+    bench::init_logging();
+    concurrencpp::runtime runtime;
+    auto readExecutor = runtime.make_executor<concurrencpp::thread_pool_executor>("bench reads", 1, std::chrono::seconds{10});
+    auto writeExecutor = runtime.make_executor<concurrencpp::thread_pool_executor>("bench writes", 1, std::chrono::seconds{10});
+    ecs::EventBus eventBus;
+    world::World world{runtime.thread_pool_executor(), eventBus, seed};
+    world.enablePersistence(directory, readExecutor, writeExecutor);
+    world.setAutosave({std::chrono::milliseconds{0}, std::chrono::microseconds{sliceUs}});
+    world.recenterChunkGrid({0, 0, 0}, static_cast<uint8_t>(radius + 2));
+    bench::load_world(world, {0, 0, 0}, radius);
+    auto const& persistence = *world.getPersistence();
+
+    // Autosave of chunks that stay loaded
+    modify_all(world, FIRST_MARK, 7);
+    std::size_t const count = world.getLoadedChunkCount();
+    int ticks = 0;
+    while (persistence.getStats().saved < count)
+    {
+        world.tickAutosave();
+        ++ticks;
+    }
+    world.saveAll();
+    auto const& slices = world.getAutosaveSlices();
+    std::println("{} chunks autosaved over {} ticks of {} us budget: slice p50 {:.0f} us, p99 {:.0f} us, max {:.0f} us",
+        count, ticks, sliceUs, to_us(slices.percentile(0.5)), to_us(slices.percentile(0.99)), to_us(slices.max()));
+    std::println("write-behind latency: p50 {:.2f} ms, max {:.2f} ms, {:.0f} bytes/chunk written",
+        to_us(persistence.getWriteLatency().percentile(0.5)) / 1e3, to_us(persistence.getWriteLatency().max()) / 1e3,
+        static_cast<double>(persistence.getStats().bytesWritten) / static_cast<double>(persistence.getStats().written));
+
+    // What the World thread would spend saving them synchronously
+    modify_all(world, SECOND_MARK, 8);
+    std::vector<Magnum::Vector3i> positions;
+    double syncUs = 0.0;
+    {
+        world::RegionStorage storage{directory / "sync"};
+        world::ChunkCompressor const compressor;
+        std::vector<std::byte> encoded;
+        std::vector<std::byte> frame;
+        bench::Stopwatch stopwatch;
+        for (auto const& [chunkPos, chunk] : world.getChunks())
+        {
+            encoded.clear();
+            frame.clear();
+            world::ChunkSerializer::encode(*chunk, encoded);
+            compressor.compress(encoded, frame);
+            storage.write(chunkPos, frame);
+            positions.push_back(chunkPos);
+        }
+        syncUs = stopwatch.elapsedSeconds() * 1e6 / static_cast<double>(positions.size());
+    }
+
+    // Unload with the writes held back, so that every chunk stays in flight
+    std::promise<void> gate;
+    auto const opened = gate.get_future().share();
+    auto blocker = writeExecutor->submit([opened] { opened.wait(); });
+    uint64_t const writtenBefore = persistence.getStats().written;
+
+    bench::Stopwatch stopwatch;
+    world.unloadChunksOutsideRadius({100000, 0, 100000}, static_cast<uint8_t>(radius));
+    double const unloadUs = stopwatch.elapsedSeconds() * 1e6 / static_cast<double>(positions.size());
+
+    std::println("unload: {:.2f} us/chunk on the World thread, a synchronous save would take at least {:.2f} us/chunk", unloadUs, syncUs);
+
+    int failures = 0;
+    stopwatch.restart();
+    world.submitChunkLoads(positions);
+    double const reloadUs = stopwatch.elapsedSeconds() * 1e6 / static_cast<double>(positions.size());
+    std::size_t restored = 0;
+    for (auto const& chunkPos : positions)
+    {
+        auto const* chunk = world.getChunk(chunkPos);
+        restored += chunk != nullptr && has_marks(*chunk) ? 1 : 0;
+    }
+    std::println("reload from the in-flight buffer: {:.2f} us/chunk, {} of {} chunks restored", reloadUs, restored, positions.size());
+    if (restored != positions.size() || persistence.getStats().written != writtenBefore)
+    {
+        std::println(stderr, "FAILED: reloading did not restore every chunk from memory");
+        ++failures;
+    }
+
+    gate.set_value();
+    blocker.get();
+    world.saveAll();
+    auto const stats = persistence.getStats();
+    std::println("{} saves, {} written in {} batches, {} superseded, {} retried, {} failed, {} still pending",
+        stats.saved, stats.written, stats.batches, stats.superseded, stats.retried, stats.failed, stats.pending);
+
+    // Everything on disk has both modifications
+    world::RegionStorage storage{directory / "region"};
+    world::ChunkCompressor const compressor;
+    std::vector<std::byte> frame;
+    std::vector<std::byte> encoded;
+    world::Chunk chunk{{0, 0, 0}};
+    std::size_t mismatches = 0;
+    for (auto const& chunkPos : positions)
+    {
+        if (!storage.read(chunkPos, frame))
+        {
+            ++mismatches;
+            continue;
+        }
+        compressor.decompress(frame, encoded);
+        world::ChunkSerializer::decode(encoded, chunk);
+        mismatches += chunk.getPosition() != chunkPos || !has_marks(chunk) ? 1 : 0;
+    }
+    if (mismatches > 0 || stats.pending > 0 || stats.failed > 0)
+    {
+        std::println(stderr, "FAILED: {} chunks read back wrong from disk", mismatches);
+        ++failures;
+    }
+
+    std::filesystem::remove_all(directory);
+    if (failures > 0) return 1;
+    std::println("every chunk reads back with its modifications");
+    return 0;
+}
@@ -0,0 +1,91 @@
+#include "BenchCommon.hpp"
+
+#include <chrono>
+#include <print>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include <concurrencpp/concurrencpp.h>
+#include <ecs/events/EventBus.hpp>
+#include <world/World.hpp>
+
+namespace
+{
+using namespace mc;
+
+/**
+ * @brief Loads a world and returns the chunks generated per second.
+ *
+ * @param oneByOne Submits chunks one at a time in reverse order instead of all at once
+ */
+double load(concurrencpp::runtime& runtime, std::size_t threads, int regionChunks, bool oneByOne, int radius, int32_t seed)
+{
+    auto executor = runtime.make_executor<concurrencpp::thread_pool_executor>("bench chunks", threads, std::chrono::seconds{10});
+    ecs::EventBus eventBus;
+    world::World world{executor, eventBus, seed};
+    world.setRegionBatching(regionChunks);
+
+    bench::Stopwatch stopwatch;
+    std::size_t chunks = 0;
+    if (oneByOne)
+    {
+        for (int x = radius; x >= -radius; --x)
+        {
+            for (int z = radius; z >= -radius; --z)
+            {
+                if (static_cast<float>(x * x + z * z) > (radius + 0.5f) * (radius + 0.5f)) continue;
+                world.submitChunkLoad({x, 0, z});
+                world.integrateFinishedChunks();
+                ++chunks;
+            }
+        }
+        while (!world.getPendingChunks().empty())
+        {
+            world.integrateFinishedChunks();
+            std::this_thread::sleep_for(std::chrono::milliseconds{1});
+        }
+    }
+    else
+    {
+        chunks = bench::load_world(world, {0, 0, 0}, radius);
+    }
+    double const seconds = stopwatch.elapsedSeconds();
+
+    executor->shutdown();
+    return static_cast<double>(chunks) / seconds;
+}
+} // namespace
+
+/**
+ * Loads a world of the given radius (default 16) through World's generation pipeline
+ * with several worker counts, region sizes and submission orders, and reports chunks
+ * per second. The unit tests check that every one of these loads gives the same world.
+ *
+ * Usage: pipeline_bench [radius] [seed]
+ */
+int main(int argc, char** argv)
+{
+    int const radius = argc > 1 ? std::stoi(argv[1]) : 16;
+    int32_t const seed = argc > 2 ? std::stoi(argv[2]) : 1337;
+
+    bench::init_logging();
+    concurrencpp::runtime runtime;
+
+    std::vector<std::size_t> threadCounts{1, 2, 4};
+    if (std::size_t const hardware = std::thread::hardware_concurrency(); hardware > threadCounts.back())
+        threadCounts.push_back(hardware);
+
+    std::println("radius {}", radius);
+    std::println("{:>10}{:>8}{:>12}{:>12}", "threads", "region", "order", "chunks/s");
+    for (std::size_t const threads : threadCounts)
+    {
+        for (auto const& [regionChunks, oneByOne] : {std::pair{1, false}, std::pair{4, false}, std::pair{4, true}})
+        {
+            double const chunksPerSecond = load(runtime, threads, regionChunks, oneByOne, radius, seed);
+            std::println("{:>10}{:>8}{:>12}{:>12.0f}", threads, regionChunks, oneByOne ? "reversed" : "batch", chunksPerSecond);
+        }
+    }
+    return 0;
+}
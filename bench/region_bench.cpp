@@ -0,0 +1,109 @@
+#include "BenchCommon.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <print>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <concurrencpp/concurrencpp.h>
+#include <ecs/events/EventBus.hpp>
+#include <world/Chunk.hpp>
+#include <world/ChunkGenerator.hpp>
+#include <world/World.hpp>
+
+namespace
+{
+using namespace mc;
+
+/**
+ * @brief Checks that a region generated in one call equals its chunks generated one by one.
+ */
+bool region_matches_chunks(world::NoiseBackend backend, int32_t seed)
+{
+    constexpr int REGION_CHUNKS = 4;
+    world::ChunkGenerator const generator{seed, backend};
+
+    std::vector<world::Chunk> region;
+    region.reserve(REGION_CHUNKS * REGION_CHUNKS);
+    for (int i = 0; i < REGION_CHUNKS * REGION_CHUNKS; ++i)
+        region.emplace_back(Magnum::Vector3i{i % REGION_CHUNKS - 2, 0, i / REGION_CHUNKS - 2});
+    std::vector<world::Chunk*> chunks;
+    for (auto& chunk : region)
+        chunks.push_back(&chunk);
+    generator.generateRegion(chunks);
+
+    for (auto const& chunk : region)
+    {
+        auto const single = generator.generate(chunk.getPosition());
+        for (int z = 0; z < world::CHUNK_SIZE_Z; ++z)
+            for (int x = 0; x < world::CHUNK_SIZE_X; ++x)
+                for (int y = 0; y < world::CHUNK_SIZE_Y; ++y)
+                    if (chunk.getBlockUnchecked(x, y, z).type != single.getBlockUnchecked(x, y, z).type)
+                        return false;
+    }
+    return true;
+}
+
+double chunks_per_second(concurrencpp::runtime& runtime, std::size_t threads, int regionChunks, world::NoiseBackend backend, int radius, int32_t seed)
+{
+    auto executor = runtime.make_executor<concurrencpp::thread_pool_executor>("bench chunks", threads, std::chrono::seconds{10});
+    ecs::EventBus eventBus;
+    world::World world{executor, eventBus, seed, backend};
+    world.setRegionBatching(regionChunks);
+
+    bench::Stopwatch stopwatch;
+    std::size_t const chunks = bench::load_world(world, {0, 0, 0}, radius);
+    double const seconds = stopwatch.elapsedSeconds();
+
+    executor->shutdown();
+    return static_cast<double>(chunks) / seconds;
+}
+} // namespace
+
+/**
+ * Checks that region jobs generate the same chunks as per-chunk jobs, then loads a world
+ * of the given radius (default 24) through World with one generation job per chunk and
+ * with one job per 2x2 and 4x4 region, for both noise backends and several worker
+ * counts, and reports chunks per second.
+ *
+ * Usage: region_bench [radius] [seed]
+ */
+int main(int argc, char** argv)
+{
+    int const radius = argc > 1 ? std::stoi(argv[1]) : 24;
+    int32_t const seed = argc > 2 ? std::stoi(argv[2]) : 1337;
+
+    bench::init_logging();
+    concurrencpp::runtime runtime;
+
+    for (auto backend : {world::NoiseBackend::FAST_NOISE_LITE, world::NoiseBackend::FAST_NOISE_2})
+    {
+        if (!region_matches_chunks(backend, seed))
+        {
+            std::println(stderr, "region generation differs from per-chunk generation (backend {})", static_cast<int>(backend));
+            return 1;
+        }
+    }
+    std::println("region generation matches per-chunk generation");
+
+    std::vector<std::size_t> threadCounts{1, 2, 4};
+    if (std::size_t const hardware = std::thread::hardware_concurrency(); hardware > threadCounts.back())
+        threadCounts.push_back(hardware);
+
+    std::println("radius {}; chunks/s", radius);
+    for (auto backend : {world::NoiseBackend::FAST_NOISE_LITE, world::NoiseBackend::FAST_NOISE_2})
+    {
+        std::println("{}", backend == world::NoiseBackend::FAST_NOISE_2 ? "FastNoise2" : "FastNoiseLite");
+        std::println("{:>10}{:>12}{:>12}{:>12}{:>10}", "threads", "per chunk", "2x2", "4x4", "4x4 gain");
+        for (std::size_t const threads : threadCounts)
+        {
+            double const perChunk = chunks_per_second(runtime, threads, 1, backend, radius, seed);
+            double const region2 = chunks_per_second(runtime, threads, 2, backend, radius, seed);
+            double const region4 = chunks_per_second(runtime, threads, 4, backend, radius, seed);
+            std::println("{:>10}{:>12.0f}{:>12.0f}{:>12.0f}{:>9.2f}x", threads, perChunk, region2, region4, region4 / perChunk);
+        }
+    }
+    return 0;
+}
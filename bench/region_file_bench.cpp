@@ -0,0 +1,230 @@
+#include "BenchCommon.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <filesystem>
+#include <iterator>
+#include <print>
+#include <random>
+#include <string>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include <world/Chunk.hpp>
+#include <world/ChunkGenerator.hpp>
+#include <world/ChunkSerializer.hpp>
+#include <world/RegionStorage.hpp>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+namespace
+{
+using namespace mc::world;
+
+/**
+ * @brief Asks the OS to drop the cached pages of every file in @p directory.
+ *
+ * Only clean pages are dropped, so the files must have been synced. Best effort: where
+ * this is not supported, "cold" loads run from the page cache as well.
+ *
+ * @return Whether the cache could be dropped
+ */
+bool drop_page_cache(std::filesystem::path const& directory)
+{
+#if defined(__linux__)
+    for (auto const& entry : std::filesystem::directory_iterator{directory})
+    {
+        int const fd = ::open(entry.path().c_str(), O_RDONLY);
+        if (fd < 0) return false;
+        int const result = ::posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED);
+        ::close(fd);
+        if (result != 0) return false;
+    }
+    return true;
+#else
+    (void)directory;
+    return false;
+#endif
+}
+
+struct LoadResult
+{
+    double readUs = 0.0; ///< Per chunk, lookup and copy out of the file.
+    double decodeUs = 0.0; ///< Per chunk, decoding straight from the mapping.
+    std::size_t mismatches = 0;
+};
+
+/**
+ * @brief Loads @p order from a freshly opened storage, so the first pass sees whatever
+ * the page cache holds, first copying each chunk out and then decoding in place.
+ */
+LoadResult load(std::filesystem::path const& directory, std::vector<Magnum::Vector3i> const& order,
+    std::vector<std::vector<std::byte>> const& expected, std::vector<std::size_t> const& indexOf, bool cold)
+{
+    if (cold) drop_page_cache(directory);
+
+    LoadResult result;
+    {
+        RegionStorage storage{directory};
+        std::vector<std::byte> bytes;
+        mc::bench::Stopwatch stopwatch;
+        for (std::size_t i = 0; i < order.size(); ++i)
+        {
+            if (!storage.read(order[i], bytes) || bytes != expected[indexOf[i]]) ++result.mismatches;
+        }
+        result.readUs = stopwatch.elapsedSeconds() * 1e6 / static_cast<double>(order.size());
+    }
+
+    if (cold) drop_page_cache(directory);
+    {
+        RegionStorage storage{directory};
+        Chunk chunk{{0, 0, 0}};
+        mc::bench::Stopwatch stopwatch;
+        for (auto const& chunkPos : order)
+        {
+            storage.visit(chunkPos, [&chunk](std::span<std::byte const> record) { ChunkSerializer::decode(record, chunk); });
+            result.mismatches += chunk.getPosition() != chunkPos ? 1 : 0;
+        }
+        result.decodeUs = stopwatch.elapsedSeconds() * 1e6 / static_cast<double>(order.size());
+    }
+    return result;
+}
+} // namespace
+
+/**
+ * Saves a square of generated chunks into region files and reports the write cost, then
+ * rewrites them all to check that the sectors they leave behind are reused. Finally loads
+ * them back sequentially (region by region, in header order) and in random order, from a
+ * warm and from a cold page cache, with a plain copy and with decoding straight from the
+ * mapping. Checks that every chunk reads back byte for byte.
+ *
+ * Usage: region_file_bench [side in chunks] [seed]
+ */
+int main(int argc, char** argv)
+{
+    int const side = argc > 1 ? std::stoi(argv[1]) : 64;
+    int32_t const seed = argc > 2 ? std::stoi(argv[2]) : 1337;
+    auto const directory = std::filesystem::temp_directory_path() / "mc_region_file_bench";
+    std::filesystem::remove_all(directory);
+
+    ChunkGenerator generator{seed};
+    generator.setBiomesEnabled(true);
+    std::vector<Magnum::Vector3i> positions;
+    std::vector<std::vector<std::byte>> encoded;
+    std::vector<ChunkGenerator::Decoration> overflow;
+    Chunk chunk{{0, 0, 0}};
+    for (int z = -side / 2; z < side - side / 2; ++z)
+    {
+        for (int x = -side / 2; x < side - side / 2; ++x)
+        {
+            chunk.reset({x, 0, z});
+            generator.generate(chunk);
+            generator.generateFeatures(chunk, overflow);
+            positions.push_back(chunk.getPosition());
+            encoded.push_back(ChunkSerializer::encode(chunk));
+        }
+    }
+    std::size_t totalBytes = 0;
+    for (auto const& bytes : encoded)
+        totalBytes += bytes.size();
+
+    // Bytes in sectors some chunk or header uses; files grow by doubling, so their size
+    // says little about how well sectors are reused
+    auto const used_bytes = [&directory] {
+        std::size_t bytes = 0;
+        for (auto const& entry : std::filesystem::directory_iterator{directory})
+        {
+            auto const stats = RegionFile{entry.path()}.getStats();
+            bytes += (stats.sectors - stats.freeSectors) * REGION_SECTOR_SIZE;
+        }
+        return bytes;
+    };
+
+    double writeSeconds = 0.0;
+    {
+        RegionStorage storage{directory};
+        mc::bench::Stopwatch stopwatch;
+        for (std::size_t i = 0; i < positions.size(); ++i)
+            storage.write(positions[i], encoded[i]);
+        storage.sync();
+        writeSeconds = stopwatch.elapsedSeconds();
+    }
+    std::size_t const firstBytes = used_bytes();
+
+    // Rewrites move every chunk to free sectors; once a round is synced, the sectors of
+    // the copies it replaced must be taken by the next one
+    {
+        RegionStorage storage{directory};
+        for (int round = 0; round < 3; ++round)
+        {
+            for (std::size_t i = 0; i < positions.size(); ++i)
+                storage.write(positions[i], encoded[i]);
+            storage.sync();
+        }
+    }
+    std::size_t const rewrittenBytes = used_bytes();
+    std::size_t fileBytes = 0;
+    for (auto const& entry : std::filesystem::directory_iterator{directory})
+        fileBytes += entry.file_size();
+
+    double const megabytes = static_cast<double>(totalBytes) / 1e6;
+    std::println("{} chunks, {:.0f} bytes/chunk encoded, {:.1f} MB in {} region files ({:.0f}% sector padding)",
+        positions.size(), static_cast<double>(totalBytes) / static_cast<double>(positions.size()), static_cast<double>(firstBytes) / 1e6,
+        std::distance(std::filesystem::directory_iterator{directory}, std::filesystem::directory_iterator{}),
+        100.0 * (1.0 - static_cast<double>(totalBytes) / static_cast<double>(firstBytes)));
+    std::println("write + sync: {:.2f} us/chunk, {:.0f} MB/s; after 3 rewrites the chunks take {:.1f} MB of {:.1f} MB of files",
+        writeSeconds * 1e6 / static_cast<double>(positions.size()), megabytes / writeSeconds, static_cast<double>(rewrittenBytes) / 1e6,
+        static_cast<double>(fileBytes) / 1e6);
+
+    int failures = 0;
+    if (rewrittenBytes != firstBytes)
+    {
+        std::println(stderr, "FAILED: rewriting does not reuse free sectors ({} -> {} bytes)", firstBytes, rewrittenBytes);
+        ++failures;
+    }
+
+    // Sequential: region by region, chunks in header order
+    std::vector<std::size_t> sequential(positions.size());
+    for (std::size_t i = 0; i < sequential.size(); ++i)
+        sequential[i] = i;
+    std::ranges::sort(sequential, [&positions](std::size_t a, std::size_t b) {
+        auto const ra = RegionFile::regionOf(positions[a]);
+        auto const rb = RegionFile::regionOf(positions[b]);
+        return std::tuple{ra.z(), ra.x(), positions[a].z(), positions[a].x()} < std::tuple{rb.z(), rb.x(), positions[b].z(), positions[b].x()};
+    });
+    std::vector<std::size_t> random = sequential;
+    std::ranges::shuffle(random, std::mt19937{static_cast<uint32_t>(seed)});
+
+    bool const canDropCache = drop_page_cache(directory);
+    std::println("{:<12}{:<8}{:>14}{:>12}{:>16}", "order", "cache", "read us/chunk", "read MB/s", "decode us/chunk");
+    for (auto const& [name, indices] : {std::pair{"sequential", &sequential}, std::pair{"random", &random}})
+    {
+        std::vector<Magnum::Vector3i> order;
+        for (std::size_t const i : *indices)
+            order.push_back(positions[i]);
+
+        for (bool const cold : {true, false})
+        {
+            auto const result = load(directory, order, encoded, *indices, cold);
+            double const perChunkMb = megabytes / static_cast<double>(positions.size());
+            std::println("{:<12}{:<8}{:>14.2f}{:>12.0f}{:>16.2f}", name, cold ? (canDropCache ? "cold" : "cold*") : "warm",
+                result.readUs, perChunkMb / (result.readUs * 1e-6), result.decodeUs);
+            if (result.mismatches > 0)
+            {
+                std::println(stderr, "FAILED: {} chunks read back wrong", result.mismatches);
+                ++failures;
+            }
+        }
+    }
+    if (!canDropCache)
+        std::println("* the page cache could not be dropped here, cold loads ran warm");
+
+    std::filesystem::remove_all(directory);
+    if (failures > 0) return 1;
+    std::println("every chunk reads back unchanged");
+    return 0;
+}
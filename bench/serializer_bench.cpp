@@ -0,0 +1,78 @@
+#include "BenchCommon.hpp"
+
+#include <cstddef>
+#include <print>
+#include <string>
+#include <vector>
+
+#include <world/Chunk.hpp>
+#include <world/ChunkGenerator.hpp>
+#include <world/ChunkSerializer.hpp>
+
+namespace
+{
+using namespace mc::world;
+
+/// Size of a chunk stored as one Block per position, the baseline MB/s are measured against.
+constexpr double RAW_CHUNK_BYTES = static_cast<double>(CHUNK_VOLUME) * sizeof(Block);
+} // namespace
+
+/**
+ * Reports encode and decode throughput of generated terrain, against a chunk of one Block
+ * per position, and the encoded size. The unit tests check the format itself.
+ *
+ * Usage: serializer_bench [chunks] [repetitions] [seed]
+ */
+int main(int argc, char** argv)
+{
+    int const count = argc > 1 ? std::stoi(argv[1]) : 256;
+    int const repetitions = argc > 2 ? std::stoi(argv[2]) : 8;
+    int32_t const seed = argc > 3 ? std::stoi(argv[3]) : 1337;
+
+    ChunkGenerator generator{seed};
+    generator.setBiomesEnabled(true);
+    std::vector<Chunk> chunks;
+    chunks.reserve(static_cast<std::size_t>(count));
+    std::vector<ChunkGenerator::Decoration> overflow;
+    for (int i = 0; i < count; ++i)
+    {
+        auto& chunk = chunks.emplace_back(Magnum::Vector3i{i % 16 * 37, 0, i / 16 * 37});
+        generator.generate(chunk);
+        generator.generateFeatures(chunk, overflow);
+    }
+
+    std::vector<std::vector<std::byte>> encoded(chunks.size());
+    mc::bench::Stopwatch stopwatch;
+    for (int r = 0; r < repetitions; ++r)
+    {
+        for (std::size_t i = 0; i < chunks.size(); ++i)
+        {
+            encoded[i].clear();
+            ChunkSerializer::encode(chunks[i], encoded[i]);
+        }
+    }
+    double const encodeSeconds = stopwatch.elapsedSeconds();
+
+    Chunk decoded{{0, 0, 0}};
+    stopwatch.restart();
+    for (int r = 0; r < repetitions; ++r)
+    {
+        for (auto const& bytes : encoded)
+            ChunkSerializer::decode(bytes, decoded);
+    }
+    double const decodeSeconds = stopwatch.elapsedSeconds();
+
+    std::size_t totalBytes = 0;
+    std::size_t maxBytes = 0;
+    for (auto const& bytes : encoded)
+    {
+        totalBytes += bytes.size();
+        maxBytes = std::max(maxBytes, bytes.size());
+    }
+    double const runs = static_cast<double>(count) * repetitions;
+    std::println("{} generated chunks x {}: {:.0f} bytes/chunk on average, {} at most ({:.0f}x smaller than raw)",
+        count, repetitions, static_cast<double>(totalBytes) / count, maxBytes, RAW_CHUNK_BYTES * count / static_cast<double>(totalBytes));
+    std::println("encode: {:.2f} us/chunk, {:.0f} MB/s raw", encodeSeconds * 1e6 / runs, RAW_CHUNK_BYTES * runs / encodeSeconds / 1e6);
+    std::println("decode: {:.2f} us/chunk, {:.0f} MB/s raw", decodeSeconds * 1e6 / runs, RAW_CHUNK_BYTES * runs / decodeSeconds / 1e6);
+    return 0;
+}
@@ -0,0 +1,139 @@
+#include "BenchCommon.hpp"
+
+#include <algorithm>
+#include <array>
+#include <print>
+#include <string>
+#include <vector>
+
+#include <world/Chunk.hpp>
+#include <world/ChunkGenerator.hpp>
+
+namespace
+{
+using namespace mc::world;
+
+Magnum::Vector3i chunk_at(int i)
+{
+    return {i % 16, 0, i / 16};
+}
+
+// The previous generator fill, kept here as the baseline: stone sections, then one
+// slice at a time through the surface band with a type chosen per block
+
+BlockType block_type_at(int y, int height)
+{
+    using enum BlockType;
+    if (y == height) return GRASS;
+    if (y > height - 4 && y < height) return DIRT;
+    if (y < height) return STONE;
+    return AIR;
+}
+
+void fill_per_slice(Chunk& chunk, std::array<int, CHUNK_SLICE_AREA> const& heights)
+{
+    auto const [minIt, maxIt] = std::ranges::minmax_element(heights);
+    int const uniformStoneTop = *minIt - 4;
+    int const maxHeight = *maxIt;
+    for (int sectionIndex = 0; sectionIndex < CHUNK_SECTION_COUNT; ++sectionIndex)
+    {
+        int const sectionMinY = sectionIndex * SECTION_SIZE;
+        int const sectionMaxY = sectionMinY + SECTION_SIZE - 1;
+        if (sectionMaxY <= uniformStoneTop)
+        {
+            chunk.fillSection(sectionIndex, Block{BlockType::STONE});
+            continue;
+        }
+        if (sectionMinY > maxHeight)
+            continue;
+
+        std::array<Block, CHUNK_SLICE_AREA> slice;
+        for (int y = sectionMinY; y <= std::min(sectionMaxY, maxHeight); ++y)
+        {
+            for (std::size_t i = 0; i < slice.size(); ++i)
+                slice[i] = Block{block_type_at(y, heights[i])};
+            chunk.setSlice(y, slice);
+        }
+    }
+}
+
+void sample_chunk_heights(ChunkGenerator const& generator, Magnum::Vector3i const& chunkPos, std::array<int, CHUNK_SLICE_AREA>& heights)
+{
+    generator.sampleHeights(chunkPos.x() * CHUNK_SIZE_X, chunkPos.z() * CHUNK_SIZE_Z, CHUNK_SIZE_X, CHUNK_SIZE_Z, heights);
+}
+
+bool same_chunk(Chunk const& a, Chunk const& b)
+{
+    for (int y = 0; y < CHUNK_SIZE_Y; ++y)
+        for (int z = 0; z < CHUNK_SIZE_Z; ++z)
+            for (int x = 0; x < CHUNK_SIZE_X; ++x)
+                if (a.getBlockUnchecked(x, y, z).type != b.getBlockUnchecked(x, y, z).type)
+                    return false;
+
+    for (auto type : {HeightmapType::HIGHEST_SOLID, HeightmapType::HIGHEST_NON_TRANSPARENT})
+        for (int z = 0; z < CHUNK_SIZE_Z; ++z)
+            for (int x = 0; x < CHUNK_SIZE_X; ++x)
+                if (a.getHeight(type, x, z) != b.getHeight(type, x, z))
+                    return false;
+    return true;
+}
+} // namespace
+
+/**
+ * Checks that ChunkGenerator's column-run fill produces the same chunks as the previous
+ * per-slice fill, then times both per chunk, along with the height sampling they share.
+ *
+ * Usage: terrain_fill_bench [chunks] [seed]
+ */
+int main(int argc, char** argv)
+{
+    int const count = argc > 1 ? std::stoi(argv[1]) : 1024;
+    int32_t const seed = argc > 2 ? std::stoi(argv[2]) : 1337;
+
+    ChunkGenerator const generator{seed};
+    std::array<int, CHUNK_SLICE_AREA> heights;
+    Chunk runs{{0, 0, 0}};
+    Chunk slices{{0, 0, 0}};
+    for (int i = 0; i < count; ++i)
+    {
+        runs.reset(chunk_at(i));
+        generator.generate(runs);
+        slices.reset(chunk_at(i));
+        sample_chunk_heights(generator, chunk_at(i), heights);
+        fill_per_slice(slices, heights);
+        if (!same_chunk(runs, slices))
+        {
+            std::println(stderr, "column-run fill mismatch in chunk [{}, {}]", chunk_at(i).x(), chunk_at(i).z());
+            return 1;
+        }
+    }
+    std::println("{} chunks, column-run fill matches the per-slice fill; us per chunk", count);
+
+    mc::bench::Stopwatch stopwatch;
+    for (int i = 0; i < count; ++i)
+        sample_chunk_heights(generator, chunk_at(i), heights);
+    double const heightsUs = stopwatch.elapsedSeconds() * 1e6 / count;
+
+    stopwatch.restart();
+    for (int i = 0; i < count; ++i)
+    {
+        runs.reset(chunk_at(i));
+        generator.generate(runs);
+    }
+    double const runsUs = stopwatch.elapsedSeconds() * 1e6 / count;
+
+    stopwatch.restart();
+    for (int i = 0; i < count; ++i)
+    {
+        slices.reset(chunk_at(i));
+        sample_chunk_heights(generator, chunk_at(i), heights);
+        fill_per_slice(slices, heights);
+    }
+    double const slicesUs = stopwatch.elapsedSeconds() * 1e6 / count;
+
+    std::println("heights       {:10.2f}", heightsUs);
+    std::println("per-slice     {:10.2f} (fill {:.2f})", slicesUs, slicesUs - heightsUs);
+    std::println("column runs   {:10.2f} (fill {:.2f})", runsUs, runsUs - heightsUs);
+    std::println("fill speedup  {:10.2f}x", (slicesUs - heightsUs) / (runsUs - heightsUs));
+    return 0;
+}
@@ -2,49 +2,108 @@
 
 #include "world/Block.hpp"
 
-#include <string>
-#include <unordered_map>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
 
 namespace mc::render
 {
+
+static constexpr int FACE_COUNT = 6;
+static constexpr int FACE_TOP = 2; ///< Index of the +Y face in the mesher's face order.
+static constexpr int FACE_BOTTOM = 3; ///< Index of the -Y face in the mesher's face order.
+
+using texture_id = uint16_t;
+
+/**
+ * @brief Known texture names; a texture's id is its index. Id 0 is the error texture.
+ */
+inline constexpr std::array<std::string_view, 11> TEXTURE_NAMES{
+    "ERROR! Incorrect texture ID",
+    "grass_top",
+    "grass_side",
+    "dirt",
+    "stone",
+    "log_oak",
+    "log_oak_top",
+    "leaves_oak_opaque",
+    "sand",
+    "snow",
+    "water_still",
+};
+inline constexpr texture_id TEXTURE_COUNT = TEXTURE_NAMES.size();
+
+/**
+ * @brief Id of a texture by name, or 0 for unknown names. Used when loading textures.
+ */
+constexpr texture_id get_texture_id_by_name(std::string_view name)
+{
+    for (texture_id id = 0; id < TEXTURE_COUNT; ++id)
+    {
+        if (TEXTURE_NAMES[id] == name) return id;
+    }
+    return 0;
+}
+
 /**
  * @brief Returns the texture name associated with a block type.
  *
  * Maps a BlockType to its corresponding texture name used for rendering.
  *
  * @param type The type of the block.
- * @param face TODO
- * @return Texture name as a string. Returns "error" for unknown types.
+ * @param face Face index in the mesher's face order (see FACE_TOP, FACE_BOTTOM).
+ * @return Texture name. Returns "error" for unknown types.
  */
-inline std::string get_texture_name_for_block(world::BlockType type, uint8_t face)
+constexpr std::string_view get_texture_name_for_block(world::BlockType type, int face)
 {
     switch (type)
     {
     case world::BlockType::GRASS:
-        if (face == 2) return "grass_top";
-        if (face == 3) return "dirt";
+        if (face == FACE_TOP) return "grass_top";
+        if (face == FACE_BOTTOM) return "dirt";
         return "grass_side";
     case world::BlockType::DIRT: return "dirt";
     case world::BlockType::STONE: return "stone";
+    case world::BlockType::LOG:
+        if (face == FACE_TOP || face == FACE_BOTTOM) return "log_oak_top";
+        return "log_oak";
+    case world::BlockType::LEAVES: return "leaves_oak_opaque";
+    case world::BlockType::SAND: return "sand";
+    case world::BlockType::SNOW: return "snow";
+    case world::BlockType::WATER: return "water_still";
     default: return "error";
     }
 }
 
-using texture_id = uint16_t;
-static std::unordered_map<std::string, texture_id> const TEXTURE_MAP = {
-    {"ERROR! Incorrect texture ID", 0},
-    {"grass_top", 1},
-    {"grass_side", 2},
-    {"dirt", 3},
-    {"stone", 4},
-};
-static texture_id g_max_texture_id = TEXTURE_MAP.size();
-inline texture_id get_texture_id_by_name(std::string const& name)
+namespace detail
 {
-    auto it = TEXTURE_MAP.find(name);
-    if (it != TEXTURE_MAP.end())
-        return it->second;
+using FaceTextureTable = std::array<std::array<texture_id, FACE_COUNT>, world::BLOCK_TYPE_COUNT>;
 
-    return 0;
+constexpr FaceTextureTable make_face_texture_table()
+{
+    FaceTextureTable table{};
+    for (std::size_t type = 0; type < world::BLOCK_TYPE_COUNT; ++type)
+    {
+        for (int face = 0; face < FACE_COUNT; ++face)
+        {
+            table[type][face] = get_texture_id_by_name(get_texture_name_for_block(static_cast<world::BlockType>(type), face));
+        }
+    }
+    return table;
 }
+} // namespace detail
+
+/**
+ * @brief Texture id of every face of every block type, resolved at compile time.
+ */
+inline constexpr detail::FaceTextureTable FACE_TEXTURES = detail::make_face_texture_table();
+
+constexpr texture_id get_texture_id(world::BlockType type, int face)
+{
+    return FACE_TEXTURES[static_cast<std::size_t>(type)][face];
+}
+
+static_assert(get_texture_id(world::BlockType::GRASS, FACE_TOP) == get_texture_id_by_name("grass_top"));
+static_assert(get_texture_id(world::BlockType::GRASS, FACE_BOTTOM) == get_texture_id_by_name("dirt"));
 } // namespace mc::render
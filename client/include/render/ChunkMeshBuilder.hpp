@@ -1,12 +1,11 @@
 #pragma once
 
 #include "render/BlockTextureMapper.hpp"
-#include <utils/IVec3Hasher.hpp>
 #include <world/Chunk.hpp>
 #include <world/IChunkProvider.hpp>
 
+#include <array>
 #include <optional>
-#include <unordered_map>
 #include <vector>
 
 
@@ -19,7 +18,6 @@ namespace mc::render
 {
 struct Vertex;
 
-static constexpr int FACE_COUNT = 6;
 static constexpr int VERTS_PER_FACE = 4;
 
 /**
@@ -29,27 +27,56 @@ class ChunkMeshBuilder
 {
 public:
     using OffsetTuple = std::tuple<Magnum::Vector3i, Magnum::Vector3i, Magnum::Vector3i>;
-    using CachedChunksMap = std::unordered_map<Magnum::Vector3i, world::Chunk const*, utils::IVec3Hasher>;
+
+    /**
+     * @brief The chunk being meshed and its 8 horizontal neighbours, looked up without hashing.
+     */
+    struct ChunkNeighborhood
+    {
+        Magnum::Vector3i center;
+        std::array<world::Chunk const*, 9> chunks{}; ///< Indexed by (dz + 1) * 3 + (dx + 1).
+
+        [[nodiscard]] world::Chunk const* find(Magnum::Vector3i const& chunkPos) const
+        {
+            int const dx = chunkPos.x() - center.x() + 1;
+            int const dz = chunkPos.z() - center.z() + 1;
+            if (dx < 0 || dx > 2 || dz < 0 || dz > 2 || chunkPos.y() != center.y()) return nullptr;
+            return chunks[dz * 3 + dx];
+        }
+    };
 
     /**
      * @brief Builds a mesh from the given chunk.
      *
      * @param chunk Reference to the voxel chunk.
+     * @param chunkProvider Provides the neighbouring chunks used for face culling and AO.
+     * @param skipHiddenSections Skip sections that cannot produce faces; only disabled for benchmarking.
      */
-    static std::vector<std::vector<Vertex>> buildVertexData(world::Chunk const& chunk, world::IChunkProvider const& chunkProvider);
+    static std::vector<std::vector<Vertex>> buildVertexData(
+        world::Chunk const& chunk,
+        world::IChunkProvider const& chunkProvider,
+        bool skipHiddenSections = true);
     static std::vector<ecs::MeshComponent> buildMeshComponents(std::vector<std::vector<Vertex>> const& vertsByTex);
 
 private:
-    static void collectVertices(world::Chunk const& chunk, CachedChunksMap const& chunks, std::vector<std::vector<Vertex>>& out);
+    static void collectVertices(world::Chunk const& chunk, ChunkNeighborhood const& chunks, bool skipHiddenSections, std::vector<std::vector<Vertex>>& out);
+
+    /**
+     * @brief Checks in O(1) whether a section can contribute any face.
+     *
+     * Empty sections never do; a uniformly solid section doesn't either when all six
+     * neighbouring sections are uniformly solid as well.
+     */
+    static bool isSectionHidden(world::Chunk const& chunk, ChunkNeighborhood const& chunks, int sectionIndex);
 
     static void processBlock(
-        CachedChunksMap const& chunks,
+        ChunkNeighborhood const& chunks,
         world::Block const& block,
         Magnum::Vector3i const& worldPos,
         std::vector<std::vector<Vertex>>& out);
 
     static std::array<Vertex, VERTS_PER_FACE> computeFaceVertices(
-        CachedChunksMap const& chunks,
+        ChunkNeighborhood const& chunks,
         Magnum::Vector3i const& worldPos,
         int face);
 
@@ -57,9 +84,13 @@ private:
 
     static void appendTriangles(std::vector<Vertex>& out, std::array<Vertex, VERTS_PER_FACE> const& faceVerts);
 
-    static bool isWorldBlockSolid(CachedChunksMap const& chunks, Magnum::Vector3i const& pos);
-    static std::optional<world::Block> getBlockAt(CachedChunksMap const& chunks, Magnum::Vector3i worldPos);
-    static float computeAo(CachedChunksMap const& chunks, Magnum::Vector3i const& vertexPos, OffsetTuple const& offsets);
+    /**
+     * @brief Whether the block at @p pos is drawn, hiding the faces next to it; solid
+     * blocks and fluids are.
+     */
+    static bool isWorldBlockMeshed(ChunkNeighborhood const& chunks, Magnum::Vector3i const& pos);
+    static std::optional<world::Block> getBlockAt(ChunkNeighborhood const& chunks, Magnum::Vector3i worldPos);
+    static float computeAo(ChunkNeighborhood const& chunks, Magnum::Vector3i const& vertexPos, OffsetTuple const& offsets);
 };
 
 } // namespace mc::render
@@ -117,6 +117,16 @@ private:
      */
     void enqueueChunkForMesh(utils::PrioritizedChunk const& chunk);
 
+    /**
+     * @brief Enqueues a chunk whose mesh is older than its blocks, by distance to the camera.
+     *
+     * Does nothing while a build of the chunk is pending; the chunk stays in m_staleMeshes
+     * and is requeued when that build is integrated.
+     *
+     * @param chunkPos Position of the modified chunk
+     */
+    void requeueStaleMesh(Magnum::Vector3i const& chunkPos);
+
     /**
      * @brief Processes the chunk mesh generation queue within the frame's time budget.
      *
@@ -157,6 +167,8 @@ private:
     std::unordered_map<Magnum::Vector3i, chunk_mesh_job, utils::IVec3Hasher> m_pendingMeshes;
     utils::PriorityUniqueQueue<utils::PrioritizedChunk, utils::PrioritizedChunkHasher> m_meshQueue;
     std::unordered_map<Magnum::Vector3i, std::vector<Entity>, utils::IVec3Hasher> m_chunkToMesh;
+    /// Chunks modified since their last mesh build was launched; rebuilt until none is left.
+    tsl::hopscotch_set<Magnum::Vector3i, utils::IVec3Hasher> m_staleMeshes;
 
     std::optional<Magnum::Vector3i> m_cachedCurrentChunk;
     tsl::hopscotch_set<Magnum::Vector3i, utils::IVec3Hasher> m_visibleChunks;
@@ -5,11 +5,10 @@
 #include "render/BlockTextureMapper.hpp"
 #include "render/Vertex.hpp"
 
+#include <algorithm>
 #include <array>
 #include <memory>
 #include <numeric>
-#include <string>
-#include <unordered_map>
 
 #include <Magnum/GL/Buffer.h>
 #include <Magnum/GL/Mesh.h>
@@ -18,6 +17,13 @@
 
 namespace
 {
+/// Blocks that are drawn. Without a translucent pass, fluids are drawn and culled like
+/// solid blocks, so a body of water shows its surface against air.
+constexpr bool is_meshed(mc::world::Block block)
+{
+    return block.isSolid() || block.isFluid();
+}
+
 constexpr std::array<Magnum::Vector3i, mc::render::FACE_COUNT> FACE_NORMALS{{
     {0, 0, 1}, // front
     {0, 0, -1}, // back
@@ -84,61 +90,104 @@ namespace mc::render
 
 std::vector<std::vector<Vertex>> ChunkMeshBuilder::buildVertexData(
     world::Chunk const& chunk,
-    world::IChunkProvider const& chunkProvider)
+    world::IChunkProvider const& chunkProvider,
+    bool skipHiddenSections)
 {
-    CachedChunksMap chunks;
-    Magnum::Vector3i center = chunk.getPosition();
-    for (int dx = -1; dx <= 1; ++dx)
+    ChunkNeighborhood chunks{chunk.getPosition()};
+    for (int dz = -1; dz <= 1; ++dz)
     {
-        for (int dz = -1; dz <= 1; ++dz)
+        for (int dx = -1; dx <= 1; ++dx)
         {
-            Magnum::Vector3i pos = center + Magnum::Vector3i{dx, 0, dz};
+            Magnum::Vector3i pos = chunks.center + Magnum::Vector3i{dx, 0, dz};
             if (auto opt = chunkProvider.getChunk(pos))
             {
-                chunks[pos] = &opt->get();
+                chunks.chunks[(dz + 1) * 3 + (dx + 1)] = &opt->get();
             }
         }
     }
 
-    std::vector<std::vector<Vertex>> vertsByTexture(g_max_texture_id);
-    collectVertices(chunk, chunks, vertsByTexture);
+    std::vector<std::vector<Vertex>> vertsByTexture(TEXTURE_COUNT);
+    collectVertices(chunk, chunks, skipHiddenSections, vertsByTexture);
     return vertsByTexture;
 }
 
-void ChunkMeshBuilder::collectVertices(world::Chunk const& chunk, CachedChunksMap const& chunks, std::vector<std::vector<Vertex>>& out)
+void ChunkMeshBuilder::collectVertices(world::Chunk const& chunk, ChunkNeighborhood const& chunks, bool skipHiddenSections, std::vector<std::vector<Vertex>>& out)
 {
     using namespace world;
     static constexpr Magnum::Vector3i CHUNK_SIZE{CHUNK_SIZE_X, CHUNK_SIZE_Y, CHUNK_SIZE_Z};
     Magnum::Vector3i chunkOffset = chunk.getPosition() * CHUNK_SIZE;
-    for (int x = 0; x < CHUNK_SIZE_X; ++x)
+
+    // Nothing above the highest solid block can produce a face, except fluids: the
+    // sections above it are meshed up to the highest one that is not empty
+    int maxY = chunk.getMaxHeight(HeightmapType::HIGHEST_SOLID);
+    for (int sectionIndex = CHUNK_SECTION_COUNT - 1; sectionIndex * SECTION_SIZE > maxY; --sectionIndex)
+    {
+        if (!chunk.getSection(sectionIndex).isEmpty())
+        {
+            maxY = sectionIndex * SECTION_SIZE + SECTION_SIZE - 1;
+            break;
+        }
+    }
+    for (int sectionIndex = 0; sectionIndex * SECTION_SIZE <= maxY; ++sectionIndex)
     {
-        for (int y = 0; y < CHUNK_SIZE_Y; ++y)
+        if (skipHiddenSections && isSectionHidden(chunk, chunks, sectionIndex))
+            continue;
+
+        auto const& section = chunk.getSection(sectionIndex);
+        int const sectionY = sectionIndex * SECTION_SIZE;
+        int const sectionTop = std::min(SECTION_SIZE - 1, maxY - sectionY);
+        for (int y = 0; y <= sectionTop; ++y)
         {
             for (int z = 0; z < CHUNK_SIZE_Z; ++z)
             {
-                auto block = chunk.getBlock(x, y, z);
-                if (!block.isSolid()) continue;
-
-                Magnum::Vector3i worldBlockPos = Magnum::Vector3i{x, y, z} + chunkOffset;
-                processBlock(chunks, block, worldBlockPos, out);
+                for (int x = 0; x < CHUNK_SIZE_X; ++x)
+                {
+                    auto block = section.getBlock(x, y, z);
+                    if (!is_meshed(block)) continue;
+
+                    Magnum::Vector3i worldBlockPos = Magnum::Vector3i{x, sectionY + y, z} + chunkOffset;
+                    processBlock(chunks, block, worldBlockPos, out);
+                }
             }
         }
     }
 }
 
+bool ChunkMeshBuilder::isSectionHidden(world::Chunk const& chunk, ChunkNeighborhood const& chunks, int sectionIndex)
+{
+    using namespace world;
+
+    auto const& section = chunk.getSection(sectionIndex);
+    if (section.isEmpty()) return true;
+    if (!section.isUniformSolid()) return false;
+
+    auto isSolidSection = [&chunks](Magnum::Vector3i const& chunkPos, int index) {
+        if (index < 0 || index >= CHUNK_SECTION_COUNT) return false;
+        auto const* neighbour = chunks.find(chunkPos);
+        return neighbour != nullptr && neighbour->getSection(index).isUniformSolid();
+    };
+
+    Magnum::Vector3i const pos = chunk.getPosition();
+    return isSolidSection(pos, sectionIndex - 1) &&
+        isSolidSection(pos, sectionIndex + 1) &&
+        isSolidSection(pos + Magnum::Vector3i{1, 0, 0}, sectionIndex) &&
+        isSolidSection(pos + Magnum::Vector3i{-1, 0, 0}, sectionIndex) &&
+        isSolidSection(pos + Magnum::Vector3i{0, 0, 1}, sectionIndex) &&
+        isSolidSection(pos + Magnum::Vector3i{0, 0, -1}, sectionIndex);
+}
+
 void ChunkMeshBuilder::processBlock(
-    CachedChunksMap const& chunks,
+    ChunkNeighborhood const& chunks,
     world::Block const& block,
     Magnum::Vector3i const& worldPos,
     std::vector<std::vector<Vertex>>& out)
 {
     for (int face = 0; face < FACE_COUNT; ++face)
     {
-        if (isWorldBlockSolid(chunks, worldPos + FACE_NORMALS[face]))
+        if (isWorldBlockMeshed(chunks, worldPos + FACE_NORMALS[face]))
             continue;
 
-        auto textureName = get_texture_name_for_block(block.type, face);
-        auto textureId = get_texture_id_by_name(textureName);
+        texture_id const textureId = get_texture_id(block.type, face);
 
         auto faceVerts = computeFaceVertices(chunks, worldPos, face);
         adjustAo(faceVerts);
@@ -146,7 +195,7 @@ void ChunkMeshBuilder::processBlock(
     }
 }
 
-std::array<Vertex, VERTS_PER_FACE> ChunkMeshBuilder::computeFaceVertices(CachedChunksMap const& chunks, Magnum::Vector3i const& worldPos, int face)
+std::array<Vertex, VERTS_PER_FACE> ChunkMeshBuilder::computeFaceVertices(ChunkNeighborhood const& chunks, Magnum::Vector3i const& worldPos, int face)
 {
     std::array<Vertex, VERTS_PER_FACE> verts;
     for (int i = 0; i < VERTS_PER_FACE; ++i)
@@ -219,7 +268,7 @@ std::vector<ecs::MeshComponent> ChunkMeshBuilder::buildMeshComponents(std::vecto
     return result;
 }
 
-std::optional<world::Block> ChunkMeshBuilder::getBlockAt(CachedChunksMap const& chunks, Magnum::Vector3i worldPos)
+std::optional<world::Block> ChunkMeshBuilder::getBlockAt(ChunkNeighborhood const& chunks, Magnum::Vector3i worldPos)
 {
     using namespace world;
 
@@ -234,27 +283,27 @@ std::optional<world::Block> ChunkMeshBuilder::getBlockAt(CachedChunksMap const&
         worldPos.y(),
         worldPos.z() - chunkPos.z() * CHUNK_SIZE_Z};
 
-    auto it = chunks.find(chunkPos);
-    if (it == chunks.end()) return std::nullopt;
+    auto const* chunk = chunks.find(chunkPos);
+    if (chunk == nullptr) return std::nullopt;
 
-    return it->second->getBlock(local.x(), local.y(), local.z());
+    return chunk->getBlockUnchecked(local.x(), local.y(), local.z());
 }
 
-bool ChunkMeshBuilder::isWorldBlockSolid(CachedChunksMap const& chunks, Magnum::Vector3i const& pos)
+bool ChunkMeshBuilder::isWorldBlockMeshed(ChunkNeighborhood const& chunks, Magnum::Vector3i const& pos)
 {
     if (auto block = getBlockAt(chunks, pos))
     {
-        return block->isSolid();
+        return is_meshed(*block);
     }
     return false;
 }
 
-float ChunkMeshBuilder::computeAo(CachedChunksMap const& chunks, Magnum::Vector3i const& vertexPos, OffsetTuple const& offsets)
+float ChunkMeshBuilder::computeAo(ChunkNeighborhood const& chunks, Magnum::Vector3i const& vertexPos, OffsetTuple const& offsets)
 {
     auto [off1, off2, offC] = offsets;
-    bool s1 = isWorldBlockSolid(chunks, vertexPos + off1);
-    bool s2 = isWorldBlockSolid(chunks, vertexPos + off2);
-    bool sc = isWorldBlockSolid(chunks, vertexPos + offC);
+    bool s1 = isWorldBlockMeshed(chunks, vertexPos + off1);
+    bool s2 = isWorldBlockMeshed(chunks, vertexPos + off2);
+    bool sc = isWorldBlockMeshed(chunks, vertexPos + offC);
     return (s1 && s2)
         ? 0.0f
         : 1.0f - (static_cast<float>(s1 + s2 + sc) * 0.33f);
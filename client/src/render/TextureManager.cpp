@@ -42,9 +42,14 @@ TextureManager::TextureManager(std::string const& texturesDir)
         auto image = importer->image2D(0);
         CORRADE_INTERNAL_ASSERT(image);
 
+        // Animated textures are vertical strips of square frames; only one frame is used
+        Vector2i size = image->size();
+        if (size.y() > size.x()) size.y() = size.x();
+        ImageView2D const frame{image->storage(), image->format(), size, image->data()};
+
         GL::Texture2D texture;
-        texture.setStorage(1, GL::TextureFormat::RGBA8, image->size())
-            .setSubImage(0, {}, *image)
+        texture.setStorage(1, GL::TextureFormat::RGBA8, size)
+            .setSubImage(0, {}, frame)
             .setMinificationFilter(GL::SamplerFilter::Nearest)
             .setMagnificationFilter(GL::SamplerFilter::Nearest)
             .setWrapping(GL::SamplerWrapping::ClampToEdge);
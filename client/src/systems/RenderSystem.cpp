@@ -37,8 +37,19 @@ RenderSystem::RenderSystem(
     m_textureManager = std::make_unique<mc::render::TextureManager>("assets/textures/blocks");
 
     m_ecs.eventBus().subscribe<ChunkUnloaded>([this](ChunkUnloaded const& event) {
+        m_staleMeshes.erase(event.position);
         cleanupChunkMeshes(event.position);
     });
+    m_ecs.eventBus().subscribe<ChunkModified>([this](ChunkModified const& event) {
+        // A chunk never meshed gets its first mesh from the current blocks anyway
+        if (!m_chunkToMesh.contains(event.position) && !m_pendingMeshes.contains(event.position)) return;
+
+        // The current mesh stays drawn until the rebuilt one replaces it. A build already
+        // running may have read the blocks before the edit, so the chunk stays stale and is
+        // requeued once that build lands
+        m_staleMeshes.insert(event.position);
+        requeueStaleMesh(event.position);
+    });
 
     LOG(INFO, "RenderSystem initialized with render radius: {}", renderRadius);
 }
@@ -148,7 +159,7 @@ void RenderSystem::drawChunksInRadius(Magnum::Vector3i const& currentChunkPos)
                 }
             }
         }
-        else
+        if (it == m_chunkToMesh.end() || m_staleMeshes.contains(pos))
         {
             if (!m_cachedCurrentChunk) return;
 
@@ -167,6 +178,15 @@ void RenderSystem::enqueueChunkForMesh(utils::PrioritizedChunk const& chunk)
     m_meshQueue.push(chunk);
 }
 
+void RenderSystem::requeueStaleMesh(Magnum::Vector3i const& chunkPos)
+{
+    if (!m_cachedCurrentChunk) return;
+
+    float dx = chunkPos.x() - m_cachedCurrentChunk->x();
+    float dz = chunkPos.z() - m_cachedCurrentChunk->z();
+    enqueueChunkForMesh({chunkPos, dx * dx + dz * dz});
+}
+
 size_t RenderSystem::processMeshQueue(time_point const& start)
 {
     size_t launches = 0;
@@ -181,6 +201,8 @@ size_t RenderSystem::processMeshQueue(time_point const& start)
 
         if (auto opt = m_chunkProvider.getChunk(chunk->pos))
         {
+            // Edits from here on land after the blocks this build reads
+            m_staleMeshes.erase(chunk->pos);
             auto job = m_meshExecutor->submit([=, &chunkProvider = m_chunkProvider]() {
                 SPAM_LOG(DEBUG, "Enqueue mesh [{}, {}] for generation map on thread {}", chunk->pos.x(), chunk->pos.z(), std::this_thread::get_id());
                 return render::ChunkMeshBuilder::buildVertexData(opt->get(), chunkProvider);
@@ -236,6 +258,8 @@ void RenderSystem::integrateFinishedMeshes()
     for (auto& pos : toRemove)
     {
         m_pendingMeshes.erase(pos);
+        if (m_staleMeshes.contains(pos))
+            requeueStaleMesh(pos);
     }
 }
 
@@ -18,7 +18,9 @@ class MinecraftCppConan(ConanFile):
         "concurrencpp/0.1.7",
         "cpptrace/0.8.3",
         "fastnoise2/0.10.0-alpha",
-        "tsl-hopscotch-map/2.3.1"
+        "tsl-hopscotch-map/2.3.1",
+        "lz4/1.10.0",
+        "zstd/1.5.6"
     ]
     default_options = {
         "glfw/*:shared": False,
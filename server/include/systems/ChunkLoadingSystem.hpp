@@ -1,6 +1,7 @@
 #pragma once
 
 #include <chrono>
+#include <vector>
 
 #include <Magnum/Math/Vector3.h>
 #include <ecs/system/ISystem.hpp>
@@ -31,6 +32,11 @@ private:
     std::optional<Magnum::Vector3i> getCurrentChunk() const;
     void loadChunksInRadius(Magnum::Vector3i const& currentChunk);
     size_t processLoadQueue(time_point const& start);
+
+    /**
+     * @brief @p chunkPos and every other queued chunk of its region, removed from the queue.
+     */
+    std::vector<Magnum::Vector3i> takeRegionBatch(Magnum::Vector3i const& chunkPos);
     void updateStats(size_t launches, time_point const& start);
 
 private:
@@ -0,0 +1,126 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <span>
+#include <string_view>
+#include <vector>
+
+namespace mc::world
+{
+
+/**
+ * @brief Compression applied to encoded chunks before they are stored.
+ */
+enum class CompressionCodec : uint8_t
+{
+    NONE = 0, ///< Stored as encoded.
+    LZ4 = 1, ///< Fast enough for hot saving and loading.
+    ZSTD = 2, ///< Smaller, especially with a trained dictionary; for archival.
+};
+
+[[nodiscard]] std::string_view codec_name(CompressionCodec codec);
+
+/**
+ * @brief Codec and level a world compresses its chunks with.
+ */
+struct CompressionSettings
+{
+    CompressionCodec codec = CompressionCodec::LZ4;
+    int level = 0; ///< 0 for the codec's default; above 0, LZ4 switches to LZ4HC at that level.
+};
+
+/**
+ * @brief Compresses encoded chunks into self-describing frames.
+ *
+ * A frame is a u8 CompressionCodec, the u32 little-endian size of the data, then the
+ * codec's output. Frames record their codec, so chunks saved before a world changed
+ * codecs stay readable; Zstd frames also record the id of the dictionary they need.
+ *
+ * With a dictionary, Zstd learns the byte patterns common to all chunks (format header,
+ * palettes, typical runs) once instead of in every chunk, which matters for inputs of a
+ * few hundred bytes. Dictionaries come from trainDictionary() and must be kept with the
+ * world. Safe to use from several threads.
+ */
+class ChunkCompressor
+{
+public:
+    /// Largest decompressed size a frame may announce.
+    static constexpr std::size_t MAX_FRAME_BYTES = std::size_t{16} << 20;
+    static constexpr std::size_t FRAME_HEADER_SIZE = 5;
+
+    static constexpr uint32_t FILE_MAGIC = 0x4443434D; ///< "MCCD", starts the file store() writes.
+    static constexpr uint8_t FILE_VERSION = 1;
+
+    /**
+     * @param dictionary Zstd dictionary from trainDictionary(), or empty
+     * @throws std::invalid_argument if @p dictionary is not a Zstd dictionary
+     */
+    explicit ChunkCompressor(CompressionSettings settings = {}, std::vector<std::byte> dictionary = {});
+    ~ChunkCompressor();
+
+    ChunkCompressor(ChunkCompressor const&) = delete;
+    ChunkCompressor& operator=(ChunkCompressor const&) = delete;
+    ChunkCompressor(ChunkCompressor&&) noexcept;
+    ChunkCompressor& operator=(ChunkCompressor&&) noexcept;
+
+    /**
+     * @brief Trains a Zstd dictionary on encoded chunks representative of a world.
+     *
+     * A few hundred chunks are enough; the dictionary is then best kept for the lifetime
+     * of the world, as every chunk compressed with it needs it to be read back.
+     *
+     * @param capacity Largest dictionary size, in bytes
+     * @throws std::runtime_error if the samples are too few or too small to train on
+     */
+    [[nodiscard]] static std::vector<std::byte> trainDictionary(std::span<std::vector<std::byte> const> samples, std::size_t capacity = 16 * 1024);
+
+    /**
+     * @brief Compressor with the settings and dictionary store() wrote into @p path.
+     *
+     * @throws ChunkFormatError if the file is truncated, corrupt or from a newer version
+     * @throws std::system_error if the file cannot be read
+     */
+    [[nodiscard]] static ChunkCompressor load(std::filesystem::path const& path);
+
+    /**
+     * @brief Writes the settings and the dictionary into @p path, for load().
+     *
+     * Layout, little-endian: u32 FILE_MAGIC, u8 FILE_VERSION, u8 CompressionCodec, i32
+     * level, then the dictionary up to the end of the file. The file is written under
+     * another name first and renamed over @p path once complete.
+     *
+     * @throws std::system_error if the file cannot be written
+     */
+    void store(std::filesystem::path const& path) const;
+
+    /**
+     * @brief Appends one frame holding @p data to @p out.
+     */
+    void compress(std::span<std::byte const> data, std::vector<std::byte>& out) const;
+
+    /**
+     * @brief Replaces the contents of @p out with the data of a frame.
+     *
+     * @throws ChunkFormatError if the frame is corrupt or needs another dictionary
+     */
+    void decompress(std::span<std::byte const> frame, std::vector<std::byte>& out) const;
+
+    [[nodiscard]] CompressionSettings const& getSettings() const;
+    [[nodiscard]] std::span<std::byte const> getDictionary() const;
+
+    /// @return Id Zstd frames record for the dictionary, or 0 without one.
+    [[nodiscard]] uint32_t getDictionaryId() const;
+
+private:
+    /// Digested Zstd dictionaries, shared read-only by every thread.
+    struct ZstdDictionaries;
+
+    CompressionSettings m_settings;
+    std::vector<std::byte> m_dictionary;
+    std::unique_ptr<ZstdDictionaries> m_zstd; ///< Null without a dictionary.
+};
+
+} // namespace mc::world
@@ -1,20 +1,239 @@
 #pragma once
 
+#include <FastNoise/FastNoise.h>
 #include <FastNoiseLite.h>
+#include <atomic>
+#include <cstdint>
 #include <memory>
+#include <span>
+#include <vector>
 
 #include <world/Chunk.hpp>
+#include <world/ClimateMap.hpp>
 
 namespace mc::world
 {
+
+/**
+ * @brief Noise library used to sample terrain heights.
+ */
+enum class NoiseBackend : uint8_t
+{
+    FAST_NOISE_LITE, ///< Two scalar FastNoiseLite calls per column.
+    FAST_NOISE_2, ///< Whole grids at once with FastNoise2's SIMD GenUniformGrid2D.
+};
+
+/**
+ * @brief How terrain is shaped from noise.
+ */
+enum class TerrainShape : uint8_t
+{
+    HEIGHTMAP, ///< One surface height per column, no caves or overhangs.
+    DENSITY, ///< 3D density around the surface height, interpolated from a coarse lattice.
+};
+
+/**
+ * @brief Spacing in blocks of the lattice 3D density noise is sampled on.
+ *
+ * Each spacing must divide the chunk size along its axis. Density between lattice
+ * points is interpolated trilinearly, so coarser lattices are cheaper and smoother.
+ */
+struct DensityLattice
+{
+    int x = 4;
+    int y = 8;
+    int z = 4;
+};
+
+/**
+ * @brief Generates chunks from a seed, one GenerationStage at a time.
+ *
+ * TERRAIN and SURFACE run together in generate() and generateRegion(); FEATURES runs
+ * through generateFeatures() and hands the blocks it places outside the chunk back as
+ * decorations, which World applies to the neighbours (see applyDecorations()).
+ */
 class ChunkGenerator
 {
 public:
-    explicit ChunkGenerator(int32_t seed);
+    /**
+     * @brief A block a feature places outside the chunk it grows in.
+     */
+    struct Decoration
+    {
+        Magnum::Vector3i chunkPos; ///< Chunk the block lands in.
+        uint8_t x; ///< Position inside that chunk.
+        uint8_t y;
+        uint8_t z;
+        Block block;
+    };
+
+    /// Chunks, along X and Z, that features reach beyond the one they grow in.
+    static constexpr int FEATURE_REACH = 1;
+
+    /// Mask of every chunk within FEATURE_REACH, see decorationSourceBit().
+    static constexpr uint32_t ALL_DECORATION_SOURCES = (1u << (2 * FEATURE_REACH + 1) * (2 * FEATURE_REACH + 1)) - 1;
+
+    /**
+     * @brief Bit standing for the chunk at @p offset, within FEATURE_REACH, in masks of
+     * the neighbours whose decorations a chunk holds.
+     */
+    [[nodiscard]] static uint32_t decorationSourceBit(Magnum::Vector3i const& offset);
+
+    explicit ChunkGenerator(int32_t seed, NoiseBackend backend = NoiseBackend::FAST_NOISE_LITE);
+
+    /**
+     * @brief Switches between heightmap and 3D density terrain.
+     *
+     * @throws std::invalid_argument if a lattice spacing does not divide the chunk size
+     */
+    void setTerrainShape(TerrainShape shape, DensityLattice lattice = {});
+    [[nodiscard]] TerrainShape getTerrainShape() const;
+    [[nodiscard]] DensityLattice const& getDensityLattice() const;
+
+    /**
+     * @brief 3D noise evaluations one chunk costs in DENSITY mode with the current lattice.
+     */
+    [[nodiscard]] int getDensitySamplesPerChunk() const;
+
+    /**
+     * @brief 3D noise evaluations actually made since construction.
+     *
+     * Only lattice levels that can hold the surface are sampled, so this stays well
+     * below getDensitySamplesPerChunk() per chunk.
+     */
+    [[nodiscard]] uint64_t getDensitySampleCount() const;
+
+    /**
+     * @brief Shapes terrain heights, surface blocks and tree density by biome.
+     *
+     * Off by default: every column then gets the plain heightmap, grass and dirt.
+     */
+    void setBiomesEnabled(bool enabled);
+    [[nodiscard]] bool areBiomesEnabled() const;
+
+    [[nodiscard]] Biome getBiome(int worldX, int worldZ) const;
+    [[nodiscard]] ClimateMap const& getClimateMap() const;
 
     Chunk generate(Magnum::Vector3i const& chunkPos) const;
 
+    /**
+     * @brief Runs the TERRAIN and SURFACE stages in place on an empty (all-air) chunk, at
+     * its own position.
+     *
+     * These only depend on the chunk's position; features run through generateFeatures().
+     */
+    void generate(Chunk& chunk) const;
+
+    /**
+     * @brief Runs the TERRAIN and SURFACE stages in place on several empty chunks.
+     *
+     * The noise is sampled once over the rectangle of columns covering all of them, so
+     * this is meant for chunks of one region; the result equals generating them one by one.
+     */
+    void generateRegion(std::span<Chunk* const> chunks) const;
+
+    /**
+     * @brief Terrain surface heights of a rectangle of world columns.
+     *
+     * Both backends use the same octaves, frequencies and height shaping, but FastNoise2
+     * does not reproduce FastNoiseLite's gradients: heights match in range (64 +- 24) and
+     * character, not column by column. With biomes enabled, continentalness lowers and
+     * flattens the terrain near the coast and lifts and roughens it inland.
+     *
+     * @param worldX World X of the first column
+     * @param worldZ World Z of the first column
+     * @param sizeX Columns along X
+     * @param sizeZ Columns along Z
+     * @param out sizeX * sizeZ heights, indexed z * sizeX + x
+     */
+    void sampleHeights(int worldX, int worldZ, int sizeX, int sizeZ, std::span<int> out) const;
+
+    /**
+     * @brief Terrain surface heights of a grid of columns @p step blocks apart, without
+     * generating any chunk; sampleHeights() is the grid with a step of 1.
+     *
+     * Every sampled column gets the same height as in sampleHeights(). Steps above 1
+     * read the climate straight from the noise instead of the cache, so they must be
+     * multiples of ClimateMap::RESOLUTION, and the first column must lie on the grid.
+     *
+     * @param surface If not empty, receives the top block of each column (before features)
+     */
+    void sampleHeightGrid(int worldX, int worldZ, int step, int sizeX, int sizeZ, std::span<int> out, std::span<BlockType> surface = {}) const;
+
+    /**
+     * @brief SURFACE stage: the biome's top block (grass without biomes) on the top of
+     * every solid run near the top of its column, its filler (dirt) below it; deeper cave
+     * floors stay stone.
+     */
+    void generateSurface(Chunk& chunk) const;
+
+    /**
+     * @brief FEATURES stage: places the trees growing in a chunk that completed SURFACE.
+     *
+     * Trees only depend on the seed, the chunk's position and its surface; they grow on
+     * grass, as many as the biome at the chunk's centre allows. Their blocks
+     * falling into neighbouring chunks are appended to @p overflow instead.
+     */
+    void generateFeatures(Chunk& chunk, std::vector<Decoration>& overflow) const;
+
+    /**
+     * @brief Places decorations that landed in @p chunk.
+     *
+     * Leaves only fill air and logs replace anything, the same rule features follow
+     * inside their own chunk, so the result does not depend on whether the chunk or its
+     * neighbours were decorated first.
+     */
+    static void applyDecorations(Chunk& chunk, std::span<Decoration const> decorations);
+
+    [[nodiscard]] NoiseBackend getBackend() const;
+
 private:
+    /**
+     * @brief TERRAIN stage of heightmap terrain: stone up to each column's height (x fastest).
+     */
+    static void fillTerrain(Chunk& chunk, std::span<int const, CHUNK_SLICE_AREA> heights);
+
+    /**
+     * @brief TERRAIN stage: fills an empty chunk from its column heights with the current
+     * terrain shape.
+     */
+    void fillChunk(Chunk& chunk, std::span<int const, CHUNK_SLICE_AREA> heights) const;
+
+    /**
+     * @brief TERRAIN stage of density terrain: stone where the density is positive.
+     */
+    void fillDensityTerrain(Chunk& chunk, std::span<int const, CHUNK_SLICE_AREA> heights) const;
+
+    /**
+     * @brief Samples 3D noise at the lattice points of a chunk on levels [minLevel, maxLevel].
+     *
+     * Points are stored x fastest, then z, then level. The lattice includes the points on
+     * the far faces of the chunk, shared with its neighbours, so every block lies inside
+     * a complete cell.
+     */
+    void sampleDensityLattice(Magnum::Vector3i const& origin, int minLevel, int maxLevel, std::span<float> out) const;
+
+    /**
+     * @brief Turns the base and modifier noise of a column into its surface height.
+     *
+     * @param relief Scale of the height variation around the sea level
+     * @param lift Blocks the column is raised by
+     */
+    static int shapeHeight(float baseNoise, float modNoise, float relief = 1.0f, float lift = 0.0f);
+
+private:
+    int32_t m_seed;
+    NoiseBackend m_backend;
     FastNoiseLite m_noise; ///< Noise generator used for terrain shaping.
+    FastNoise::SmartNode<> m_gridNoise; ///< Same fractal as m_noise, for FastNoise2 grids.
+
+    TerrainShape m_shape = TerrainShape::HEIGHTMAP;
+    DensityLattice m_lattice;
+    FastNoiseLite m_densityNoise; ///< 3D noise added to the height gradient in DENSITY mode.
+    FastNoise::SmartNode<> m_gridDensityNoise; ///< Same fractal as m_densityNoise, for FastNoise2.
+    mutable std::atomic<uint64_t> m_densitySamples{0};
+
+    bool m_biomes = false;
+    ClimateMap m_climate;
 };
 } // namespace mc::world
@@ -0,0 +1,76 @@
+#pragma once
+
+#include <unordered_map>
+#include <vector>
+
+#include <Magnum/Math/Vector3.h>
+#include <utils/IVec3Hasher.hpp>
+
+namespace mc::world
+{
+
+class Chunk;
+
+/**
+ * @brief Toroidal 2D index of the chunks in a square window around a center chunk.
+ *
+ * Every chunk column in the window maps to a fixed slot by wrapping its coordinates
+ * modulo the (power of two) grid width, so lookups need neither hashing nor division.
+ * Moving the center only refreshes the slots that wrapped around to new positions.
+ * The grid does not own chunks; World keeps it in sync with its chunk map.
+ */
+class ChunkGrid
+{
+public:
+    using ChunkMap = std::unordered_map<Magnum::Vector3i, Chunk*, utils::IVec3Hasher>;
+
+    /**
+     * @brief Moves the window to @p center, covering @p radius chunks in every direction.
+     *
+     * Slots that now cover a different position are refilled from @p chunks.
+     */
+    void recenter(Magnum::Vector3i const& center, int radius, ChunkMap const& chunks);
+
+    [[nodiscard]] bool covers(Magnum::Vector3i const& chunkPos) const
+    {
+        int const dx = chunkPos.x() - m_center.x();
+        int const dz = chunkPos.z() - m_center.z();
+        return chunkPos.y() == 0 && dx >= -m_radius && dx <= m_radius && dz >= -m_radius && dz <= m_radius;
+    }
+
+    /**
+     * @brief Chunk at a covered position, or nullptr when it is not loaded.
+     */
+    [[nodiscard]] Chunk* get(Magnum::Vector3i const& chunkPos) const
+    {
+        return m_slots[slotIndex(chunkPos)].chunk;
+    }
+
+    /**
+     * @brief Updates the slot of @p chunkPos; positions outside the window are ignored
+     * unless their slot still holds them from an earlier window.
+     */
+    void set(Magnum::Vector3i const& chunkPos, Chunk* chunk);
+
+private:
+    struct Slot
+    {
+        Magnum::Vector3i position;
+        Chunk* chunk = nullptr;
+    };
+
+    [[nodiscard]] std::size_t slotIndex(Magnum::Vector3i const& chunkPos) const
+    {
+        // The width is a power of two, so masking wraps negative coordinates correctly too
+        return static_cast<std::size_t>((chunkPos.z() & m_mask) * m_width + (chunkPos.x() & m_mask));
+    }
+
+private:
+    Magnum::Vector3i m_center{}; ///< Chunk the window is centered on.
+    int m_radius = -1; ///< Half-width of the window; negative until the first recenter().
+    int m_width = 0; ///< Slots per row, a power of two of at least 2 * radius + 1.
+    int m_mask = 0; ///< m_width - 1.
+    std::vector<Slot> m_slots; ///< m_width * m_width slots, indexed by wrapped (z, x).
+};
+
+} // namespace mc::world
@@ -0,0 +1,233 @@
+#pragma once
+
+#include "world/ChunkCompressor.hpp"
+#include "world/ChunkGenerator.hpp"
+#include "world/RegionStorage.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <span>
+#include <unordered_map>
+#include <vector>
+
+#include <Magnum/Math/Vector3.h>
+#include <concurrencpp/executors/thread_pool_executor.h>
+#include <concurrencpp/results/result.h>
+#include <utils/IVec3Hasher.hpp>
+#include <utils/LatencyHistogram.hpp>
+#include <world/Chunk.hpp>
+
+namespace mc::world
+{
+
+/**
+ * @brief Write-behind store of a world's modified chunks in region files.
+ *
+ * save() takes a chunk off the World thread's hands and queues it; flush() hands the
+ * queued chunks in batches to the I/O executor, which encodes, compresses and writes
+ * them. Until its write completes, a saved chunk stays in an in-flight buffer that
+ * findPending() serves, so a chunk unloaded and requested again right away never waits
+ * on the disk. Saving a chunk again before the earlier save is written supersedes it:
+ * only the newest version of a chunk reaches the disk.
+ *
+ * Chunks that are not in flight are read back with load(), which a chunk saved before
+ * the server restarted needs as well. The codec, level and dictionary chunks are
+ * compressed with are kept next to the region files, in COMPRESSION_FILE, and reopening
+ * the directory uses those.
+ *
+ * Region files keep new chunks out of their headers on disk until they are synced, by
+ * sync(), wait() or when they are closed; a crash loses the chunks written since.
+ *
+ * save(), flush(), collect(), sync() and wait() are called from the World thread;
+ * findPending(), isStored(), load() and the getters from any thread.
+ */
+class ChunkPersistence
+{
+public:
+    /**
+     * @brief A chunk as saved, with the blocks its features placed in other chunks,
+     * which neighbours generated later still need.
+     */
+    struct SavedChunk
+    {
+        Chunk chunk;
+        std::vector<ChunkGenerator::Decoration> decorations;
+        uint32_t decoratedBy = 0; ///< Neighbours whose decorations the chunk holds, see ChunkGenerator::decorationSourceBit().
+    };
+
+    struct Stats
+    {
+        uint64_t saved = 0; ///< Chunks handed to save().
+        uint64_t written = 0; ///< Chunks written to the region files.
+        uint64_t superseded = 0; ///< Saves skipped because a newer one of the same chunk followed.
+        uint64_t retried = 0; ///< Failed encodes or writes queued again.
+        uint64_t failed = 0; ///< Saves given up on after MAX_WRITE_ATTEMPTS; they stay in the in-flight buffer.
+        uint64_t batches = 0; ///< Batches written.
+        uint64_t bytesWritten = 0; ///< Compressed bytes, without sector padding.
+        std::size_t pending = 0; ///< Chunks in the in-flight buffer.
+    };
+
+    static constexpr std::size_t DEFAULT_BATCH_SIZE = 64;
+
+    /// Encodes and writes a save gets before it is given up on.
+    static constexpr int MAX_WRITE_ATTEMPTS = 3;
+
+    /// File of the directory ChunkCompressor::store() keeps the compression in.
+    static constexpr char const* COMPRESSION_FILE = "chunks.dict";
+
+    /**
+     * @param directory Directory of the region files
+     * @param ioExecutor Executor encoding and writing the batches
+     * @param compression Codec and level of a new directory; one that has a
+     * COMPRESSION_FILE keeps the codec and level stored there
+     * @param dictionary Zstd dictionary of a new directory, or empty
+     * @param batchSize Chunks queued before save() flushes on its own
+     * @throws std::invalid_argument if @p dictionary differs from the one the directory
+     * already has, which its chunks need to be read back
+     * @throws ChunkFormatError if COMPRESSION_FILE is corrupt
+     */
+    ChunkPersistence(
+        std::filesystem::path directory,
+        std::shared_ptr<concurrencpp::thread_pool_executor> ioExecutor,
+        CompressionSettings compression = {},
+        std::vector<std::byte> dictionary = {},
+        std::size_t batchSize = DEFAULT_BATCH_SIZE);
+
+    /**
+     * @brief Writes every chunk saved so far before returning.
+     */
+    ~ChunkPersistence();
+
+    ChunkPersistence(ChunkPersistence const&) = delete;
+    ChunkPersistence& operator=(ChunkPersistence const&) = delete;
+
+    /**
+     * @brief Queues a chunk for writing and makes it the one findPending() returns.
+     *
+     * Chunks copy cheaply, their sections being shared copy-on-write; an unloaded chunk
+     * is best moved in.
+     *
+     * @param decoratedBy Mask of the neighbours whose decorations the chunk holds
+     */
+    void save(Chunk chunk, std::vector<ChunkGenerator::Decoration> decorations, uint32_t decoratedBy = 0);
+
+    /**
+     * @brief Hands the queued chunks, and the failed saves to retry, to the I/O executor.
+     */
+    void flush();
+
+    /**
+     * @brief Forgets the batches that have been written, and flushes the saves that
+     * failed in them again.
+     */
+    void collect();
+
+    /**
+     * @brief Flushes, then syncs the region files on the I/O executor, without waiting.
+     *
+     * Written chunks only survive a crash once their region file is synced; the sync
+     * covers what is written by the time it runs, which with one I/O thread is every
+     * batch handed over before it.
+     */
+    void sync();
+
+    /**
+     * @brief Flushes, then blocks until every saved chunk is written and synced to disk,
+     * retrying failed saves up to MAX_WRITE_ATTEMPTS times.
+     *
+     * @throws std::runtime_error if some chunks could not be written; they stay in the
+     * in-flight buffer, and their next save tries again
+     */
+    void wait();
+
+    /**
+     * @brief Latest save of a chunk that is not written yet, or nullptr.
+     */
+    [[nodiscard]] std::shared_ptr<SavedChunk const> findPending(Magnum::Vector3i const& chunkPos) const;
+
+    /**
+     * @brief Whether a chunk has been written, from the header of its region file.
+     *
+     * Opens the region file the first time one of its chunks is looked up; regions
+     * without a file are remembered and cost no disk access afterwards.
+     */
+    [[nodiscard]] bool isStored(Magnum::Vector3i const& chunkPos);
+
+    /**
+     * @brief Reads a written chunk into @p chunk, decompressed and decoded.
+     *
+     * Chunks still in flight are read as last written; findPending() comes first.
+     *
+     * @param decorations Set to the blocks its features placed in other chunks
+     * @param decoratedBy Set to the mask of the neighbours whose decorations it holds
+     * @return False if the chunk was never written
+     * @throws ChunkFormatError if the stored chunk is corrupt or is another chunk
+     */
+    bool load(Magnum::Vector3i const& chunkPos, Chunk& chunk, std::vector<ChunkGenerator::Decoration>& decorations, uint32_t& decoratedBy);
+
+    [[nodiscard]] Stats getStats() const;
+
+    /**
+     * @brief Time from save() until the chunk is written.
+     */
+    [[nodiscard]] utils::LatencyHistogram const& getWriteLatency() const;
+
+    [[nodiscard]] std::filesystem::path const& getDirectory() const;
+    [[nodiscard]] ChunkCompressor const& getCompressor() const;
+
+private:
+    struct Pending
+    {
+        std::shared_ptr<SavedChunk const> saved;
+        uint64_t version = 0; ///< Increases with every save(), to tell a chunk's saves apart.
+        std::chrono::steady_clock::time_point since;
+        int attempts = 0; ///< Failed encodes or writes so far.
+    };
+
+    /**
+     * @brief Encodes and writes a batch; called on the I/O executor.
+     */
+    void writeBatch(std::span<Pending const> batch);
+
+    /**
+     * @brief Queues a save whose encode or write failed for the next flush(), unless it
+     * has used up its attempts.
+     */
+    void retryLater(Pending pending);
+
+    /**
+     * @brief Whether @p pending is still the latest save of its chunk.
+     */
+    [[nodiscard]] bool isLatest(Pending const& pending) const;
+
+private:
+    RegionStorage m_storage;
+    ChunkCompressor m_compressor;
+    std::shared_ptr<concurrencpp::thread_pool_executor> m_ioExecutor;
+    std::size_t m_batchSize;
+
+    mutable std::mutex m_pendingMutex; ///< Guards m_pending and m_retries.
+    std::unordered_map<Magnum::Vector3i, Pending, utils::IVec3Hasher> m_pending; ///< In-flight buffer: latest save of every chunk not written yet.
+    std::vector<Pending> m_retries; ///< Failed saves the next flush() queues again.
+    std::mutex m_writeMutex; ///< Batches write one at a time, so the latest save of a chunk is written last.
+
+    std::vector<Pending> m_queued; ///< Saved since the last flush(); World thread only.
+    std::vector<concurrencpp::result<void>> m_batches; ///< Batches handed to the executor; World thread only.
+    uint64_t m_lastVersion = 0;
+
+    std::atomic<uint64_t> m_saved{0};
+    std::atomic<uint64_t> m_written{0};
+    std::atomic<uint64_t> m_superseded{0};
+    std::atomic<uint64_t> m_retried{0};
+    std::atomic<uint64_t> m_failed{0};
+    std::atomic<uint64_t> m_batchesWritten{0};
+    std::atomic<uint64_t> m_bytesWritten{0};
+    utils::LatencyHistogram m_writeLatency;
+};
+
+} // namespace mc::world
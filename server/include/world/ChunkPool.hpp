@@ -0,0 +1,65 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+#include <Magnum/Math/Vector3.h>
+#include <world/Chunk.hpp>
+
+namespace mc::world
+{
+
+/**
+ * @brief Slab allocator handing out chunks with stable addresses.
+ *
+ * Chunks live in fixed-capacity slabs that never grow or move, so a pointer returned by
+ * acquire() stays valid until the chunk is released. Released chunks are reset and
+ * recycled by later acquisitions instead of being freed. Not thread-safe: acquire and
+ * release from the thread that owns the World; workers may only fill acquired chunks.
+ */
+class ChunkPool
+{
+public:
+    struct Stats
+    {
+        std::size_t capacity = 0; ///< Chunks constructed across all slabs.
+        std::size_t inUse = 0; ///< Chunks currently acquired.
+        std::size_t acquisitions = 0; ///< Total acquire() calls.
+        std::size_t reuses = 0; ///< Acquisitions served by a recycled chunk.
+
+        [[nodiscard]] double occupancy() const
+        {
+            return capacity == 0 ? 0.0 : static_cast<double>(inUse) / static_cast<double>(capacity);
+        }
+
+        [[nodiscard]] double reuseRate() const
+        {
+            return acquisitions == 0 ? 0.0 : static_cast<double>(reuses) / static_cast<double>(acquisitions);
+        }
+    };
+
+    explicit ChunkPool(std::size_t slabSize = 256);
+
+    ChunkPool(ChunkPool const&) = delete;
+    ChunkPool& operator=(ChunkPool const&) = delete;
+
+    /**
+     * @brief Returns an empty (all-air) chunk positioned at @p position.
+     */
+    [[nodiscard]] Chunk* acquire(Magnum::Vector3i const& position);
+
+    /**
+     * @brief Gives a chunk obtained from acquire() back to the pool for reuse.
+     */
+    void release(Chunk* chunk);
+
+    [[nodiscard]] Stats const& getStats() const;
+
+private:
+    std::size_t m_slabSize;
+    std::vector<std::vector<Chunk>> m_slabs; ///< Each reserved to m_slabSize up front and never grown past it.
+    std::vector<Chunk*> m_freeList; ///< Released chunks waiting for reuse.
+    Stats m_stats;
+};
+
+} // namespace mc::world
@@ -1,8 +1,12 @@
 #pragma once
 
-#include <filesystem>
-#include <memory>
-#include <optional>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <stdexcept>
+#include <vector>
+
+#include "world/ChunkGenerator.hpp"
 
 #include <Magnum/Math/Vector3.h>
 #include <world/Chunk.hpp>
@@ -11,13 +15,94 @@ namespace mc::world
 {
 
 /**
- * TODO: Implement binary serialization format
- * TODO: Add compression support (e.g., LZ4, Zstandard)
- * TODO: Implement chunk versioning for backward compatibility
- * TODO: Add async I/O operations
+ * @brief Thrown when encoded chunk data is truncated, corrupt or from a newer format.
+ */
+class ChunkFormatError : public std::runtime_error
+{
+public:
+    using std::runtime_error::runtime_error;
+};
+
+/**
+ * @brief Versioned binary codec for chunks.
+ *
+ * Layout, little-endian:
+ *  - u32 MAGIC, u16 format version, u16 mask of the stored sections (bit i = section i);
+ *    sections left out are all air
+ *  - i32 x, y, z of the chunk position
+ *  - every stored section, bottom to top: varint palette size, the palette's block types
+ *    as varints, then, unless the palette has a single entry, runs of equal palette
+ *    indices in the section's storage order, each one varint holding
+ *    (length - 1) << indexBits | index, with indexBits = bit_width(palette size - 1)
+ *  - since version 2: varint count of the blocks the chunk's features placed in other
+ *    chunks, then each one as zigzag varints of its chunk's offset from this one along
+ *    x, y and z, u8 x, y, z inside that chunk and a varint block type
+ *  - since version 3: varint mask of the neighbours whose decorations the chunk holds,
+ *    one ChunkGenerator::decorationSourceBit() per neighbour; older chunks count as
+ *    holding every neighbour's
+ *
+ * Only palette entries the section uses are written. Heightmaps are not stored; decode()
+ * rebuilds them. Data written by older versions of the format stays readable.
+ *
+ * A chunk restored from its encoding is not generated again, so the blocks its features
+ * placed in neighbours travel with it, for neighbours that are. The mask tells which
+ * neighbours' blocks it already holds, so that they are not placed again over edits.
  */
 class ChunkSerializer
 {
+public:
+    static constexpr uint32_t MAGIC = 0x4B48434D; ///< "MCHK"
+    static constexpr uint16_t FORMAT_VERSION = 3;
+    static constexpr std::size_t HEADER_SIZE = 20;
+
+    /**
+     * @brief Appends the encoded chunk to @p out.
+     *
+     * @param decorations Blocks the chunk's features placed in other chunks
+     * @param decoratedBy Mask of the neighbours whose decorations the chunk holds
+     */
+    static void encode(
+        Chunk const& chunk,
+        std::vector<std::byte>& out,
+        std::span<ChunkGenerator::Decoration const> decorations = {},
+        uint32_t decoratedBy = 0);
+    [[nodiscard]] static std::vector<std::byte> encode(
+        Chunk const& chunk,
+        std::span<ChunkGenerator::Decoration const> decorations = {},
+        uint32_t decoratedBy = 0);
+
+    /**
+     * @brief Turns @p chunk into the encoded chunk, at the encoded position.
+     *
+     * Sections are decoded straight into the chunk's palette storage.
+     *
+     * @throws ChunkFormatError if @p data is not exactly one valid encoded chunk; the
+     * chunk is then left partially decoded
+     */
+    static void decode(std::span<std::byte const> data, Chunk& chunk);
+
+    /**
+     * @brief Like decode(), also replacing the contents of @p decorations with the blocks
+     * the chunk's features placed in other chunks.
+     */
+    static void decode(std::span<std::byte const> data, Chunk& chunk, std::vector<ChunkGenerator::Decoration>& decorations);
+
+    /**
+     * @brief Like decode(), also setting @p decoratedBy to the mask of the neighbours
+     * whose decorations the chunk holds.
+     */
+    static void decode(
+        std::span<std::byte const> data,
+        Chunk& chunk,
+        std::vector<ChunkGenerator::Decoration>& decorations,
+        uint32_t& decoratedBy);
+
+    /**
+     * @brief Position stored in the header, without decoding the sections.
+     *
+     * @throws ChunkFormatError if the header is invalid
+     */
+    [[nodiscard]] static Magnum::Vector3i peekPosition(std::span<std::byte const> data);
 };
 
 } // namespace mc::world
@@ -0,0 +1,177 @@
+#pragma once
+
+#include <FastNoiseLite.h>
+#include <array>
+#include <cstdint>
+#include <mutex>
+#include <span>
+#include <string_view>
+
+#include <Magnum/Math/Vector3.h>
+#include <utils/IVec3Hasher.hpp>
+#include <utils/LruCache.hpp>
+#include <world/Block.hpp>
+#include <world/Chunk.hpp>
+
+namespace mc::world
+{
+
+/**
+ * @brief Climate of a world column; every field is noise in about [-1, 1].
+ */
+struct Climate
+{
+    float temperature = 0.0f;
+    float humidity = 0.0f;
+    float continentalness = 0.0f; ///< Low near the coast, high deep inland and in the mountains.
+};
+
+enum class Biome : uint8_t
+{
+    PLAINS,
+    FOREST,
+    DESERT,
+    SNOWY_PLAINS,
+    MOUNTAINS,
+
+    COUNT ///< Number of biomes; not a biome itself.
+};
+
+inline constexpr std::size_t BIOME_COUNT = static_cast<std::size_t>(Biome::COUNT);
+
+/**
+ * @brief What a biome puts on the surface.
+ */
+struct BiomeSurface
+{
+    BlockType top; ///< Highest block of a surface run.
+    BlockType filler; ///< The few blocks under it.
+    int maxTrees; ///< Tree attempts per chunk, at most.
+};
+
+constexpr Biome biome_of(Climate const& climate)
+{
+    using enum Biome;
+    if (climate.continentalness > 0.35f) return MOUNTAINS;
+    if (climate.temperature < -0.25f) return SNOWY_PLAINS;
+    if (climate.temperature > 0.25f && climate.humidity < 0.0f) return DESERT;
+    if (climate.humidity > 0.1f) return FOREST;
+    return PLAINS;
+}
+
+constexpr BiomeSurface biome_surface(Biome biome)
+{
+    using enum BlockType;
+    switch (biome)
+    {
+    case Biome::PLAINS: return {GRASS, DIRT, 1};
+    case Biome::FOREST: return {GRASS, DIRT, 5};
+    case Biome::DESERT: return {SAND, SAND, 0};
+    case Biome::SNOWY_PLAINS: return {SNOW, DIRT, 1};
+    case Biome::MOUNTAINS: return {STONE, STONE, 0};
+    case Biome::COUNT: break;
+    }
+    return {GRASS, DIRT, 0};
+}
+
+constexpr std::string_view biome_name(Biome biome)
+{
+    using enum Biome;
+    switch (biome)
+    {
+    case PLAINS: return "plains";
+    case FOREST: return "forest";
+    case DESERT: return "desert";
+    case SNOWY_PLAINS: return "snowy plains";
+    case MOUNTAINS: return "mountains";
+    case COUNT: break;
+    }
+    return "unknown";
+}
+
+/**
+ * @brief Temperature, humidity and continentalness of the world, sampled coarsely and
+ * blended per column.
+ *
+ * The noise is only evaluated every RESOLUTION blocks. Each chunk owns a tile of those
+ * coarse samples, kept in an LRU cache shared by all threads; a column is blended
+ * bilinearly from the four samples around it, which for the last columns of a chunk
+ * come from the tiles of its +X and +Z neighbours. Neighbouring chunks thus reuse each
+ * other's border samples, and blending is continuous across chunk borders.
+ */
+class ClimateMap
+{
+public:
+    static constexpr int RESOLUTION = 4; ///< Blocks between coarse samples.
+
+    struct Stats
+    {
+        uint64_t lookups = 0;
+        uint64_t hits = 0;
+        std::size_t tiles = 0; ///< Tiles currently cached.
+
+        [[nodiscard]] double hitRate() const
+        {
+            return lookups == 0 ? 0.0 : static_cast<double>(hits) / static_cast<double>(lookups);
+        }
+    };
+
+    /**
+     * @param cacheTiles Chunk tiles kept; a few times the chunks generated concurrently
+     */
+    explicit ClimateMap(int32_t seed, std::size_t cacheTiles = 4096);
+
+    /**
+     * @brief Climate of a rectangle of world columns.
+     *
+     * @param out sizeX * sizeZ climates, indexed z * sizeX + x
+     */
+    void sample(int worldX, int worldZ, int sizeX, int sizeZ, std::span<Climate> out) const;
+
+    [[nodiscard]] Climate sampleAt(int worldX, int worldZ) const;
+
+    /**
+     * @brief Climate at a coarse sample point, computed without going through the cache.
+     *
+     * Equals sampleAt() there, so sparse far-away samples do not evict the tiles of the
+     * chunks being generated.
+     *
+     * @param worldX Multiple of RESOLUTION
+     * @param worldZ Multiple of RESOLUTION
+     */
+    [[nodiscard]] Climate sampleCoarse(int worldX, int worldZ) const;
+
+    [[nodiscard]] Stats getStats() const;
+
+    /**
+     * @brief Drops every cached tile and resets the statistics.
+     */
+    void clearCache();
+
+private:
+    static_assert(CHUNK_SIZE_X == CHUNK_SIZE_Z && CHUNK_SIZE_X % RESOLUTION == 0);
+    static constexpr int TILE_SIDE = CHUNK_SIZE_X / RESOLUTION; ///< Coarse samples per chunk side.
+    using Tile = std::array<Climate, TILE_SIDE * TILE_SIDE>; ///< Samples of one chunk, x fastest.
+
+    /**
+     * @brief Coarse samples of a chunk, from the cache or computed and cached.
+     */
+    Tile tile(int chunkX, int chunkZ) const;
+    Tile computeTile(int chunkX, int chunkZ) const;
+
+    /**
+     * @brief Fills the part of @p out covered by one chunk from its 5x5 coarse samples.
+     */
+    void blendChunk(int chunkX, int chunkZ, int worldX, int worldZ, int sizeX, int sizeZ, std::span<Climate> out) const;
+
+private:
+    FastNoiseLite m_temperature;
+    FastNoiseLite m_humidity;
+    FastNoiseLite m_continentalness;
+
+    mutable std::mutex m_cacheMutex;
+    mutable utils::LruCache<Magnum::Vector3i, Tile, utils::IVec3Hasher> m_tiles;
+    mutable Stats m_stats; ///< Guarded by m_cacheMutex, tiles excepted.
+};
+
+} // namespace mc::world
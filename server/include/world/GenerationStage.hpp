@@ -0,0 +1,49 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+namespace mc::world
+{
+
+/**
+ * @brief Steps a chunk goes through while it is generated, in order.
+ *
+ * A chunk's stage is the last one it has completed; World runs every stage exactly once
+ * per chunk. Every stage only reads its own chunk: features spill into neighbours
+ * through decorations instead of waiting for the neighbourhood to be generated.
+ */
+enum class GenerationStage : uint8_t
+{
+    EMPTY, ///< Acquired from the pool, nothing generated yet.
+    TERRAIN, ///< Stone shape of the terrain.
+    SURFACE, ///< Biome surface blocks (grass and dirt, sand, snow) on the stone exposed to the sky.
+    FEATURES, ///< Trees; the blocks they place in neighbours are handed to World as decorations.
+    FINALIZED, ///< Sections interned; ready to be committed.
+
+    COUNT ///< Number of stages; not a stage itself.
+};
+
+inline constexpr std::size_t GENERATION_STAGE_COUNT = static_cast<std::size_t>(GenerationStage::COUNT);
+
+constexpr GenerationStage next_stage(GenerationStage stage)
+{
+    return static_cast<GenerationStage>(static_cast<uint8_t>(stage) + 1);
+}
+
+constexpr std::string_view stage_name(GenerationStage stage)
+{
+    using enum GenerationStage;
+    switch (stage)
+    {
+    case EMPTY: return "empty";
+    case TERRAIN: return "terrain";
+    case SURFACE: return "surface";
+    case FEATURES: return "features";
+    case FINALIZED: return "finalize";
+    case COUNT: break;
+    }
+    return "unknown";
+}
+} // namespace mc::world
@@ -0,0 +1,95 @@
+#pragma once
+
+#include "world/ChunkGenerator.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <unordered_map>
+#include <vector>
+
+#include <Magnum/Math/Vector3.h>
+#include <utils/IVec3Hasher.hpp>
+#include <world/HorizonTile.hpp>
+
+namespace mc::world
+{
+
+/**
+ * @brief Extent of the horizon rings.
+ */
+struct HorizonOptions
+{
+    int innerRadius = 16; ///< Loaded chunks around the player; level 0 starts at their edge.
+    int levels = 4;
+    int ringTiles = 3; ///< Tiles each level reaches past the one inside it.
+};
+
+/**
+ * @brief Far terrain around the player as HorizonTile rings, sampled straight from the
+ * generator's height function without creating any Chunk.
+ *
+ * Level 0 surrounds the loaded area with tiles sampled every HORIZON_BASE_STEP blocks;
+ * every further level doubles both the sample spacing and the tile size, and reaches
+ * about twice as far. A tile only partly covered by the level inside it is kept, so
+ * rings overlap a little instead of leaving gaps. Tiles are generated nearest first
+ * and kept while the player moves, so an update only samples the tiles that came into
+ * range.
+ */
+class HorizonMap
+{
+public:
+    struct Update
+    {
+        std::vector<Magnum::Vector3i> added; ///< Keys of the tiles generated.
+        std::vector<Magnum::Vector3i> removed; ///< Keys of the tiles dropped.
+        bool complete = false; ///< Every tile around the player exists.
+    };
+
+    struct Stats
+    {
+        uint64_t tilesGenerated = 0;
+        uint64_t tilesDropped = 0;
+        uint64_t samples = 0; ///< Height function evaluations.
+        double generationSeconds = 0.0;
+    };
+
+    explicit HorizonMap(ChunkGenerator const& generator, HorizonOptions const& options = {});
+
+    /**
+     * @brief Drops the tiles out of range of @p playerChunk and generates the missing
+     * ones, nearest first.
+     *
+     * Tiles out of range are dropped on every call, so the map never holds more than the
+     * rings around the player; while a budgeted update catches up, the farthest missing
+     * tiles show as holes rather than the stale tiles of another position.
+     *
+     * @param maxNewTiles Tiles generated at most by this call
+     */
+    Update update(Magnum::Vector3i const& playerChunk, std::size_t maxNewTiles = std::numeric_limits<std::size_t>::max());
+
+    [[nodiscard]] HorizonTile const* getTile(Magnum::Vector3i const& key) const;
+    [[nodiscard]] std::unordered_map<Magnum::Vector3i, HorizonTile, utils::IVec3Hasher> const& getTiles() const;
+    [[nodiscard]] Stats const& getStats() const;
+
+    /**
+     * @brief Keys of the tiles around @p playerChunk, nearest first within each level.
+     */
+    [[nodiscard]] std::vector<Magnum::Vector3i> wantedTiles(Magnum::Vector3i const& playerChunk) const;
+
+    /**
+     * @brief Tiles each side of the player's tile reaches on @p level.
+     */
+    [[nodiscard]] int ringRadius(int level) const;
+
+private:
+    void generateTile(HorizonTile& tile);
+
+private:
+    ChunkGenerator const& m_generator;
+    HorizonOptions m_options;
+    std::unordered_map<Magnum::Vector3i, HorizonTile, utils::IVec3Hasher> m_tiles;
+    Stats m_stats;
+};
+
+} // namespace mc::world
@@ -0,0 +1,96 @@
+#pragma once
+
+#include "world/GenerationStage.hpp"
+#include "world/SectionTable.hpp"
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+
+#include <utils/LatencyHistogram.hpp>
+
+namespace mc::world
+{
+
+/**
+ * @brief Generates every chunk within a radius of spawn ahead of play, as fast as the
+ * machine allows, and measures how it went.
+ *
+ * Runs the regular World pipeline on a dedicated thread pool, so the numbers double as a
+ * reproducible generation benchmark for a given seed, radius and thread count.
+ */
+class Pregenerator
+{
+public:
+    struct Options
+    {
+        int radius = 16; ///< Chunks around spawn, circular like the client's load radius.
+        int32_t seed = 0;
+        std::size_t threads = 0; ///< Generation workers; 0 uses every hardware thread.
+        int regionChunks = 4; ///< See World::setRegionBatching().
+        std::filesystem::path worldDirectory; ///< World the chunks are saved into; empty keeps them in memory only.
+        std::atomic<bool> const* stop = nullptr; ///< Set, e.g. by a signal handler, to end the run early.
+    };
+
+    struct Percentiles
+    {
+        std::chrono::nanoseconds p50{0};
+        std::chrono::nanoseconds p90{0};
+        std::chrono::nanoseconds p99{0};
+        std::chrono::nanoseconds max{0};
+
+        [[nodiscard]] static Percentiles of(utils::LatencyHistogram const& histogram);
+    };
+
+    struct Report
+    {
+        std::size_t chunks = 0; ///< Chunks requested and committed.
+        bool stopped = false; ///< Whether Options::stop ended the run before every chunk was committed.
+        std::size_t threads = 0;
+        double seconds = 0.0;
+        std::array<uint64_t, GENERATION_STAGE_COUNT> stageRuns{}; ///< Neighbour-only chunks included.
+        std::array<Percentiles, GENERATION_STAGE_COUNT> stageTimes{}; ///< Per chunk; TERRAIN includes SURFACE.
+        Percentiles loadLatency; ///< From submission until committed.
+        SectionTable::Stats sections;
+        std::size_t peakMemoryBytes = 0; ///< Peak resident set size of the process; 0 where unknown.
+        uint64_t chunksWritten = 0; ///< Chunks saved into the world directory; 0 without one.
+        uint64_t bytesWritten = 0; ///< Compressed bytes, without sector padding.
+        double writeSeconds = 0.0; ///< From handing the chunks over until they are synced to disk.
+
+        [[nodiscard]] double chunksPerSecond() const
+        {
+            return seconds > 0.0 ? static_cast<double>(chunks) / seconds : 0.0;
+        }
+
+        [[nodiscard]] double chunksWrittenPerSecond() const
+        {
+            return writeSeconds > 0.0 ? static_cast<double>(chunksWritten) / writeSeconds : 0.0;
+        }
+    };
+
+    explicit Pregenerator(Options const& options);
+
+    /**
+     * @brief Generates the area and returns once every chunk is committed and, with a
+     * world directory, written.
+     *
+     * Every chunk stays in memory until the run ends. With a world directory, all of them
+     * are saved into its region files once generated, so a server on that directory loads
+     * them instead of generating them. A run ended through Options::stop waits for the
+     * jobs already running and saves the chunks committed so far.
+     */
+    [[nodiscard]] Report run() const;
+
+private:
+    Options m_options;
+};
+
+/**
+ * @brief Peak resident set size of the process so far, in bytes; 0 where unsupported.
+ */
+[[nodiscard]] std::size_t peak_memory_usage();
+
+} // namespace mc::world
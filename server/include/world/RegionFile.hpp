@@ -0,0 +1,172 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <optional>
+#include <set>
+#include <shared_mutex>
+#include <span>
+#include <vector>
+
+#include <Magnum/Math/Vector3.h>
+
+namespace mc::world
+{
+
+constexpr int REGION_SIZE = 32; ///< Chunks along X and Z stored in one region file.
+constexpr int REGION_CHUNK_COUNT = REGION_SIZE * REGION_SIZE;
+constexpr std::size_t REGION_SECTOR_SIZE = 1024; ///< Allocation unit; small, as encoded chunks take a few hundred bytes.
+constexpr std::size_t REGION_HEADER_SECTORS = REGION_CHUNK_COUNT * sizeof(uint32_t) / REGION_SECTOR_SIZE;
+
+/**
+ * @brief One file holding the encoded chunks of a REGION_SIZE x REGION_SIZE square.
+ *
+ * Layout:
+ *  - the header, in the first REGION_HEADER_SECTORS sectors: one little-endian u32 per
+ *    chunk, indexed z * REGION_SIZE + x in region-local coordinates, holding
+ *    (first sector << 8) | sector count; 0 means the chunk is not stored
+ *  - every stored chunk: a u32 byte length followed by that many bytes, padded to
+ *    whole REGION_SECTOR_SIZE sectors
+ *
+ * Loading a chunk is one lookup in the header, kept in memory, plus one contiguous copy
+ * out of a read-only mapping of the file. A rewritten chunk goes to free sectors, and
+ * its header entry only reaches the disk on sync(), after the data has been flushed; the
+ * sectors of the copy it replaces are reused once that header entry is flushed too. A
+ * crash therefore leaves every chunk as of the last sync() or a later write, never a
+ * header entry pointing at data that did not reach the disk. The file grows by
+ * doubling, and the mapping is only replaced when it does.
+ *
+ * Reads may run concurrently with each other; writes are serialized against everything.
+ */
+class RegionFile
+{
+public:
+    /// Largest encoded chunk a record can hold.
+    static constexpr std::size_t MAX_CHUNK_BYTES = 255 * REGION_SECTOR_SIZE - sizeof(uint32_t);
+
+    struct Stats
+    {
+        std::size_t chunks = 0; ///< Chunks stored.
+        std::size_t sectors = 0; ///< Sectors in the file, the header included.
+        std::size_t freeSectors = 0; ///< Sectors no chunk uses, reused by later writes.
+    };
+
+    /**
+     * @brief Opens the region file at @p path, creating it with an empty header if it
+     * does not exist.
+     *
+     * Header entries pointing past the end of the file or into sectors another chunk
+     * already uses are dropped.
+     *
+     * @throws std::system_error if the file cannot be opened, created or mapped
+     */
+    explicit RegionFile(std::filesystem::path path);
+    ~RegionFile();
+
+    RegionFile(RegionFile const&) = delete;
+    RegionFile& operator=(RegionFile const&) = delete;
+
+    /**
+     * @brief Region, in region coordinates, a chunk belongs to.
+     */
+    static Magnum::Vector3i regionOf(Magnum::Vector3i const& chunkPos);
+
+    [[nodiscard]] bool contains(Magnum::Vector3i const& chunkPos) const;
+
+    /**
+     * @brief Copies the stored bytes of a chunk into @p out, replacing its contents.
+     *
+     * @return False if the chunk is not stored
+     * @throws std::system_error on read errors
+     */
+    bool read(Magnum::Vector3i const& chunkPos, std::vector<std::byte>& out) const;
+
+    /**
+     * @brief Calls @p visitor with the stored bytes of a chunk, read straight from the
+     * mapping, so that they can be decoded without a copy.
+     *
+     * Writes to this file wait until @p visitor returns.
+     *
+     * @return False if the chunk is not stored
+     */
+    template <typename VISITOR>
+    bool visit(Magnum::Vector3i const& chunkPos, VISITOR&& visitor) const
+    {
+        std::shared_lock lock{m_mutex};
+        auto const record = recordOf(chunkPos);
+        if (!record) return false;
+        visitor(*record);
+        return true;
+    }
+
+    /**
+     * @brief Stores the encoded bytes of a chunk, replacing any previous copy.
+     *
+     * @throws std::length_error if @p data is larger than MAX_CHUNK_BYTES
+     * @throws std::system_error on write errors
+     */
+    void write(Magnum::Vector3i const& chunkPos, std::span<std::byte const> data);
+
+    /**
+     * @brief Forgets a chunk; its sectors are reused once sync() has written the header
+     * entry.
+     */
+    void erase(Magnum::Vector3i const& chunkPos);
+
+    /**
+     * @brief Flushes written data, then the header entries of the chunks written or
+     * erased since the last call, to the disk.
+     *
+     * Until then, reads see the new copies but a reopened file the old ones. The
+     * destructor syncs as well.
+     */
+    void sync();
+
+    [[nodiscard]] Stats getStats() const;
+    [[nodiscard]] std::filesystem::path const& getPath() const;
+
+private:
+    static std::size_t localIndex(Magnum::Vector3i const& chunkPos);
+
+    /**
+     * @brief Stored bytes of a chunk inside the mapping; the caller holds m_mutex.
+     *
+     * @throws std::runtime_error if the record length does not fit its sectors
+     */
+    [[nodiscard]] std::optional<std::span<std::byte const>> recordOf(Magnum::Vector3i const& chunkPos) const;
+
+    /**
+     * @brief First sector of a free run of @p count sectors, appended past the end when
+     * no hole is large enough.
+     */
+    uint32_t allocate(uint32_t count);
+    void markSectors(uint32_t first, uint32_t count, bool used);
+
+    /**
+     * @brief Points a header entry at a new copy, or at none, until sync() writes it.
+     */
+    void setEntry(std::size_t index, uint32_t entry);
+
+    /**
+     * @brief Extends the file to at least @p sectors, doubling it, and maps it again.
+     */
+    void grow(std::size_t sectors);
+
+private:
+    /// Platform file handle with positional I/O and read-only mappings.
+    class NativeFile;
+
+    std::filesystem::path m_path;
+    std::unique_ptr<NativeFile> m_file;
+    std::span<std::byte const> m_mapping; ///< Read-only view of every sector of the file.
+    std::array<uint32_t, REGION_CHUNK_COUNT> m_header{}; ///< In-memory copy of the header, unsynced entries included.
+    std::array<uint32_t, REGION_CHUNK_COUNT> m_syncedHeader{}; ///< The header as last flushed to the disk.
+    std::set<std::size_t> m_dirtyEntries; ///< Entries of m_header not written since the last sync(), in file order.
+    std::vector<bool> m_usedSectors; ///< One flag per sector of the file, the header's included.
+    mutable std::shared_mutex m_mutex;
+};
+
+} // namespace mc::world
@@ -0,0 +1,110 @@
+#pragma once
+
+#include "world/RegionFile.hpp"
+
+#include <cstddef>
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <span>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+#include <Magnum/Math/Vector3.h>
+#include <utils/IVec3Hasher.hpp>
+#include <utils/LruCache.hpp>
+
+namespace mc::world
+{
+
+/**
+ * @brief Encoded chunks of a world, stored in one RegionFile per region of a directory.
+ *
+ * Region files are opened on first use and kept open, up to a limit, least recently
+ * used first out; closing one syncs it, which happens after the lock is released. Regions
+ * without a file are remembered apart from the open files, so looking up a chunk that
+ * was never saved neither touches the disk again nor closes an open file. Files are only
+ * created by the first write into their region. Safe to use from several threads.
+ */
+class RegionStorage
+{
+public:
+    /**
+     * @param directory Directory of the region files, created on the first write
+     * @param maxOpenFiles Region files kept open at once
+     */
+    explicit RegionStorage(std::filesystem::path directory, std::size_t maxOpenFiles = 64);
+
+    /**
+     * @brief Path of the file holding region @p region, in region coordinates.
+     */
+    [[nodiscard]] std::filesystem::path regionPath(Magnum::Vector3i const& region) const;
+
+    [[nodiscard]] bool contains(Magnum::Vector3i const& chunkPos);
+
+    /**
+     * @brief Copies the stored bytes of a chunk into @p out (see RegionFile::read()).
+     *
+     * @return False if the chunk was never saved
+     */
+    bool read(Magnum::Vector3i const& chunkPos, std::vector<std::byte>& out);
+
+    /**
+     * @brief Calls @p visitor with the stored bytes of a chunk (see RegionFile::visit()).
+     *
+     * @return False if the chunk was never saved
+     */
+    template <typename VISITOR>
+    bool visit(Magnum::Vector3i const& chunkPos, VISITOR&& visitor)
+    {
+        auto const file = find(chunkPos);
+        return file != nullptr && file->visit(chunkPos, std::forward<VISITOR>(visitor));
+    }
+
+    /**
+     * @brief Stores the encoded bytes of a chunk, creating its region file if needed.
+     */
+    void write(Magnum::Vector3i const& chunkPos, std::span<std::byte const> data);
+
+    void erase(Magnum::Vector3i const& chunkPos);
+
+    /**
+     * @brief Flushes every open region file to the disk.
+     *
+     * Files closed to make room for others have been written, but not necessarily flushed.
+     */
+    void sync();
+
+    [[nodiscard]] std::filesystem::path const& getDirectory() const;
+
+private:
+    /**
+     * @brief Open region file of a chunk, or nullptr if its region has no file.
+     */
+    std::shared_ptr<RegionFile> find(Magnum::Vector3i const& chunkPos);
+
+    /**
+     * @brief Region file of a chunk, created if its region has no file yet.
+     */
+    std::shared_ptr<RegionFile> findOrCreate(Magnum::Vector3i const& chunkPos);
+
+    /**
+     * @brief Caches the file of @p region, opened or created, reusing an instance that is
+     * still in use after being evicted, so that one file is never open twice; called with
+     * m_mutex held.
+     *
+     * @param evicted Receives the file closed to make room, to release once m_mutex is
+     */
+    std::shared_ptr<RegionFile> open(Magnum::Vector3i const& region, std::shared_ptr<RegionFile>& evicted);
+
+private:
+    std::filesystem::path m_directory;
+    std::mutex m_mutex; ///< Guards m_files, m_missingRegions and m_openFiles; region files lock themselves.
+    utils::LruCache<Magnum::Vector3i, std::shared_ptr<RegionFile>, utils::IVec3Hasher> m_files; ///< Open files, by region.
+    std::unordered_set<Magnum::Vector3i, utils::IVec3Hasher> m_missingRegions; ///< Regions looked up that have no file.
+    std::unordered_map<Magnum::Vector3i, std::weak_ptr<RegionFile>, utils::IVec3Hasher> m_openFiles; ///< Every file opened, possibly evicted but still in use.
+};
+
+} // namespace mc::world
@@ -1,17 +1,28 @@
 #pragma once
 
+#include "world/ChunkCompressor.hpp"
 #include "world/ChunkGenerator.hpp"
+#include "world/ChunkGrid.hpp"
+#include "world/ChunkPersistence.hpp"
+#include "world/ChunkPool.hpp"
+#include "world/GenerationStage.hpp"
+#include "world/SectionTable.hpp"
 
+#include <array>
+#include <chrono>
 #include <filesystem>
 #include <memory>
-#include <optional>
 #include <random>
+#include <span>
 #include <unordered_map>
 #include <unordered_set>
+#include <vector>
 
 #include <Magnum/Math/Vector3.h>
 #include <concurrencpp/executors/thread_pool_executor.h>
+#include <concurrencpp/results/result.h>
 #include <utils/IVec3Hasher.hpp>
+#include <utils/LatencyHistogram.hpp>
 
 namespace mc::ecs
 {
@@ -27,7 +38,27 @@ class Chunk;
  * @brief Manages voxel chunks and procedural generation in the game world.
  *
  * Handles chunk loading, storage, and initial area generation using a
- * procedural terrain generator.
+ * procedural terrain generator. Chunks are taken from a ChunkPool and generated
+ * in place, so a pointer returned by getChunk() stays valid until that chunk is unloaded.
+ * Generation runs as a pipeline of GenerationStage steps on the chunk executor: a chunk
+ * advances to its next stage only once the chunks around it have reached the stage
+ * that one reads, so requesting a chunk also generates the ones it depends on, up to
+ * the stages needed. Each stage runs once per chunk until it is unloaded.
+ *
+ * Blocks a chunk's features place in a neighbour are kept as pending decorations of
+ * that neighbour: applied when it commits, or patched in right away when it is already
+ * loaded. They are kept as long as their source chunk is, so a neighbour that is
+ * unloaded and generated again gets them back. Every loaded chunk records, and its save
+ * keeps, which neighbours' decorations it holds, so those are never placed twice.
+ * Lookups around the player go through a toroidal ChunkGrid and only fall back to
+ * the hashed chunk map outside of it.
+ *
+ * With persistence enabled, modified chunks are saved write-behind through a
+ * ChunkPersistence: moved out when they are unloaded, and copied out a time slice at a
+ * time by the periodic autosave while they stay loaded. Loading a chunk then looks for
+ * a save first: one still in flight is restored from memory, one on disk is read and
+ * decoded on the read executor, and only chunks never saved are generated, on the chunk
+ * executor, so neither slow generation nor write batches hold up loads from disk.
  */
 class World
 {
@@ -35,29 +66,321 @@ public:
     explicit World(
         std::shared_ptr<concurrencpp::thread_pool_executor> chunkExecutor,
         ecs::EventBus& eventBus,
-        int32_t seed = std::random_device{}());
+        int32_t seed = std::random_device{}(),
+        NoiseBackend noiseBackend = NoiseBackend::FAST_NOISE_LITE);
+
+    /**
+     * @brief Waits for the generation and disk jobs still running, which use the World,
+     * then saves every modified chunk if persistence is enabled.
+     */
+    ~World();
+
+    World(World const&) = delete;
+    World& operator=(World const&) = delete;
+
+    /**
+     * @brief Generation work done so far, for checking and profiling the pipeline.
+     */
+    struct GenerationStats
+    {
+        std::array<uint64_t, GENERATION_STAGE_COUNT> stageRuns{}; ///< Chunks each stage has run on.
+        std::array<std::size_t, GENERATION_STAGE_COUNT> chunksAtStage{}; ///< Chunks currently at each stage, committed ones included.
+    };
+
+    /**
+     * @brief Where a loaded chunk came from.
+     */
+    enum class LoadSource : uint8_t
+    {
+        GENERATOR, ///< Never saved; generated.
+        DISK, ///< Read from the region files.
+        PENDING_SAVE, ///< Restored from a save not written yet.
+        COUNT ///< Number of sources; not a source itself.
+    };
+
+    static constexpr std::size_t LOAD_SOURCE_COUNT = static_cast<std::size_t>(LoadSource::COUNT);
+
+    /**
+     * @brief Outcome of the chunk loads submitted so far.
+     */
+    struct LoadStats
+    {
+        uint64_t hits = 0; ///< Chunks restored from a save in flight or read back from disk.
+        uint64_t misses = 0; ///< Chunks generated, because they were never saved or failures.
+        uint64_t failures = 0; ///< Saved chunks that could not be read back and were generated again.
+        std::array<uint64_t, LOAD_SOURCE_COUNT> committed{}; ///< Chunks committed from each source.
+
+        [[nodiscard]] double hitRate() const
+        {
+            uint64_t const lookups = hits + misses;
+            return lookups == 0 ? 0.0 : static_cast<double>(hits) / static_cast<double>(lookups);
+        }
+    };
+
+    /**
+     * @brief Pacing of the periodic save of modified chunks that stay loaded.
+     */
+    struct AutosaveSettings
+    {
+        std::chrono::milliseconds interval{std::chrono::seconds{60}}; ///< Between the starts of two passes; also bounds the changes a crash loses.
+        std::chrono::microseconds sliceBudget{500}; ///< Time a tick may spend handing chunks over; at least one chunk is handed per tick.
+    };
 
     void submitChunkLoad(Magnum::Vector3i const& chunkPos);
+
+    /**
+     * @brief Submits several chunks at once, one generation job per region they fall in.
+     *
+     * Chunks of the same region advance together, so their terrain noise is sampled
+     * once over the region (see setRegionBatching()).
+     */
+    void submitChunkLoads(std::span<Magnum::Vector3i const> chunkPositions);
     void integrateFinishedChunks();
 
+    /**
+     * @brief Sets the side, in chunks, of the square regions generated in one job.
+     *
+     * @param regionChunks 1 (the default) generates every chunk in its own job
+     */
+    void setRegionBatching(int regionChunks);
+    [[nodiscard]] int getRegionBatching() const;
+
+    /**
+     * @brief Region, in region coordinates, that a chunk belongs to.
+     */
+    [[nodiscard]] Magnum::Vector3i getRegionOf(Magnum::Vector3i const& chunkPos) const;
+
     [[nodiscard]] Chunk const* getChunk(Magnum::Vector3i const& chunkPos) const;
 
+    /**
+     * @brief Centers the O(1) chunk lookup window on @p centerChunk.
+     *
+     * @param centerChunk Chunk the player is in
+     * @param radius Chunks covered in every direction, typically the unload radius
+     */
+    void recenterChunkGrid(Magnum::Vector3i const& centerChunk, uint8_t radius);
+
     [[nodiscard]] bool isChunkLoaded(Magnum::Vector3i const& pos) const;
     [[nodiscard]] bool isChunkPending(Magnum::Vector3i const& pos) const;
 
-    [[nodiscard]] std::unordered_map<Magnum::Vector3i, Chunk, utils::IVec3Hasher> const& getChunks() const;
+    [[nodiscard]] std::unordered_map<Magnum::Vector3i, Chunk*, utils::IVec3Hasher> const& getChunks() const;
     [[nodiscard]] std::unordered_set<Magnum::Vector3i, utils::IVec3Hasher> const& getPendingChunks() const;
 
     size_t unloadChunksOutsideRadius(Magnum::Vector3i const& centerChunk, uint8_t radius);
     [[nodiscard]] size_t getLoadedChunkCount() const;
+    [[nodiscard]] ChunkPool::Stats const& getChunkPoolStats() const;
+    [[nodiscard]] SectionTable::Stats getSectionTableStats();
+    [[nodiscard]] GenerationStats getGenerationStats() const;
+    [[nodiscard]] ClimateMap::Stats getClimateStats() const;
+
+    /**
+     * @brief Time spent running @p stage, per chunk.
+     *
+     * TERRAIN includes SURFACE, which always runs with it; a region job's time is split
+     * evenly between its chunks.
+     */
+    [[nodiscard]] utils::LatencyHistogram const& getStageTimes(GenerationStage stage) const;
+
+    /**
+     * @brief Time from submitting a chunk load until the chunk is committed.
+     */
+    [[nodiscard]] utils::LatencyHistogram const& getLoadLatency() const;
+
+    /**
+     * @brief getLoadLatency() of the chunks coming from @p source.
+     */
+    [[nodiscard]] utils::LatencyHistogram const& getLoadLatency(LoadSource source) const;
+
+    [[nodiscard]] LoadStats const& getLoadStats() const;
 
     void markChunkDirty(Magnum::Vector3i const& chunkPos);
 
+    /**
+     * @brief Saves modified chunks into the region files of @p directory from now on,
+     * and loads the chunks saved there instead of generating them.
+     *
+     * @param readExecutor Executor reading saved chunks, apart from the generation
+     * workers
+     * @param writeExecutor Executor encoding and writing the saved chunks, apart from
+     * @p readExecutor so that loads never queue behind write batches
+     * @param compression Codec and level of a new world; an existing one keeps its own
+     * @param dictionary Zstd dictionary of a new world, or empty
+     */
+    void enablePersistence(
+        std::filesystem::path const& directory,
+        std::shared_ptr<concurrencpp::thread_pool_executor> readExecutor,
+        std::shared_ptr<concurrencpp::thread_pool_executor> writeExecutor,
+        CompressionSettings compression = {},
+        std::vector<std::byte> dictionary = {});
+
+    void setAutosave(AutosaveSettings settings);
+
+    /**
+     * @brief Advances the periodic save by one time slice and forgets finished writes;
+     * call once per tick.
+     *
+     * Each pass ends by syncing the region files, so a crash loses the changes of at
+     * most one interval and the pass after it, chunks saved on unload included.
+     */
+    void tickAutosave();
+
+    /**
+     * @brief Saves every modified chunk and blocks until all saves are on disk, e.g. on shutdown.
+     *
+     * @throws std::runtime_error if some chunks could not be written, see ChunkPersistence::wait()
+     */
+    void saveAll();
+
+    /**
+     * @brief Persistence of the world, or nullptr until enablePersistence().
+     */
+    [[nodiscard]] ChunkPersistence const* getPersistence() const;
+
+    /**
+     * @brief Time each tickAutosave() that handed chunks over spent doing so.
+     */
+    [[nodiscard]] utils::LatencyHistogram const& getAutosaveSlices() const;
+
     int32_t getSeed() const;
 
+    /**
+     * @brief Generator of this world, for services sampling it without loading chunks
+     * (see HorizonMap).
+     */
+    [[nodiscard]] ChunkGenerator const& getGenerator() const;
+
 private:
+    /**
+     * @brief Generation progress of a chunk, from the time it is acquired until it is unloaded.
+     */
+    struct GenerationState
+    {
+        Chunk* chunk = nullptr;
+        GenerationStage stage = GenerationStage::EMPTY; ///< Last completed stage.
+        GenerationStage scheduled = GenerationStage::EMPTY; ///< Stage the running job takes the chunk to; equals stage when idle.
+        GenerationStage target = GenerationStage::EMPTY; ///< Stage the chunk has been requested up to.
+        std::vector<ChunkGenerator::Decoration> overflow; ///< Blocks FEATURES placed in neighbours, handed over when the job finishes.
+        std::chrono::steady_clock::time_point submitted; ///< When its load was submitted.
+        std::shared_ptr<ChunkPersistence::SavedChunk const> saved; ///< Save in flight to restore once no job runs on the chunk.
+        bool onDisk = false; ///< Saved on disk, to read once no job runs on the chunk; reset by the read if it fails.
+        uint32_t decoratedBy = 0; ///< Read from disk with the chunk: neighbours whose decorations it holds.
+
+        [[nodiscard]] bool isBusy() const { return scheduled != stage; }
+
+        /// Whether the chunk is restored from a save instead of generated.
+        [[nodiscard]] bool isStored() const { return saved != nullptr || onDisk; }
+    };
+
+    /**
+     * @brief Chunks of one region a job advances from the same stage, each up to its
+     * scheduled stage.
+     */
+    struct PendingJob
+    {
+        std::vector<GenerationState*> chunks;
+        concurrencpp::result<void> result;
+    };
+
+    /**
+     * @brief Blocks one chunk's features placed in a neighbour.
+     */
+    struct PendingDecorations
+    {
+        Magnum::Vector3i source;
+        std::vector<ChunkGenerator::Decoration> blocks;
+    };
+
     void enqueueChunk(Magnum::Vector3i const& chunkPos);
-    void commitChunk(Magnum::Vector3i chunkPos, Chunk chunkPtr);
+
+    /**
+     * @brief Raises the stage a chunk has to reach, acquiring it if needed.
+     */
+    void requestStage(Magnum::Vector3i const& chunkPos, GenerationStage target);
+
+    /**
+     * @brief Submits a job for every waiting chunk, taking it up to its target stage.
+     */
+    void scheduleStages();
+
+    void submitJob(std::vector<GenerationState*> chunks);
+
+    /**
+     * @brief Runs the scheduled stages of a job's chunks; called on a worker thread.
+     */
+    void runStages(std::span<GenerationState* const> chunks);
+    void commitChunk(Magnum::Vector3i chunkPos, Chunk* chunk);
+
+    /**
+     * @brief Restores the chunks of m_pendingRestores that no job reads anymore, from
+     * memory right away or from disk through a job per region.
+     */
+    void restorePendingChunks();
+
+    void submitDiskJob(std::vector<GenerationState*> chunks);
+
+    /**
+     * @brief Reads a chunk saved on disk into its state; called on m_readExecutor.
+     */
+    void readStoredChunk(GenerationState& state);
+
+    /**
+     * @brief Integrates finished disk jobs, generating the chunks that could not be read.
+     *
+     * @return Whether a job had finished
+     */
+    bool integrateDiskJobs();
+
+    /**
+     * @brief Commits a chunk holding its saved contents.
+     *
+     * Only the decorations of neighbours missing from @p decoratedBy are applied, so
+     * blocks the chunk already held and a player since edited are not placed again; the
+     * ones its own features placed are filed again, patching the loaded neighbours that
+     * do not hold them yet.
+     *
+     * @param decoratedBy Mask of the neighbours whose decorations the save holds
+     */
+    void commitStoredChunk(
+        GenerationState& state,
+        std::vector<ChunkGenerator::Decoration> decorations,
+        LoadSource source,
+        uint32_t decoratedBy);
+
+    void recordLoad(GenerationState const& state, LoadSource source);
+
+    /**
+     * @brief Hands a loaded chunk to the persistence, moved out if it is being unloaded.
+     */
+    void saveChunk(Magnum::Vector3i const& chunkPos, bool unloading);
+
+    /**
+     * @brief Files the blocks a chunk's features placed in its neighbours, patching the
+     * loaded ones that do not hold them yet.
+     */
+    void addDecorations(Magnum::Vector3i const& source, std::vector<ChunkGenerator::Decoration> overflow);
+
+    /**
+     * @brief Applies the pending decorations of a chunk about to commit, skipping the
+     * sources in @p decoratedBy and adding the ones applied.
+     */
+    void applyDecorations(Magnum::Vector3i const& chunkPos, Chunk& chunk, uint32_t& decoratedBy);
+
+    /**
+     * @brief Decorations a chunk's features placed in its neighbours.
+     */
+    [[nodiscard]] std::vector<ChunkGenerator::Decoration> decorationsFrom(Magnum::Vector3i const& source) const;
+
+    /**
+     * @brief Forgets the decorations a chunk's features placed in its neighbours.
+     */
+    void removeDecorationsFrom(Magnum::Vector3i const& source);
+
+    /**
+     * @brief Drops chunks still being generated outside the given radius.
+     *
+     * @return Number of chunks handed back to the pool
+     */
+    size_t dropGenerationOutsideRadius(Magnum::Vector3i const& centerChunk, int radius);
 
     /**
      * @brief Finds chunks that should be unloaded based on distance.
@@ -69,22 +392,37 @@ private:
     std::vector<Magnum::Vector3i> findChunksToUnload(Magnum::Vector3i const& centerChunk, uint8_t radius) const;
 
 private:
-    std::unordered_map<Magnum::Vector3i, Chunk, utils::IVec3Hasher> m_chunks;
+    SectionTable m_sectionTable; ///< Identical sections of generated chunks, shared between them.
+    ChunkPool m_chunkPool; ///< Owns every loaded and pending chunk.
+    std::unordered_map<Magnum::Vector3i, Chunk*, utils::IVec3Hasher> m_chunks;
+    ChunkGrid m_chunkGrid; ///< Hash-free index of m_chunks around the player.
     std::unordered_set<Magnum::Vector3i, utils::IVec3Hasher> m_pendingChunks;
-    std::unordered_map<Magnum::Vector3i, concurrencpp::result<Chunk>, utils::IVec3Hasher> m_pendingChunkResults;
+    std::unordered_map<Magnum::Vector3i, GenerationState, utils::IVec3Hasher> m_generation; ///< Every chunk taken from the pool; nodes stay put while jobs use them.
+    std::unordered_set<Magnum::Vector3i, utils::IVec3Hasher> m_waitingChunks; ///< Idle chunks below their target stage.
+    std::array<uint64_t, GENERATION_STAGE_COUNT> m_stageRuns{};
+    std::array<utils::LatencyHistogram, GENERATION_STAGE_COUNT> m_stageTimes; ///< Recorded by the workers.
+    utils::LatencyHistogram m_loadLatency;
+    std::array<utils::LatencyHistogram, LOAD_SOURCE_COUNT> m_sourceLatency; ///< m_loadLatency by LoadSource.
+    LoadStats m_loadStats;
+    std::unordered_map<Magnum::Vector3i, std::vector<PendingDecorations>, utils::IVec3Hasher> m_pendingDecorations; ///< By the chunk they land in, loaded or not.
+    std::vector<PendingJob> m_pendingJobs;
+    std::vector<PendingJob> m_diskJobs; ///< Reads of saved chunks, on m_readExecutor.
+    std::vector<Magnum::Vector3i> m_pendingRestores; ///< Saved chunks waiting for the jobs that may read them before being restored.
+    int m_regionChunks = 1; ///< Side of the regions generated in one job, in chunks.
 
     std::shared_ptr<concurrencpp::thread_pool_executor> m_chunkExecutor;
     ecs::EventBus& m_eventBus;
     int32_t m_seed;
     ChunkGenerator m_generator;
 
-    // Chunks that have been modified and should be saved before unloading
-    // TODO: Implement saving when block modification is added
-    std::unordered_set<Magnum::Vector3i, utils::IVec3Hasher> m_dirtyChunks;
-
-    // Path for saving world data to disk
-    // TODO: Make configurable, currently using default
-    std::filesystem::path m_worldSavePath{"worlds/default"};
+    std::unordered_set<Magnum::Vector3i, utils::IVec3Hasher> m_dirtyChunks; ///< Loaded chunks modified since they were last saved.
+    std::unordered_map<Magnum::Vector3i, uint32_t, utils::IVec3Hasher> m_decoratedBy; ///< Neighbours whose decorations each loaded chunk holds, see ChunkGenerator::decorationSourceBit().
+    std::unique_ptr<ChunkPersistence> m_persistence; ///< Null until enablePersistence(); modified chunks are then dropped on unload.
+    std::shared_ptr<concurrencpp::thread_pool_executor> m_readExecutor;
+    AutosaveSettings m_autosave;
+    std::chrono::steady_clock::time_point m_lastAutosave; ///< Start of the latest autosave pass.
+    std::vector<Magnum::Vector3i> m_autosaveQueue; ///< Chunks the running autosave pass has yet to save.
+    utils::LatencyHistogram m_autosaveSlices;
 };
 
 } // namespace mc::world
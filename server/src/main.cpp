@@ -1,14 +1,158 @@
+#include <core/Logger.hpp>
+#include <world/Pregenerator.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <csignal>
+#include <cstdio>
+#include <exception>
 #include <iostream>
+#include <optional>
+#include <print>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+
+namespace
+{
+using namespace mc;
+
+constexpr std::string_view USAGE = "Usage: Server [--pregen <radius> [--seed <n>] [--threads <k>] [--region <chunks>] [--world <dir>]]";
+
+/**
+ * @brief Options of a pregeneration run, or nothing if --pregen was not given.
+ *
+ * @throws std::invalid_argument on unknown arguments or missing values
+ */
+std::optional<world::Pregenerator::Options> parse_pregen_options(int argc, char** argv)
+{
+    bool pregen = false;
+    world::Pregenerator::Options options;
+    for (int i = 1; i < argc; ++i)
+    {
+        std::string_view const arg = argv[i];
+        if (i + 1 >= argc)
+            throw std::invalid_argument(std::string{"Missing value for "} + argv[i]);
+
+        if (arg == "--world")
+        {
+            options.worldDirectory = argv[++i];
+            continue;
+        }
+
+        int const value = std::stoi(argv[++i]);
+        if (arg == "--pregen")
+        {
+            if (value < 0) throw std::invalid_argument("Pregeneration radius must not be negative");
+            options.radius = value;
+            pregen = true;
+        }
+        else if (arg == "--seed") options.seed = value;
+        else if (arg == "--threads") options.threads = static_cast<std::size_t>(std::max(0, value));
+        else if (arg == "--region") options.regionChunks = value;
+        else throw std::invalid_argument(std::string{"Unknown argument "} + argv[i - 1]);
+    }
 
-int main(int, char**)
+    if (!pregen)
+        return std::nullopt;
+    return options;
+}
+
+/// Set on SIGINT or SIGTERM; lock-free, so the handler may store to it.
+std::atomic<bool> stopRequested{false};
+static_assert(std::atomic<bool>::is_always_lock_free);
+
+void request_stop(int signal)
+{
+    stopRequested.store(true, std::memory_order_relaxed);
+    // A second signal ends the process right away
+    std::signal(signal, SIG_DFL);
+}
+
+double to_ms(std::chrono::nanoseconds duration)
 {
+    return std::chrono::duration<double, std::milli>(duration).count();
+}
+
+void print_report(world::Pregenerator::Options const& options, world::Pregenerator::Report const& report)
+{
+    std::println("Pregenerated {} chunks (radius {}, seed {}) on {} threads in {:.2f} s: {:.0f} chunks/s{}",
+        report.chunks, options.radius, options.seed, report.threads, report.seconds, report.chunksPerSecond(),
+        report.stopped ? "; stopped early" : "");
+
+    std::println("{:<10}{:>10}{:>12}{:>12}{:>12}{:>12}", "stage", "runs", "p50 ms", "p90 ms", "p99 ms", "max ms");
+    for (auto stage = world::GenerationStage::TERRAIN; stage < world::GenerationStage::COUNT; stage = world::next_stage(stage))
+    {
+        // SURFACE runs inside TERRAIN's job and is timed with it
+        if (stage == world::GenerationStage::SURFACE) continue;
+
+        auto const index = static_cast<std::size_t>(stage);
+        auto const& times = report.stageTimes[index];
+        std::println("{:<10}{:>10}{:>12.3f}{:>12.3f}{:>12.3f}{:>12.3f}",
+            world::stage_name(stage), report.stageRuns[index], to_ms(times.p50), to_ms(times.p90), to_ms(times.p99), to_ms(times.max));
+    }
+    auto const& load = report.loadLatency;
+    std::println("{:<10}{:>10}{:>12.3f}{:>12.3f}{:>12.3f}{:>12.3f}", "load", report.chunks, to_ms(load.p50), to_ms(load.p90), to_ms(load.p99), to_ms(load.max));
+
+    std::println("{} unique sections ({:.1f} MiB), peak memory {:.1f} MiB",
+        report.sections.uniqueSections,
+        static_cast<double>(report.sections.memoryUsage) / (1024.0 * 1024.0),
+        static_cast<double>(report.peakMemoryBytes) / (1024.0 * 1024.0));
+
+    if (!options.worldDirectory.empty())
+    {
+        double const mib = static_cast<double>(report.bytesWritten) / (1024.0 * 1024.0);
+        std::println("Wrote {} chunks ({:.1f} MiB) into {} in {:.2f} s: {:.0f} chunks/s, {:.1f} MiB/s",
+            report.chunksWritten, mib, options.worldDirectory.string(), report.writeSeconds,
+            report.chunksWrittenPerSecond(), report.writeSeconds > 0.0 ? mib / report.writeSeconds : 0.0);
+    }
+}
+} // namespace
+
+int main(int argc, char** argv)
+{
+    std::optional<world::Pregenerator::Options> pregen;
+    try
+    {
+        pregen = parse_pregen_options(argc, argv);
+    }
+    catch (std::exception const& e)
+    {
+        std::println(stderr, "{}\n{}", e.what(), USAGE);
+        return 1;
+    }
+
+    if (pregen)
+    {
+        core::Logger::init();
+        core::Logger::get()->set_level(spdlog::level::warn);
+
+        // Stops generating and saves what is committed instead of dying mid-write
+        pregen->stop = &stopRequested;
+        std::signal(SIGINT, request_stop);
+        std::signal(SIGTERM, request_stop);
+
+        world::Pregenerator::Report report;
+        try
+        {
+            report = world::Pregenerator{*pregen}.run();
+        }
+        catch (std::exception const& e)
+        {
+            std::println(stderr, "Pregeneration failed: {}", e.what());
+            return 1;
+        }
+        print_report(*pregen, report);
+        return report.stopped ? 1 : 0;
+    }
+
     std::cout << "Minecraft Server - Starting..." << std::endl;
-    
+
     // TODO: Initialize ServerApplication
     // TODO: Start NetworkServer
     // TODO: Run main loop
-    
+
     std::cout << "Server not implemented yet" << std::endl;
     return 0;
 }
-
@@ -31,10 +31,11 @@ void ChunkLoadingSystem::update(float dt)
 
     if (*currentChunk != m_lastCameraChunk)
     {
+        static constexpr uint8_t UNLOAD_BUFFER = 2;
         m_lastCameraChunk = *currentChunk;
+        m_world.recenterChunkGrid(*currentChunk, m_loadRadius + UNLOAD_BUFFER);
         loadChunksInRadius(*currentChunk);
 
-        static constexpr uint8_t UNLOAD_BUFFER = 2;
         m_world.unloadChunksOutsideRadius(*currentChunk, m_loadRadius + UNLOAD_BUFFER);
     }
 
@@ -44,6 +45,7 @@ void ChunkLoadingSystem::update(float dt)
         updateStats(launches, start);
     }
     m_world.integrateFinishedChunks();
+    m_world.tickAutosave();
 }
 
 std::optional<Magnum::Vector3i> ChunkLoadingSystem::getCurrentChunk() const
@@ -104,12 +106,34 @@ size_t ChunkLoadingSystem::processLoadQueue(time_point const& start)
         auto chunk = m_loadQueue.pop();
         if (!chunk) break;
 
-        m_world.submitChunkLoad(chunk->pos);
-        ++launches;
+        auto const batch = takeRegionBatch(chunk->pos);
+        m_world.submitChunkLoads(batch);
+        launches += batch.size();
     }
     return launches;
 }
 
+std::vector<Magnum::Vector3i> ChunkLoadingSystem::takeRegionBatch(Magnum::Vector3i const& chunkPos)
+{
+    std::vector<Magnum::Vector3i> batch{chunkPos};
+    int const regionChunks = m_world.getRegionBatching();
+    if (regionChunks == 1)
+        return batch;
+
+    // The nearest queued chunk pulls the rest of its region's queued chunks into the same job
+    Magnum::Vector3i const regionOrigin = m_world.getRegionOf(chunkPos) * Magnum::Vector3i{regionChunks, 0, regionChunks};
+    for (int x = 0; x < regionChunks; ++x)
+    {
+        for (int z = 0; z < regionChunks; ++z)
+        {
+            Magnum::Vector3i const pos = regionOrigin + Magnum::Vector3i{x, 0, z};
+            if (pos != chunkPos && m_loadQueue.erase({pos, 0.0f}))
+                batch.push_back(pos);
+        }
+    }
+    return batch;
+}
+
 void ChunkLoadingSystem::updateStats(size_t launches, time_point const& start)
 {
     auto const duration = std::chrono::duration<double>(clock::now() - start).count();
@@ -46,16 +46,19 @@ bool CollisionSystem::isSolidAt(Magnum::Vector3d const& pos) const
 {
     using namespace world;
     auto blockPos = static_cast<Magnum::Vector3i>(Magnum::Math::floor(pos));
-    auto chunkPos = World::getChunkOfPosition(blockPos);
+    auto chunkPos = Chunk::getChunkOfPosition(blockPos);
 
     auto chunkPtr = m_world.getChunk(chunkPos);
     if (!chunkPtr) return false;
 
     int const localX = blockPos.x() & (CHUNK_SIZE_X - 1);
-    int const localY = blockPos.y() & (CHUNK_SIZE_Y - 1);
     int const localZ = blockPos.z() & (CHUNK_SIZE_Z - 1);
 
-    return chunkPtr->getBlock(localX, localY, localZ).isSolid();
+    // Anything above the column's highest solid block (or below the world) is empty
+    if (blockPos.y() < 0 || blockPos.y() > chunkPtr->getHeight(HeightmapType::HIGHEST_SOLID, localX, localZ))
+        return false;
+
+    return chunkPtr->getBlockUnchecked(localX, blockPos.y(), localZ).isSolid();
 }
 
 bool CollisionSystem::collides(const AABB& box) const
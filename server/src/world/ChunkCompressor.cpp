@@ -0,0 +1,297 @@
+#include "world/ChunkCompressor.hpp"
+
+#include "world/ChunkSerializer.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cerrno>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <utility>
+
+#include <lz4.h>
+#include <lz4hc.h>
+#include <zdict.h>
+#include <zstd.h>
+
+namespace mc::world
+{
+
+namespace
+{
+/// Magic, version, codec and level of a file ChunkCompressor::store() writes.
+constexpr std::size_t FILE_HEADER_SIZE = 10;
+
+struct ZstdCContextDeleter
+{
+    void operator()(ZSTD_CCtx* context) const { ZSTD_freeCCtx(context); }
+};
+
+struct ZstdDContextDeleter
+{
+    void operator()(ZSTD_DCtx* context) const { ZSTD_freeDCtx(context); }
+};
+
+/// Contexts are expensive to create and not thread-safe, so each thread keeps its own.
+ZSTD_CCtx* zstd_compression_context()
+{
+    thread_local std::unique_ptr<ZSTD_CCtx, ZstdCContextDeleter> const context{ZSTD_createCCtx()};
+    return context.get();
+}
+
+ZSTD_DCtx* zstd_decompression_context()
+{
+    thread_local std::unique_ptr<ZSTD_DCtx, ZstdDContextDeleter> const context{ZSTD_createDCtx()};
+    return context.get();
+}
+
+void store_u32(std::byte* bytes, uint32_t value)
+{
+    for (std::size_t i = 0; i < sizeof(uint32_t); ++i)
+    {
+        bytes[i] = static_cast<std::byte>(value >> (i * 8));
+    }
+}
+
+uint32_t load_u32(std::byte const* bytes)
+{
+    uint32_t value = 0;
+    for (std::size_t i = 0; i < sizeof(uint32_t); ++i)
+    {
+        value |= std::to_integer<uint32_t>(bytes[i]) << (i * 8);
+    }
+    return value;
+}
+} // namespace
+
+std::string_view codec_name(CompressionCodec codec)
+{
+    switch (codec)
+    {
+    case CompressionCodec::NONE: return "none";
+    case CompressionCodec::LZ4: return "lz4";
+    case CompressionCodec::ZSTD: return "zstd";
+    }
+    return "unknown";
+}
+
+struct ChunkCompressor::ZstdDictionaries
+{
+    ZSTD_CDict* compression = nullptr;
+    ZSTD_DDict* decompression = nullptr;
+
+    ~ZstdDictionaries()
+    {
+        ZSTD_freeCDict(compression);
+        ZSTD_freeDDict(decompression);
+    }
+};
+
+ChunkCompressor::ChunkCompressor(CompressionSettings settings, std::vector<std::byte> dictionary)
+    : m_settings{settings}
+    , m_dictionary{std::move(dictionary)}
+{
+    if (m_dictionary.empty()) return;
+
+    if (ZDICT_getDictID(m_dictionary.data(), m_dictionary.size()) == 0)
+        throw std::invalid_argument("Not a Zstd dictionary");
+
+    int const level = m_settings.codec == CompressionCodec::ZSTD && m_settings.level > 0 ? m_settings.level : ZSTD_CLEVEL_DEFAULT;
+    m_zstd = std::make_unique<ZstdDictionaries>();
+    m_zstd->compression = ZSTD_createCDict(m_dictionary.data(), m_dictionary.size(), level);
+    m_zstd->decompression = ZSTD_createDDict(m_dictionary.data(), m_dictionary.size());
+    if (m_zstd->compression == nullptr || m_zstd->decompression == nullptr)
+        throw std::invalid_argument("Not a Zstd dictionary");
+}
+
+ChunkCompressor::~ChunkCompressor() = default;
+ChunkCompressor::ChunkCompressor(ChunkCompressor&&) noexcept = default;
+ChunkCompressor& ChunkCompressor::operator=(ChunkCompressor&&) noexcept = default;
+
+std::vector<std::byte> ChunkCompressor::trainDictionary(std::span<std::vector<std::byte> const> samples, std::size_t capacity)
+{
+    std::vector<std::byte> buffer;
+    std::vector<std::size_t> sizes;
+    sizes.reserve(samples.size());
+    for (auto const& sample : samples)
+    {
+        buffer.insert(buffer.end(), sample.begin(), sample.end());
+        sizes.push_back(sample.size());
+    }
+
+    std::vector<std::byte> dictionary(capacity);
+    std::size_t const size = ZDICT_trainFromBuffer(dictionary.data(), dictionary.size(), buffer.data(), sizes.data(), static_cast<unsigned>(sizes.size()));
+    if (ZDICT_isError(size))
+        throw std::runtime_error(std::string{"Cannot train a chunk dictionary: "} + ZDICT_getErrorName(size));
+
+    dictionary.resize(size);
+    return dictionary;
+}
+
+ChunkCompressor ChunkCompressor::load(std::filesystem::path const& path)
+{
+    std::ifstream file{path, std::ios::binary};
+    if (!file)
+        throw std::system_error(errno, std::generic_category(), "Cannot open " + path.string());
+    std::vector<std::byte> bytes;
+    std::transform(std::istreambuf_iterator<char>{file}, std::istreambuf_iterator<char>{}, std::back_inserter(bytes),
+        [](char c) { return static_cast<std::byte>(c); });
+    if (file.bad())
+        throw std::system_error(errno, std::generic_category(), "Cannot read " + path.string());
+
+    if (bytes.size() < FILE_HEADER_SIZE || load_u32(bytes.data()) != FILE_MAGIC)
+        throw ChunkFormatError(path.string() + " is not a chunk compression file");
+    if (std::to_integer<uint8_t>(bytes[4]) == 0 || std::to_integer<uint8_t>(bytes[4]) > FILE_VERSION)
+        throw ChunkFormatError(path.string() + " has unsupported version " + std::to_string(std::to_integer<int>(bytes[4])));
+    auto const codec = static_cast<CompressionCodec>(bytes[5]);
+    if (codec_name(codec) == "unknown")
+        throw ChunkFormatError(path.string() + " names unknown codec " + std::to_string(std::to_integer<int>(bytes[5])));
+
+    CompressionSettings const settings{codec, static_cast<int32_t>(load_u32(bytes.data() + 6))};
+    try
+    {
+        return ChunkCompressor{settings, {bytes.begin() + FILE_HEADER_SIZE, bytes.end()}};
+    }
+    catch (std::invalid_argument const& e)
+    {
+        throw ChunkFormatError(path.string() + " holds a corrupt dictionary: " + e.what());
+    }
+}
+
+void ChunkCompressor::store(std::filesystem::path const& path) const
+{
+    std::array<std::byte, FILE_HEADER_SIZE> header{};
+    store_u32(header.data(), FILE_MAGIC);
+    header[4] = static_cast<std::byte>(FILE_VERSION);
+    header[5] = static_cast<std::byte>(m_settings.codec);
+    store_u32(header.data() + 6, static_cast<uint32_t>(m_settings.level));
+
+    // A crash mid-write leaves the previous file, if any, in place
+    auto temporary = path;
+    temporary += ".tmp";
+    {
+        std::ofstream file{temporary, std::ios::binary | std::ios::trunc};
+        file.write(reinterpret_cast<char const*>(header.data()), static_cast<std::streamsize>(header.size()));
+        file.write(reinterpret_cast<char const*>(m_dictionary.data()), static_cast<std::streamsize>(m_dictionary.size()));
+        file.flush();
+        if (!file)
+            throw std::system_error(errno, std::generic_category(), "Cannot write " + temporary.string());
+    }
+    std::filesystem::rename(temporary, path);
+}
+
+void ChunkCompressor::compress(std::span<std::byte const> data, std::vector<std::byte>& out) const
+{
+    if (data.size() > MAX_FRAME_BYTES)
+        throw std::length_error("Chunk data is too large to compress");
+
+    std::size_t const start = out.size();
+    CompressionCodec const codec = m_settings.codec;
+    out.resize(start + FRAME_HEADER_SIZE);
+    out[start] = static_cast<std::byte>(codec);
+    store_u32(out.data() + start + 1, static_cast<uint32_t>(data.size()));
+
+    std::size_t written = 0;
+    switch (codec)
+    {
+    case CompressionCodec::NONE:
+        out.insert(out.end(), data.begin(), data.end());
+        return;
+
+    case CompressionCodec::LZ4:
+    {
+        int const bound = LZ4_compressBound(static_cast<int>(data.size()));
+        out.resize(start + FRAME_HEADER_SIZE + static_cast<std::size_t>(bound));
+        auto const* source = reinterpret_cast<char const*>(data.data());
+        auto* destination = reinterpret_cast<char*>(out.data() + start + FRAME_HEADER_SIZE);
+        int const size = m_settings.level > 0
+            ? LZ4_compress_HC(source, destination, static_cast<int>(data.size()), bound, m_settings.level)
+            : LZ4_compress_default(source, destination, static_cast<int>(data.size()), bound);
+        if (size <= 0)
+            throw std::runtime_error("LZ4 compression failed");
+        written = static_cast<std::size_t>(size);
+        break;
+    }
+
+    case CompressionCodec::ZSTD:
+    {
+        std::size_t const bound = ZSTD_compressBound(data.size());
+        out.resize(start + FRAME_HEADER_SIZE + bound);
+        void* destination = out.data() + start + FRAME_HEADER_SIZE;
+        written = m_zstd
+            ? ZSTD_compress_usingCDict(zstd_compression_context(), destination, bound, data.data(), data.size(), m_zstd->compression)
+            : ZSTD_compressCCtx(zstd_compression_context(), destination, bound, data.data(), data.size(), m_settings.level > 0 ? m_settings.level : ZSTD_CLEVEL_DEFAULT);
+        if (ZSTD_isError(written))
+            throw std::runtime_error(std::string{"Zstd compression failed: "} + ZSTD_getErrorName(written));
+        break;
+    }
+    }
+    out.resize(start + FRAME_HEADER_SIZE + written);
+}
+
+void ChunkCompressor::decompress(std::span<std::byte const> frame, std::vector<std::byte>& out) const
+{
+    if (frame.size() < FRAME_HEADER_SIZE)
+        throw ChunkFormatError("Compressed chunk is truncated");
+
+    auto const codec = static_cast<CompressionCodec>(frame[0]);
+    uint32_t const size = load_u32(frame.data() + 1);
+    if (size > MAX_FRAME_BYTES)
+        throw ChunkFormatError("Compressed chunk announces an oversized chunk");
+
+    auto const payload = frame.subspan(FRAME_HEADER_SIZE);
+    out.resize(size);
+    switch (codec)
+    {
+    case CompressionCodec::NONE:
+        if (payload.size() != size)
+            throw ChunkFormatError("Stored chunk has the wrong size");
+        std::memcpy(out.data(), payload.data(), size);
+        return;
+
+    case CompressionCodec::LZ4:
+    {
+        int const read = LZ4_decompress_safe(reinterpret_cast<char const*>(payload.data()), reinterpret_cast<char*>(out.data()),
+            static_cast<int>(payload.size()), static_cast<int>(size));
+        if (read < 0 || static_cast<uint32_t>(read) != size)
+            throw ChunkFormatError("Corrupt LZ4 chunk");
+        return;
+    }
+
+    case CompressionCodec::ZSTD:
+    {
+        unsigned const dictionaryId = ZSTD_getDictID_fromFrame(payload.data(), payload.size());
+        if (dictionaryId != 0 && dictionaryId != getDictionaryId())
+            throw ChunkFormatError("Chunk was compressed with dictionary " + std::to_string(dictionaryId) + ", which this world does not have");
+
+        std::size_t const read = dictionaryId != 0
+            ? ZSTD_decompress_usingDDict(zstd_decompression_context(), out.data(), out.size(), payload.data(), payload.size(), m_zstd->decompression)
+            : ZSTD_decompressDCtx(zstd_decompression_context(), out.data(), out.size(), payload.data(), payload.size());
+        if (ZSTD_isError(read) || read != size)
+            throw ChunkFormatError("Corrupt Zstd chunk");
+        return;
+    }
+    }
+    throw ChunkFormatError("Unknown chunk compression codec " + std::to_string(std::to_integer<int>(frame[0])));
+}
+
+CompressionSettings const& ChunkCompressor::getSettings() const
+{
+    return m_settings;
+}
+
+std::span<std::byte const> ChunkCompressor::getDictionary() const
+{
+    return m_dictionary;
+}
+
+uint32_t ChunkCompressor::getDictionaryId() const
+{
+    return m_dictionary.empty() ? 0 : ZDICT_getDictID(m_dictionary.data(), m_dictionary.size());
+}
+
+} // namespace mc::world
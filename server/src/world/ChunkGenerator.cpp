@@ -3,68 +3,665 @@
 #include <core/Logger.hpp>
 
 #include <algorithm>
+#include <array>
+#include <cassert>
 #include <cmath>
+#include <cstdlib>
+#include <stdexcept>
+#include <vector>
 
+#include <Magnum/Math/Functions.h>
 #include <Magnum/Math/Vector3.h>
+#include <utils/FastDivFloor.hpp>
+#include <utils/IVec3Hasher.hpp>
 
 namespace mc::world
 {
 
-ChunkGenerator::ChunkGenerator(int32_t seed)
-    : m_noise{seed}
+namespace
+{
+constexpr int OCTAVES = 5;
+constexpr float LACUNARITY = 2.0f;
+constexpr float GAIN = 0.5f;
+constexpr float FREQUENCY = 0.005f;
+constexpr float MODIFIER_SCALE = 0.5f; ///< The modifier noise is sampled at half the world coordinates.
+
+constexpr int DENSITY_OCTAVES = 3;
+constexpr float DENSITY_FREQUENCY = 0.02f;
+constexpr int DENSITY_SEED_OFFSET = 1; ///< Keeps the 3D noise independent from the height noise.
+/// Blocks over which the height gradient changes density by 1, the most the noise can offset.
+/// Blocks further than this below the surface are always solid, above it always air.
+constexpr int DENSITY_RANGE = 24;
+
+/// Continentalness maps to a relief scale from flat coasts to steep inland mountains,
+/// and lifts the terrain by up to CONTINENT_LIFT blocks either way
+constexpr float COAST_RELIEF = 0.5f;
+constexpr float MOUNTAIN_RELIEF = 2.5f;
+constexpr float CONTINENT_LIFT = 16.0f;
+
+constexpr int DIRT_DEPTH = 3; ///< Filler blocks under the top of a surface run.
+/// Solid runs topping out this close below the highest solid block of their column are
+/// surface (overhangs and the ground under them); deeper cave floors stay stone.
+constexpr int SURFACE_BAND = 8;
+
+constexpr int MAX_TREES_PER_CHUNK = 2; ///< Without biomes.
+constexpr BiomeSurface DEFAULT_SURFACE{BlockType::GRASS, BlockType::DIRT, MAX_TREES_PER_CHUNK};
+constexpr int TRUNK_MIN_HEIGHT = 4;
+constexpr int TRUNK_HEIGHT_RANGE = 3;
+constexpr int CANOPY_RADIUS = 2; ///< Reach of the two lower leaf layers around the trunk.
+constexpr int CANOPY_TOP = 2; ///< Leaf layers above the top log.
+static_assert(ChunkGenerator::FEATURE_REACH == 1 && CANOPY_RADIUS < CHUNK_SIZE_X && CANOPY_RADIUS < CHUNK_SIZE_Z, "canopies reach one chunk over at most");
+
+/**
+ * @brief Writes a column of block types from @p firstY up as one fill per run, skipping air.
+ */
+void write_column_runs(Chunk& chunk, int x, int z, int firstY, std::span<BlockType const, CHUNK_SIZE_Y> column)
+{
+    int runStart = firstY;
+    for (int y = firstY + 1; y <= CHUNK_SIZE_Y; ++y)
+    {
+        if (y < CHUNK_SIZE_Y && column[y] == column[runStart])
+            continue;
+        if (column[runStart] != BlockType::AIR)
+            chunk.fillRegion({x, runStart, z}, {x, y - 1, z}, Block{column[runStart]});
+        runStart = y;
+    }
+}
+
+/**
+ * @brief splitmix64 stream seeded per chunk, so features only depend on the world seed
+ * and the position of the chunk they belong to.
+ */
+class FeatureRandom
+{
+public:
+    FeatureRandom(int32_t seed, Magnum::Vector3i const& chunkPos)
+        : m_state{utils::mix64((static_cast<uint64_t>(static_cast<uint32_t>(seed)) << 32) ^ utils::IVec3Hasher{}(chunkPos))}
+    {}
+
+    uint64_t next()
+    {
+        m_state += 0x9e3779b97f4a7c15ULL;
+        return utils::mix64(m_state);
+    }
+
+    int nextInt(int bound)
+    {
+        return static_cast<int>(next() % static_cast<uint64_t>(bound));
+    }
+
+private:
+    uint64_t m_state;
+};
+
+struct Tree
+{
+    int x; ///< Column of the trunk.
+    int y; ///< Lowest log, right above the surface.
+    int z;
+    int trunkHeight;
+};
+
+/**
+ * @brief Trees growing in a chunk, standing on the grass left by the SURFACE stage.
+ */
+std::vector<Tree> plan_trees(int32_t seed, Chunk const& chunk, int maxTrees)
+{
+    std::vector<Tree> trees;
+    FeatureRandom random{seed, chunk.getPosition()};
+    int const attempts = random.nextInt(maxTrees + 1);
+    for (int i = 0; i < attempts; ++i)
+    {
+        // Every attempt draws the same numbers, so a skipped tree does not move the others
+        int const x = random.nextInt(CHUNK_SIZE_X);
+        int const z = random.nextInt(CHUNK_SIZE_Z);
+        int const trunkHeight = TRUNK_MIN_HEIGHT + random.nextInt(TRUNK_HEIGHT_RANGE);
+        int const ground = chunk.getHeight(HeightmapType::HIGHEST_SOLID, x, z);
+        if (ground == NO_HEIGHT || ground + trunkHeight + CANOPY_TOP >= CHUNK_SIZE_Y ||
+            chunk.getBlockUnchecked(x, ground, z).type != BlockType::GRASS)
+            continue;
+        trees.push_back({x, ground + 1, z, trunkHeight});
+    }
+    return trees;
+}
+
+/**
+ * @brief Places a feature block: leaves only fill air, anything else replaces what is there.
+ */
+void place_feature_block(Chunk& chunk, int x, int y, int z, Block block)
+{
+    if (block.type == BlockType::LEAVES && chunk.getBlockUnchecked(x, y, z).type != BlockType::AIR)
+        return;
+    chunk.setBlockUnchecked(x, y, z, block);
+}
+
+/**
+ * @brief Height shaping of a column from its continentalness.
+ */
+struct Relief
+{
+    float scale;
+    float lift;
+};
+
+Relief relief_of(float continentalness)
+{
+    float const inland = std::clamp((continentalness + 1.0f) * 0.5f, 0.0f, 1.0f);
+    float const smooth = inland * inland * (3.0f - 2.0f * inland);
+    return {std::lerp(COAST_RELIEF, MOUNTAIN_RELIEF, smooth), continentalness * CONTINENT_LIFT};
+}
+
+/**
+ * @brief Places the leaves of a tree's canopy, handing those outside the chunk to @p overflow.
+ */
+void place_canopy(Chunk& chunk, Tree const& tree, std::vector<ChunkGenerator::Decoration>& overflow)
+{
+    Block const leaves{BlockType::LEAVES};
+    int const topLog = tree.y + tree.trunkHeight - 1;
+    for (int dy = -1; dy <= CANOPY_TOP; ++dy)
+    {
+        int const radius = dy <= 0 ? CANOPY_RADIUS : 1;
+        int const y = topLog + dy;
+        for (int dz = -radius; dz <= radius; ++dz)
+        {
+            for (int dx = -radius; dx <= radius; ++dx)
+            {
+                // Round the wide layers and the top one off at the corners
+                bool const corner = std::abs(dx) == radius && std::abs(dz) == radius;
+                if (corner && (radius == CANOPY_RADIUS || dy == CANOPY_TOP))
+                    continue;
+
+                int const x = tree.x + dx;
+                int const z = tree.z + dz;
+                int const chunkX = utils::floor_div(x, CHUNK_SIZE_X);
+                int const chunkZ = utils::floor_div(z, CHUNK_SIZE_Z);
+                if (chunkX == 0 && chunkZ == 0)
+                {
+                    place_feature_block(chunk, x, y, z, leaves);
+                    continue;
+                }
+                overflow.push_back({
+                    chunk.getPosition() + Magnum::Vector3i{chunkX, 0, chunkZ},
+                    static_cast<uint8_t>(x - chunkX * CHUNK_SIZE_X),
+                    static_cast<uint8_t>(y),
+                    static_cast<uint8_t>(z - chunkZ * CHUNK_SIZE_Z),
+                    leaves,
+                });
+            }
+        }
+    }
+}
+} // namespace
+
+ChunkGenerator::ChunkGenerator(int32_t seed, NoiseBackend backend)
+    : m_seed{seed}
+    , m_backend{backend}
+    , m_noise{seed}
+    , m_climate{seed}
 {
     m_noise.SetNoiseType(FastNoiseLite::NoiseType_OpenSimplex2);
     m_noise.SetFractalType(FastNoiseLite::FractalType_FBm);
-    m_noise.SetFractalOctaves(5);
-    m_noise.SetFractalLacunarity(2.0f);
-    m_noise.SetFractalGain(0.5f);
-    m_noise.SetFrequency(0.005f);
+    m_noise.SetFractalOctaves(OCTAVES);
+    m_noise.SetFractalLacunarity(LACUNARITY);
+    m_noise.SetFractalGain(GAIN);
+    m_noise.SetFrequency(FREQUENCY);
+
+    auto fractal = FastNoise::New<FastNoise::FractalFBm>();
+    fractal->SetSource(FastNoise::New<FastNoise::OpenSimplex2>());
+    fractal->SetOctaveCount(OCTAVES);
+    fractal->SetLacunarity(LACUNARITY);
+    fractal->SetGain(GAIN);
+    m_gridNoise = fractal;
+
+    m_densityNoise.SetSeed(seed + DENSITY_SEED_OFFSET);
+    m_densityNoise.SetNoiseType(FastNoiseLite::NoiseType_OpenSimplex2);
+    m_densityNoise.SetFractalType(FastNoiseLite::FractalType_FBm);
+    m_densityNoise.SetFractalOctaves(DENSITY_OCTAVES);
+    m_densityNoise.SetFractalLacunarity(LACUNARITY);
+    m_densityNoise.SetFractalGain(GAIN);
+    m_densityNoise.SetFrequency(DENSITY_FREQUENCY);
+
+    auto densityFractal = FastNoise::New<FastNoise::FractalFBm>();
+    densityFractal->SetSource(FastNoise::New<FastNoise::OpenSimplex2>());
+    densityFractal->SetOctaveCount(DENSITY_OCTAVES);
+    densityFractal->SetLacunarity(LACUNARITY);
+    densityFractal->SetGain(GAIN);
+    m_gridDensityNoise = densityFractal;
+}
+
+void ChunkGenerator::setTerrainShape(TerrainShape shape, DensityLattice lattice)
+{
+    if (lattice.x <= 0 || lattice.y <= 0 || lattice.z <= 0 ||
+        CHUNK_SIZE_X % lattice.x != 0 || CHUNK_SIZE_Y % lattice.y != 0 || CHUNK_SIZE_Z % lattice.z != 0)
+    {
+        throw std::invalid_argument("Density lattice spacing must divide the chunk size");
+    }
+
+    m_shape = shape;
+    m_lattice = lattice;
+}
+
+TerrainShape ChunkGenerator::getTerrainShape() const
+{
+    return m_shape;
+}
+
+DensityLattice const& ChunkGenerator::getDensityLattice() const
+{
+    return m_lattice;
+}
+
+int ChunkGenerator::getDensitySamplesPerChunk() const
+{
+    return (CHUNK_SIZE_X / m_lattice.x + 1) * (CHUNK_SIZE_Y / m_lattice.y + 1) * (CHUNK_SIZE_Z / m_lattice.z + 1);
+}
+
+uint64_t ChunkGenerator::getDensitySampleCount() const
+{
+    return m_densitySamples.load(std::memory_order_relaxed);
+}
+
+void ChunkGenerator::setBiomesEnabled(bool enabled)
+{
+    m_biomes = enabled;
+}
+
+bool ChunkGenerator::areBiomesEnabled() const
+{
+    return m_biomes;
+}
+
+Biome ChunkGenerator::getBiome(int worldX, int worldZ) const
+{
+    return biome_of(m_climate.sampleAt(worldX, worldZ));
+}
+
+ClimateMap const& ChunkGenerator::getClimateMap() const
+{
+    return m_climate;
 }
 
 Chunk ChunkGenerator::generate(Magnum::Vector3i const& chunkPos) const
 {
     Chunk chunk{chunkPos};
-    Magnum::Vector3i const origin = chunkPos * Magnum::Vector3i{CHUNK_SIZE_X, 0, CHUNK_SIZE_Z};
+    generate(chunk);
+    return chunk;
+}
 
-    for (int x = 0; x < CHUNK_SIZE_X; ++x)
+void ChunkGenerator::generate(Chunk& chunk) const
+{
+    Magnum::Vector3i const origin = chunk.getPosition() * Magnum::Vector3i{CHUNK_SIZE_X, 0, CHUNK_SIZE_Z};
+
+    // Column heights, x fastest
+    std::array<int, CHUNK_SLICE_AREA> heights;
+    sampleHeights(origin.x(), origin.z(), CHUNK_SIZE_X, CHUNK_SIZE_Z, heights);
+    fillChunk(chunk, heights);
+    generateSurface(chunk);
+}
+
+void ChunkGenerator::generateRegion(std::span<Chunk* const> chunks) const
+{
+    if (chunks.size() == 1)
     {
+        generate(*chunks.front());
+        return;
+    }
+    if (chunks.empty())
+        return;
+
+    Magnum::Vector3i minChunk = chunks.front()->getPosition();
+    Magnum::Vector3i maxChunk = minChunk;
+    for (auto const* chunk : chunks)
+    {
+        minChunk = Magnum::Math::min(minChunk, chunk->getPosition());
+        maxChunk = Magnum::Math::max(maxChunk, chunk->getPosition());
+    }
+
+    int const sizeX = (maxChunk.x() - minChunk.x() + 1) * CHUNK_SIZE_X;
+    int const sizeZ = (maxChunk.z() - minChunk.z() + 1) * CHUNK_SIZE_Z;
+    std::vector<int> regionHeights(static_cast<std::size_t>(sizeX) * sizeZ);
+    sampleHeights(minChunk.x() * CHUNK_SIZE_X, minChunk.z() * CHUNK_SIZE_Z, sizeX, sizeZ, regionHeights);
+
+    std::array<int, CHUNK_SLICE_AREA> heights;
+    for (auto* chunk : chunks)
+    {
+        int const offsetX = (chunk->getPosition().x() - minChunk.x()) * CHUNK_SIZE_X;
+        int const offsetZ = (chunk->getPosition().z() - minChunk.z()) * CHUNK_SIZE_Z;
         for (int z = 0; z < CHUNK_SIZE_Z; ++z)
         {
-            int const wx = origin.x() + x;
-            int const wz = origin.z() + z;
+            auto const row = regionHeights.begin() + static_cast<std::ptrdiff_t>(offsetZ + z) * sizeX + offsetX;
+            std::copy_n(row, CHUNK_SIZE_X, heights.begin() + z * CHUNK_SIZE_X);
+        }
+        fillChunk(*chunk, heights);
+        generateSurface(*chunk);
+    }
+}
+
+void ChunkGenerator::fillChunk(Chunk& chunk, std::span<int const, CHUNK_SLICE_AREA> heights) const
+{
+    if (m_shape == TerrainShape::DENSITY)
+        fillDensityTerrain(chunk, heights);
+    else
+        fillTerrain(chunk, heights);
+}
+
+void ChunkGenerator::fillTerrain(Chunk& chunk, std::span<int const, CHUNK_SLICE_AREA> heights)
+{
+    int const minHeight = *std::ranges::min_element(heights);
+
+    // Every column is stone up to its height and air above. Sections below the lowest
+    // height are uniformly stone and the slices above them up to it are stone too, so
+    // only the band above is left for per-column runs. Air is never written, the chunk
+    // starts out empty.
+    int const stoneSections = std::max(0, (minHeight + 1) / SECTION_SIZE);
+    for (int sectionIndex = 0; sectionIndex < stoneSections; ++sectionIndex)
+    {
+        chunk.fillSection(sectionIndex, Block{BlockType::STONE});
+    }
+
+    int const bandBottom = stoneSections * SECTION_SIZE;
+    if (minHeight >= bandBottom)
+    {
+        chunk.fillRegion({0, bandBottom, 0}, {CHUNK_SIZE_X - 1, minHeight, CHUNK_SIZE_Z - 1}, Block{BlockType::STONE});
+    }
+
+    int const runBottom = std::max(bandBottom, minHeight + 1);
+    for (int z = 0; z < CHUNK_SIZE_Z; ++z)
+    {
+        for (int x = 0; x < CHUNK_SIZE_X; ++x)
+        {
+            int const height = heights[z * CHUNK_SIZE_X + x];
+            if (height >= runBottom)
+                chunk.fillRegion({x, runBottom, z}, {x, height, z}, Block{BlockType::STONE});
+        }
+    }
+}
+
+void ChunkGenerator::fillDensityTerrain(Chunk& chunk, std::span<int const, CHUNK_SLICE_AREA> heights) const
+{
+    Magnum::Vector3i const origin = chunk.getPosition() * Magnum::Vector3i{CHUNK_SIZE_X, 0, CHUNK_SIZE_Z};
+    auto const [minIt, maxIt] = std::ranges::minmax_element(heights);
 
-            // Base noise defines a general terrain shape
-            float const baseNoise = m_noise.GetNoise(static_cast<float>(wx), static_cast<float>(wz));
+    // density = (height - y) / DENSITY_RANGE + noise, with noise in [-1, 1], so only the
+    // lattice levels around the surface band can change anything
+    int const bandBottom = std::clamp(*minIt - DENSITY_RANGE, 0, CHUNK_SIZE_Y - 1);
+    int const bandTop = std::clamp(*maxIt + DENSITY_RANGE, 0, CHUNK_SIZE_Y - 1);
+    int const minLevel = bandBottom / m_lattice.y;
+    int const maxLevel = bandTop / m_lattice.y + 1;
 
-            // Shape it (curve + preserve sign) to get a softer terrain profile
-            float const shaped = std::pow(std::abs(baseNoise), 0.8f) *
-                (baseNoise < 0.0f ? -1.0f : 1.0f);
+    int const pointsX = CHUNK_SIZE_X / m_lattice.x + 1;
+    int const pointsZ = CHUNK_SIZE_Z / m_lattice.z + 1;
+    int const levels = maxLevel - minLevel + 1;
+    std::vector<float> lattice(static_cast<std::size_t>(pointsX) * pointsZ * levels);
+    sampleDensityLattice(origin, minLevel, maxLevel, lattice);
 
-            // Secondary modifier to add variability and smooth blending
-            float const modNoise = m_noise.GetNoise(wx * 0.5f, wz * 0.5f);
-            float const modifier = std::clamp(modNoise + 0.5f, 0.0f, 1.0f);
+    // Everything below the band is stone: whole sections, then whole slices
+    int const stoneSections = bandBottom / SECTION_SIZE;
+    for (int sectionIndex = 0; sectionIndex < stoneSections; ++sectionIndex)
+    {
+        chunk.fillSection(sectionIndex, Block{BlockType::STONE});
+    }
+    if (bandBottom > stoneSections * SECTION_SIZE)
+    {
+        chunk.fillRegion({0, stoneSections * SECTION_SIZE, 0}, {CHUNK_SIZE_X - 1, bandBottom - 1, CHUNK_SIZE_Z - 1}, Block{BlockType::STONE});
+    }
 
-            // Final height calculation, scaled and biased
-            int const height = static_cast<int>(shaped * modifier * 24.0f + 64.0f);
+    std::vector<float> columnNoise(levels);
+    std::array<BlockType, CHUNK_SIZE_Y> column;
+    for (int z = 0; z < CHUNK_SIZE_Z; ++z)
+    {
+        int const cellZ = z / m_lattice.z;
+        float const tz = static_cast<float>(z % m_lattice.z) / static_cast<float>(m_lattice.z);
+        for (int x = 0; x < CHUNK_SIZE_X; ++x)
+        {
+            int const cellX = x / m_lattice.x;
+            float const tx = static_cast<float>(x % m_lattice.x) / static_cast<float>(m_lattice.x);
 
-            for (int y = 0; y < CHUNK_SIZE_Y; ++y)
+            // Bilinear in x and z once per level, then linear in y per block
+            for (int level = 0; level < levels; ++level)
             {
-                using enum BlockType;
-                auto type = AIR;
+                auto const point = [&](int px, int pz) {
+                    return lattice[(static_cast<std::size_t>(level) * pointsZ + pz) * pointsX + px];
+                };
+                float const front = std::lerp(point(cellX, cellZ), point(cellX + 1, cellZ), tx);
+                float const back = std::lerp(point(cellX, cellZ + 1), point(cellX + 1, cellZ + 1), tx);
+                columnNoise[level] = std::lerp(front, back, tz);
+            }
+
+            int const height = heights[z * CHUNK_SIZE_X + x];
+            std::fill(column.begin() + bandTop + 1, column.end(), BlockType::AIR);
+            for (int y = bandBottom; y <= bandTop; ++y)
+            {
+                int const level = y / m_lattice.y - minLevel;
+                float const ty = static_cast<float>(y % m_lattice.y) / static_cast<float>(m_lattice.y);
+                float const noise = std::lerp(columnNoise[level], columnNoise[level + 1], ty);
+                float const density = static_cast<float>(height - y) / DENSITY_RANGE + noise;
+                column[y] = density > 0.0f ? BlockType::STONE : BlockType::AIR;
+            }
 
-                if (y == height)
-                    type = GRASS;
-                else if (y > height - 4 && y < height)
-                    type = DIRT;
-                else if (y < height)
-                    type = STONE;
+            write_column_runs(chunk, x, z, bandBottom, column);
+        }
+    }
+}
 
-                chunk.setBlock(x, y, z, Block{type});
+void ChunkGenerator::generateSurface(Chunk& chunk) const
+{
+    std::array<Climate, CHUNK_SLICE_AREA> climates;
+    if (m_biomes)
+    {
+        Magnum::Vector3i const origin = chunk.getPosition() * Magnum::Vector3i{CHUNK_SIZE_X, 0, CHUNK_SIZE_Z};
+        m_climate.sample(origin.x(), origin.z(), CHUNK_SIZE_X, CHUNK_SIZE_Z, climates);
+    }
+
+    std::array<ColumnMask, CHUNK_SLICE_AREA> solid;
+    chunk.buildColumnMasks(BlockFlag::SOLID, solid);
+    auto const isSolid = [](ColumnMask const& mask, int y) {
+        return y >= 0 && ((mask[static_cast<std::size_t>(y) / 64] >> (y % 64)) & 1) != 0;
+    };
+
+    for (int z = 0; z < CHUNK_SIZE_Z; ++z)
+    {
+        for (int x = 0; x < CHUNK_SIZE_X; ++x)
+        {
+            auto const& mask = solid[z * CHUNK_SIZE_X + x];
+            BiomeSurface const surface = m_biomes ? biome_surface(biome_of(climates[z * CHUNK_SIZE_X + x])) : DEFAULT_SURFACE;
+            int const top = chunk.getHeight(HeightmapType::HIGHEST_SOLID, x, z);
+            for (int y = top; y >= std::max(0, top - SURFACE_BAND); --y)
+            {
+                // Only the tops of solid runs
+                if (!isSolid(mask, y) || (y + 1 < CHUNK_SIZE_Y && isSolid(mask, y + 1)))
+                    continue;
+
+                chunk.setBlockUnchecked(x, y, z, Block{surface.top});
+                int fillerBottom = y;
+                while (fillerBottom > y - DIRT_DEPTH && isSolid(mask, fillerBottom - 1))
+                    --fillerBottom;
+                if (fillerBottom < y)
+                    chunk.fillRegion({x, fillerBottom, z}, {x, y - 1, z}, Block{surface.filler});
             }
         }
     }
+}
 
-    return chunk;
+void ChunkGenerator::generateFeatures(Chunk& chunk, std::vector<Decoration>& overflow) const
+{
+    // Trees are planned before any is placed, so none stands on another's leaves
+    int maxTrees = MAX_TREES_PER_CHUNK;
+    if (m_biomes)
+    {
+        Magnum::Vector3i const origin = chunk.getPosition() * Magnum::Vector3i{CHUNK_SIZE_X, 0, CHUNK_SIZE_Z};
+        maxTrees = biome_surface(getBiome(origin.x() + CHUNK_SIZE_X / 2, origin.z() + CHUNK_SIZE_Z / 2)).maxTrees;
+    }
+    auto const trees = plan_trees(m_seed, chunk, maxTrees);
+
+    // All leaves before any log, so trunks win wherever they meet another tree's canopy
+    for (auto const& tree : trees)
+    {
+        place_canopy(chunk, tree, overflow);
+    }
+    for (auto const& tree : trees)
+    {
+        chunk.fillRegion({tree.x, tree.y, tree.z}, {tree.x, tree.y + tree.trunkHeight - 1, tree.z}, Block{BlockType::LOG});
+    }
+}
+
+uint32_t ChunkGenerator::decorationSourceBit(Magnum::Vector3i const& offset)
+{
+    assert(std::abs(offset.x()) <= FEATURE_REACH && std::abs(offset.z()) <= FEATURE_REACH);
+    constexpr int SIDE = 2 * FEATURE_REACH + 1;
+    return 1u << ((offset.z() + FEATURE_REACH) * SIDE + offset.x() + FEATURE_REACH);
+}
+
+void ChunkGenerator::applyDecorations(Chunk& chunk, std::span<Decoration const> decorations)
+{
+    for (auto const& decoration : decorations)
+    {
+        assert(decoration.chunkPos == chunk.getPosition());
+        place_feature_block(chunk, decoration.x, decoration.y, decoration.z, decoration.block);
+    }
+}
+
+void ChunkGenerator::sampleDensityLattice(Magnum::Vector3i const& origin, int minLevel, int maxLevel, std::span<float> out) const
+{
+    int const pointsX = CHUNK_SIZE_X / m_lattice.x + 1;
+    int const pointsZ = CHUNK_SIZE_Z / m_lattice.z + 1;
+    assert(out.size() == static_cast<std::size_t>(pointsX) * pointsZ * (maxLevel - minLevel + 1));
+    m_densitySamples.fetch_add(out.size(), std::memory_order_relaxed);
+
+    if (m_backend == NoiseBackend::FAST_NOISE_LITE)
+    {
+        std::size_t i = 0;
+        for (int level = minLevel; level <= maxLevel; ++level)
+        {
+            for (int pz = 0; pz < pointsZ; ++pz)
+            {
+                for (int px = 0; px < pointsX; ++px)
+                {
+                    out[i++] = m_densityNoise.GetNoise(
+                        static_cast<float>(origin.x() + px * m_lattice.x),
+                        static_cast<float>(level * m_lattice.y),
+                        static_cast<float>(origin.z() + pz * m_lattice.z));
+                }
+            }
+        }
+        return;
+    }
+
+    // The lattice is not uniform across axes, so it goes through a position array;
+    // positions are pre-scaled since only grids apply a frequency
+    std::vector<float> xs(out.size());
+    std::vector<float> ys(out.size());
+    std::vector<float> zs(out.size());
+    std::size_t i = 0;
+    for (int level = minLevel; level <= maxLevel; ++level)
+    {
+        for (int pz = 0; pz < pointsZ; ++pz)
+        {
+            for (int px = 0; px < pointsX; ++px, ++i)
+            {
+                xs[i] = static_cast<float>(origin.x() + px * m_lattice.x) * DENSITY_FREQUENCY;
+                ys[i] = static_cast<float>(level * m_lattice.y) * DENSITY_FREQUENCY;
+                zs[i] = static_cast<float>(origin.z() + pz * m_lattice.z) * DENSITY_FREQUENCY;
+            }
+        }
+    }
+    m_gridDensityNoise->GenPositionArray3D(out.data(), static_cast<int>(out.size()), xs.data(), ys.data(), zs.data(), 0.0f, 0.0f, 0.0f, m_seed + DENSITY_SEED_OFFSET);
+}
+
+void ChunkGenerator::sampleHeights(int worldX, int worldZ, int sizeX, int sizeZ, std::span<int> out) const
+{
+    sampleHeightGrid(worldX, worldZ, 1, sizeX, sizeZ, out);
+}
+
+void ChunkGenerator::sampleHeightGrid(int worldX, int worldZ, int step, int sizeX, int sizeZ, std::span<int> out, std::span<BlockType> surface) const
+{
+    assert(out.size() == static_cast<std::size_t>(sizeX) * sizeZ);
+    assert(surface.empty() || surface.size() == out.size());
+    assert(step == 1 || (step % ClimateMap::RESOLUTION == 0 && worldX % step == 0 && worldZ % step == 0));
+
+    // Reused across calls, since generation workers sample heights for every chunk they build
+    thread_local std::vector<float> baseNoise;
+    thread_local std::vector<float> modNoise;
+    baseNoise.resize(out.size());
+    modNoise.resize(out.size());
+    if (m_backend == NoiseBackend::FAST_NOISE_LITE)
+    {
+        for (int z = 0; z < sizeZ; ++z)
+        {
+            for (int x = 0; x < sizeX; ++x)
+            {
+                std::size_t const i = static_cast<std::size_t>(z) * sizeX + x;
+                int const columnX = worldX + x * step;
+                int const columnZ = worldZ + z * step;
+
+                // Base noise defines a general terrain shape
+                baseNoise[i] = m_noise.GetNoise(static_cast<float>(columnX), static_cast<float>(columnZ));
+
+                // Secondary modifier to add variability and smooth blending
+                modNoise[i] = m_noise.GetNoise(columnX * MODIFIER_SCALE, columnZ * MODIFIER_SCALE);
+            }
+        }
+    }
+    else
+    {
+        // A uniform grid samples (start + i) * frequency, so halving the frequency
+        // gives the modifier noise at half the world coordinates, and scaling it by the
+        // step gives every step-th column
+        float const frequency = FREQUENCY * static_cast<float>(step);
+        m_gridNoise->GenUniformGrid2D(baseNoise.data(), worldX / step, worldZ / step, sizeX, sizeZ, frequency, m_seed);
+        m_gridNoise->GenUniformGrid2D(modNoise.data(), worldX / step, worldZ / step, sizeX, sizeZ, frequency * MODIFIER_SCALE, m_seed);
+    }
+
+    if (!m_biomes)
+    {
+        for (std::size_t i = 0; i < out.size(); ++i)
+        {
+            out[i] = shapeHeight(baseNoise[i], modNoise[i]);
+        }
+        std::ranges::fill(surface, DEFAULT_SURFACE.top);
+        return;
+    }
+
+    thread_local std::vector<Climate> climates;
+    climates.resize(out.size());
+    if (step == 1)
+    {
+        m_climate.sample(worldX, worldZ, sizeX, sizeZ, climates);
+    }
+    else
+    {
+        for (int z = 0; z < sizeZ; ++z)
+        {
+            for (int x = 0; x < sizeX; ++x)
+            {
+                climates[static_cast<std::size_t>(z) * sizeX + x] = m_climate.sampleCoarse(worldX + x * step, worldZ + z * step);
+            }
+        }
+    }
+    for (std::size_t i = 0; i < out.size(); ++i)
+    {
+        auto const [scale, lift] = relief_of(climates[i].continentalness);
+        out[i] = shapeHeight(baseNoise[i], modNoise[i], scale, lift);
+        if (!surface.empty())
+            surface[i] = biome_surface(biome_of(climates[i])).top;
+    }
+}
+
+NoiseBackend ChunkGenerator::getBackend() const
+{
+    return m_backend;
+}
+
+int ChunkGenerator::shapeHeight(float baseNoise, float modNoise, float relief, float lift)
+{
+    // Shape it (curve + preserve sign) to get a softer terrain profile
+    float const shaped = std::pow(std::abs(baseNoise), 0.8f) *
+        (baseNoise < 0.0f ? -1.0f : 1.0f);
+
+    float const modifier = std::clamp(modNoise + 0.5f, 0.0f, 1.0f);
+
+    // Final height calculation, scaled and biased
+    return static_cast<int>(shaped * modifier * 24.0f * relief + 64.0f + lift);
 }
 
 } // namespace mc::world
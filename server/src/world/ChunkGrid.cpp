@@ -0,0 +1,52 @@
+#include "world/ChunkGrid.hpp"
+
+#include <bit>
+#include <limits>
+
+namespace mc::world
+{
+
+void ChunkGrid::recenter(Magnum::Vector3i const& center, int radius, ChunkMap const& chunks)
+{
+    if (radius != m_radius)
+    {
+        m_radius = radius;
+        m_width = static_cast<int>(std::bit_ceil(static_cast<unsigned>(2 * radius + 1)));
+        m_mask = m_width - 1;
+
+        // Invalidate every slot so all of them get refilled below
+        Magnum::Vector3i const nowhere{std::numeric_limits<int>::min()};
+        m_slots.assign(static_cast<std::size_t>(m_width) * m_width, Slot{nowhere, nullptr});
+    }
+    m_center = center;
+
+    for (int z = center.z() - radius; z <= center.z() + radius; ++z)
+    {
+        for (int x = center.x() - radius; x <= center.x() + radius; ++x)
+        {
+            Magnum::Vector3i const pos{x, 0, z};
+            Slot& slot = m_slots[slotIndex(pos)];
+            if (slot.position == pos)
+                continue;
+
+            auto it = chunks.find(pos);
+            slot = Slot{pos, it != chunks.end() ? it->second : nullptr};
+        }
+    }
+}
+
+void ChunkGrid::set(Magnum::Vector3i const& chunkPos, Chunk* chunk)
+{
+    if (m_slots.empty())
+        return;
+
+    // A slot the window left still holds its position until recenter() reuses it, and
+    // would be trusted as is if the window came back
+    Slot& slot = m_slots[slotIndex(chunkPos)];
+    if (covers(chunkPos) || slot.position == chunkPos)
+    {
+        slot.chunk = chunk;
+    }
+}
+
+} // namespace mc::world
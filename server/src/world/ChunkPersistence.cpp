@@ -0,0 +1,328 @@
+#include "world/ChunkPersistence.hpp"
+
+#include "world/ChunkSerializer.hpp"
+
+#include <algorithm>
+#include <exception>
+#include <iterator>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <utility>
+
+#include <core/Logger.hpp>
+
+namespace mc::world
+{
+
+namespace
+{
+/**
+ * @brief Compressor stored in @p directory, which is given @p settings and @p dictionary
+ * first if it has none.
+ */
+ChunkCompressor open_compressor(std::filesystem::path const& directory, CompressionSettings settings, std::vector<std::byte> dictionary)
+{
+    auto const path = directory / ChunkPersistence::COMPRESSION_FILE;
+    if (!std::filesystem::exists(path))
+    {
+        std::filesystem::create_directories(directory);
+        ChunkCompressor{settings, std::move(dictionary)}.store(path);
+        return ChunkCompressor::load(path);
+    }
+
+    ChunkCompressor compressor = ChunkCompressor::load(path);
+    auto const stored = compressor.getDictionary();
+    if (!dictionary.empty() && !std::ranges::equal(dictionary, stored))
+        throw std::invalid_argument("Chunks in " + directory.string() + " are compressed with another dictionary");
+    if (settings.codec != compressor.getSettings().codec || settings.level != compressor.getSettings().level)
+    {
+        LOG(INFO, "Chunks in {} keep their stored compression, {} at level {}", directory.string(),
+            codec_name(compressor.getSettings().codec), compressor.getSettings().level);
+    }
+    return compressor;
+}
+} // namespace
+
+ChunkPersistence::ChunkPersistence(
+    std::filesystem::path directory,
+    std::shared_ptr<concurrencpp::thread_pool_executor> ioExecutor,
+    CompressionSettings compression,
+    std::vector<std::byte> dictionary,
+    std::size_t batchSize)
+    : m_storage{std::move(directory)}
+    , m_compressor{open_compressor(m_storage.getDirectory(), compression, std::move(dictionary))}
+    , m_ioExecutor{std::move(ioExecutor)}
+    , m_batchSize{std::max<std::size_t>(1, batchSize)}
+{
+}
+
+ChunkPersistence::~ChunkPersistence()
+{
+    try
+    {
+        wait();
+    }
+    catch (std::exception const& e)
+    {
+        LOG(ERROR, "Could not write every saved chunk of {}: {}", getDirectory().string(), e.what());
+    }
+}
+
+void ChunkPersistence::save(Chunk chunk, std::vector<ChunkGenerator::Decoration> decorations, uint32_t decoratedBy)
+{
+    Magnum::Vector3i const chunkPos = chunk.getPosition();
+    Pending pending{
+        std::make_shared<SavedChunk const>(SavedChunk{std::move(chunk), std::move(decorations), decoratedBy}),
+        ++m_lastVersion,
+        std::chrono::steady_clock::now(),
+    };
+    {
+        std::lock_guard lock{m_pendingMutex};
+        m_pending.insert_or_assign(chunkPos, pending);
+    }
+    m_queued.push_back(std::move(pending));
+    m_saved.fetch_add(1, std::memory_order_relaxed);
+
+    if (m_queued.size() >= m_batchSize)
+        flush();
+}
+
+void ChunkPersistence::flush()
+{
+    {
+        std::lock_guard lock{m_pendingMutex};
+        std::ranges::move(m_retries, std::back_inserter(m_queued));
+        m_retries.clear();
+    }
+    if (m_queued.empty())
+        return;
+
+    m_batches.push_back(m_ioExecutor->submit([this, batch = std::move(m_queued)] {
+        SPAM_LOG(DEBUG, "Writing {} chunk(s) on thread {}", batch.size(), std::this_thread::get_id());
+        writeBatch(batch);
+    }));
+    m_queued.clear();
+}
+
+void ChunkPersistence::collect()
+{
+    std::erase_if(m_batches, [this](concurrencpp::result<void>& batch) {
+        if (batch.status() == concurrencpp::result_status::idle)
+            return false;
+
+        try
+        {
+            batch.get();
+        }
+        catch (std::exception const& e)
+        {
+            LOG(ERROR, "Writing chunks into {} failed: {}", getDirectory().string(), e.what());
+        }
+        return true;
+    });
+
+    bool retry = false;
+    {
+        std::lock_guard lock{m_pendingMutex};
+        retry = !m_retries.empty();
+    }
+    if (retry)
+        flush();
+}
+
+void ChunkPersistence::sync()
+{
+    flush();
+    m_batches.push_back(m_ioExecutor->submit([this] {
+        std::lock_guard writeLock{m_writeMutex};
+        m_storage.sync();
+    }));
+}
+
+void ChunkPersistence::wait()
+{
+    // Batches queue their failed saves again, each a bounded number of times
+    bool retry = true;
+    while (retry)
+    {
+        flush();
+        for (auto& batch : m_batches)
+        {
+            try
+            {
+                batch.get();
+            }
+            catch (std::exception const& e)
+            {
+                LOG(ERROR, "Writing chunks into {} failed: {}", getDirectory().string(), e.what());
+            }
+        }
+        m_batches.clear();
+
+        std::lock_guard lock{m_pendingMutex};
+        retry = !m_retries.empty();
+    }
+
+    {
+        std::lock_guard writeLock{m_writeMutex};
+        m_storage.sync();
+    }
+
+    // Every save handed over is written by now, unless it was given up on
+    std::size_t unwritten = 0;
+    {
+        std::lock_guard lock{m_pendingMutex};
+        unwritten = m_pending.size();
+    }
+    if (unwritten > 0)
+        throw std::runtime_error(std::to_string(unwritten) + " saved chunk(s) could not be written into " + getDirectory().string());
+}
+
+void ChunkPersistence::writeBatch(std::span<Pending const> batch)
+{
+    // Encoding does not need the write lock, so batches encode in parallel
+    std::vector<std::vector<std::byte>> frames(batch.size());
+    std::vector<std::byte> encoded;
+    for (std::size_t i = 0; i < batch.size(); ++i)
+    {
+        auto const& saved = *batch[i].saved;
+        if (!isLatest(batch[i]))
+        {
+            m_superseded.fetch_add(1, std::memory_order_relaxed);
+            continue;
+        }
+
+        try
+        {
+            encoded.clear();
+            ChunkSerializer::encode(saved.chunk, encoded, saved.decorations, saved.decoratedBy);
+            m_compressor.compress(encoded, frames[i]);
+        }
+        catch (std::exception const& e)
+        {
+            LOG(ERROR, "Could not encode chunk [{}, {}]: {}", saved.chunk.getPosition().x(), saved.chunk.getPosition().z(), e.what());
+            frames[i].clear();
+            retryLater(batch[i]);
+        }
+    }
+
+    std::lock_guard writeLock{m_writeMutex};
+    for (std::size_t i = 0; i < batch.size(); ++i)
+    {
+        auto const& pending = batch[i];
+        Magnum::Vector3i const chunkPos = pending.saved->chunk.getPosition();
+
+        if (frames[i].empty())
+            continue;
+
+        // A later save may have been written already; this one must not overwrite it
+        if (!isLatest(pending))
+        {
+            m_superseded.fetch_add(1, std::memory_order_relaxed);
+            continue;
+        }
+
+        try
+        {
+            m_storage.write(chunkPos, frames[i]);
+        }
+        catch (std::exception const& e)
+        {
+            LOG(ERROR, "Could not save chunk [{}, {}]: {}", chunkPos.x(), chunkPos.z(), e.what());
+            retryLater(pending);
+            continue;
+        }
+
+        {
+            std::lock_guard lock{m_pendingMutex};
+            if (auto it = m_pending.find(chunkPos); it != m_pending.end() && it->second.version == pending.version)
+                m_pending.erase(it);
+        }
+        m_written.fetch_add(1, std::memory_order_relaxed);
+        m_bytesWritten.fetch_add(frames[i].size(), std::memory_order_relaxed);
+        m_writeLatency.record(std::chrono::steady_clock::now() - pending.since);
+    }
+    m_batchesWritten.fetch_add(1, std::memory_order_relaxed);
+}
+
+void ChunkPersistence::retryLater(Pending pending)
+{
+    if (++pending.attempts >= MAX_WRITE_ATTEMPTS)
+    {
+        Magnum::Vector3i const chunkPos = pending.saved->chunk.getPosition();
+        LOG(ERROR, "Giving up on saving chunk [{}, {}] after {} attempts; it stays in memory", chunkPos.x(), chunkPos.z(), pending.attempts);
+        m_failed.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+
+    m_retried.fetch_add(1, std::memory_order_relaxed);
+    std::lock_guard lock{m_pendingMutex};
+    m_retries.push_back(std::move(pending));
+}
+
+bool ChunkPersistence::isLatest(Pending const& pending) const
+{
+    std::lock_guard lock{m_pendingMutex};
+    auto it = m_pending.find(pending.saved->chunk.getPosition());
+    return it != m_pending.end() && it->second.version == pending.version;
+}
+
+std::shared_ptr<ChunkPersistence::SavedChunk const> ChunkPersistence::findPending(Magnum::Vector3i const& chunkPos) const
+{
+    std::lock_guard lock{m_pendingMutex};
+    auto it = m_pending.find(chunkPos);
+    return it != m_pending.end() ? it->second.saved : nullptr;
+}
+
+bool ChunkPersistence::isStored(Magnum::Vector3i const& chunkPos)
+{
+    return m_storage.contains(chunkPos);
+}
+
+bool ChunkPersistence::load(Magnum::Vector3i const& chunkPos, Chunk& chunk, std::vector<ChunkGenerator::Decoration>& decorations, uint32_t& decoratedBy)
+{
+    // Decompressed straight from the mapping of the region file
+    thread_local std::vector<std::byte> encoded;
+    if (!m_storage.visit(chunkPos, [this](std::span<std::byte const> frame) { m_compressor.decompress(frame, encoded); }))
+        return false;
+
+    ChunkSerializer::decode(encoded, chunk, decorations, decoratedBy);
+    if (chunk.getPosition() != chunkPos)
+        throw ChunkFormatError("Region file holds another chunk in the place of the requested one");
+    return true;
+}
+
+ChunkPersistence::Stats ChunkPersistence::getStats() const
+{
+    Stats stats;
+    stats.saved = m_saved.load(std::memory_order_relaxed);
+    stats.written = m_written.load(std::memory_order_relaxed);
+    stats.superseded = m_superseded.load(std::memory_order_relaxed);
+    stats.retried = m_retried.load(std::memory_order_relaxed);
+    stats.failed = m_failed.load(std::memory_order_relaxed);
+    stats.batches = m_batchesWritten.load(std::memory_order_relaxed);
+    stats.bytesWritten = m_bytesWritten.load(std::memory_order_relaxed);
+    {
+        std::lock_guard lock{m_pendingMutex};
+        stats.pending = m_pending.size();
+    }
+    return stats;
+}
+
+utils::LatencyHistogram const& ChunkPersistence::getWriteLatency() const
+{
+    return m_writeLatency;
+}
+
+std::filesystem::path const& ChunkPersistence::getDirectory() const
+{
+    return m_storage.getDirectory();
+}
+
+ChunkCompressor const& ChunkPersistence::getCompressor() const
+{
+    return m_compressor;
+}
+
+} // namespace mc::world
@@ -0,0 +1,50 @@
+#include "world/ChunkPool.hpp"
+
+#include <cassert>
+
+namespace mc::world
+{
+
+ChunkPool::ChunkPool(std::size_t slabSize)
+    : m_slabSize{slabSize}
+{}
+
+Chunk* ChunkPool::acquire(Magnum::Vector3i const& position)
+{
+    ++m_stats.acquisitions;
+    ++m_stats.inUse;
+
+    if (!m_freeList.empty())
+    {
+        Chunk* chunk = m_freeList.back();
+        m_freeList.pop_back();
+        chunk->reset(position);
+        ++m_stats.reuses;
+        return chunk;
+    }
+
+    if (m_slabs.empty() || m_slabs.back().size() == m_slabSize)
+    {
+        m_slabs.emplace_back().reserve(m_slabSize);
+    }
+
+    // The slab never exceeds its reserved capacity, so earlier chunks are never relocated
+    ++m_stats.capacity;
+    return &m_slabs.back().emplace_back(position);
+}
+
+void ChunkPool::release(Chunk* chunk)
+{
+    assert(chunk != nullptr);
+    assert(m_stats.inUse > 0);
+
+    --m_stats.inUse;
+    m_freeList.push_back(chunk);
+}
+
+ChunkPool::Stats const& ChunkPool::getStats() const
+{
+    return m_stats;
+}
+
+} // namespace mc::world
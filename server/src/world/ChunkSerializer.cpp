@@ -1,9 +1,350 @@
 #include "world/ChunkSerializer.hpp"
 
-#include <core/Logger.hpp>
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <bitset>
+#include <cassert>
+#include <string>
+#include <type_traits>
 
 namespace mc::world
 {
 
-} // namespace mc::world
+namespace
+{
+static_assert(CHUNK_SECTION_COUNT <= 16, "The section mask is 16 bits wide");
+
+/**
+ * @brief Appends little-endian integers and varints to a byte buffer.
+ */
+class Writer
+{
+public:
+    explicit Writer(std::vector<std::byte>& out)
+        : m_out{out} {}
+
+    template <typename T>
+    void fixed(T value)
+    {
+        auto const bits = static_cast<std::make_unsigned_t<T>>(value);
+        for (std::size_t i = 0; i < sizeof(T); ++i)
+        {
+            m_out.push_back(static_cast<std::byte>(bits >> (i * 8)));
+        }
+    }
+
+    void varint(uint32_t value)
+    {
+        while (value >= 0x80)
+        {
+            m_out.push_back(static_cast<std::byte>(value | 0x80));
+            value >>= 7;
+        }
+        m_out.push_back(static_cast<std::byte>(value));
+    }
+
+private:
+    std::vector<std::byte>& m_out;
+};
+
+/**
+ * @brief Reads what Writer wrote, throwing ChunkFormatError instead of reading past the end.
+ */
+class Reader
+{
+public:
+    explicit Reader(std::span<std::byte const> data)
+        : m_data{data} {}
+
+    template <typename T>
+    T fixed()
+    {
+        if (m_data.size() - m_offset < sizeof(T))
+            throw ChunkFormatError("Chunk data is truncated");
+
+        std::make_unsigned_t<T> bits = 0;
+        for (std::size_t i = 0; i < sizeof(T); ++i)
+        {
+            bits |= static_cast<std::make_unsigned_t<T>>(std::to_integer<uint8_t>(m_data[m_offset++])) << (i * 8);
+        }
+        return static_cast<T>(bits);
+    }
+
+    uint32_t varint()
+    {
+        uint32_t value = 0;
+        for (int shift = 0; shift < 32; shift += 7)
+        {
+            if (m_offset == m_data.size())
+                throw ChunkFormatError("Chunk data is truncated");
+
+            auto const byte = std::to_integer<uint32_t>(m_data[m_offset++]);
+            value |= (byte & 0x7F) << shift;
+            if ((byte & 0x80) == 0) return value;
+        }
+        throw ChunkFormatError("Chunk data holds an overlong varint");
+    }
+
+    [[nodiscard]] bool atEnd() const
+    {
+        return m_offset == m_data.size();
+    }
+
+private:
+    std::span<std::byte const> m_data;
+    std::size_t m_offset = 0;
+};
+
+/// Bits the palette index takes in a run of a section with @p paletteSize entries.
+int index_bits(std::size_t paletteSize)
+{
+    return std::bit_width(paletteSize - 1);
+}
+
+uint32_t zigzag(int32_t value)
+{
+    return (static_cast<uint32_t>(value) << 1) ^ static_cast<uint32_t>(value >> 31);
+}
+
+int32_t unzigzag(uint32_t value)
+{
+    return static_cast<int32_t>(value >> 1) ^ -static_cast<int32_t>(value & 1);
+}
+
+struct Header
+{
+    uint16_t version;
+    uint16_t sectionMask;
+    Magnum::Vector3i position;
+};
+
+/**
+ * @brief Reads and validates the header.
+ */
+Header read_header(Reader& reader)
+{
+    if (reader.fixed<uint32_t>() != ChunkSerializer::MAGIC)
+        throw ChunkFormatError("Not an encoded chunk");
+
+    auto const version = reader.fixed<uint16_t>();
+    if (version == 0 || version > ChunkSerializer::FORMAT_VERSION)
+        throw ChunkFormatError("Unsupported chunk format version " + std::to_string(version));
+
+    auto const sectionMask = reader.fixed<uint16_t>();
+    int const x = reader.fixed<int32_t>();
+    int const y = reader.fixed<int32_t>();
+    int const z = reader.fixed<int32_t>();
+    return {version, sectionMask, {x, y, z}};
+}
+
+void encode_section(PalettedContainer const& blocks, Writer& writer)
+{
+    // Unreferenced entries are dropped, so stored indices are remapped to the written palette
+    auto const palette = blocks.palette();
+    std::array<uint16_t, 256> smallRemap{};
+    std::vector<uint16_t> largeRemap;
+    std::span<uint16_t> remap = std::span{smallRemap}.first(std::min(palette.size(), smallRemap.size()));
+    if (palette.size() > smallRemap.size())
+    {
+        largeRemap.resize(palette.size());
+        remap = largeRemap;
+    }
+
+    uint32_t written = 0;
+    for (std::size_t i = 0; i < palette.size(); ++i)
+    {
+        if (blocks.paletteCount(static_cast<uint16_t>(i)) != 0)
+            remap[i] = static_cast<uint16_t>(written++);
+    }
+    writer.varint(written);
+    for (std::size_t i = 0; i < palette.size(); ++i)
+    {
+        if (blocks.paletteCount(static_cast<uint16_t>(i)) != 0)
+            writer.varint(static_cast<uint32_t>(palette[i]));
+    }
+    if (written == 1) return;
+
+    int const bits = index_bits(written);
+    for (std::size_t first = 0; first < blocks.size();)
+    {
+        std::size_t const end = blocks.runEnd(first);
+        writer.varint(static_cast<uint32_t>(end - first - 1) << bits | remap[blocks.paletteIndexAt(first)]);
+        first = end;
+    }
+}
+
+void decode_section(Reader& reader, Chunk& chunk, int index)
+{
+    // A palette never repeats a block type, so it always fits on the stack
+    std::array<BlockType, BLOCK_TYPE_COUNT> palette;
+    uint32_t const paletteSize = reader.varint();
+    if (paletteSize == 0 || paletteSize > palette.size())
+        throw ChunkFormatError("Invalid section palette size");
+
+    std::bitset<BLOCK_TYPE_COUNT> seen;
+    for (uint32_t i = 0; i < paletteSize; ++i)
+    {
+        uint32_t const type = reader.varint();
+        if (type >= BLOCK_TYPE_COUNT || seen.test(type))
+            throw ChunkFormatError("Invalid block type in section palette");
+        seen.set(type);
+        palette[i] = static_cast<BlockType>(type);
+    }
+
+    if (paletteSize == 1 && palette[0] == BlockType::AIR)
+        throw ChunkFormatError("All-air section stored explicitly");
+
+    auto& blocks = chunk.replaceSection(index).getBlocks();
+    blocks.assignPalette(std::span{palette}.first(paletteSize));
+    if (paletteSize == 1) return;
+
+    int const bits = index_bits(paletteSize);
+    uint32_t const indexMask = (uint32_t{1} << bits) - 1;
+    std::size_t first = 0;
+    while (first < blocks.size())
+    {
+        uint32_t const run = reader.varint();
+        auto const paletteIndex = static_cast<uint16_t>(run & indexMask);
+        std::size_t const length = (run >> bits) + std::size_t{1};
+        if (paletteIndex >= paletteSize || length > blocks.size() - first)
+            throw ChunkFormatError("Invalid run in section");
+
+        blocks.fillIndexRange(first, length, paletteIndex);
+        first += length;
+    }
+
+    if (blocks.paletteSize() != paletteSize)
+        throw ChunkFormatError("Section palette has unused entries");
+}
+
+void encode_decorations(Magnum::Vector3i const& chunkPos, std::span<ChunkGenerator::Decoration const> decorations, Writer& writer)
+{
+    writer.varint(static_cast<uint32_t>(decorations.size()));
+    for (auto const& decoration : decorations)
+    {
+        Magnum::Vector3i const offset = decoration.chunkPos - chunkPos;
+        writer.varint(zigzag(offset.x()));
+        writer.varint(zigzag(offset.y()));
+        writer.varint(zigzag(offset.z()));
+        writer.fixed(decoration.x);
+        writer.fixed(decoration.y);
+        writer.fixed(decoration.z);
+        writer.varint(static_cast<uint32_t>(decoration.block.type));
+    }
+}
+
+void decode_decorations(Reader& reader, Magnum::Vector3i const& chunkPos, std::vector<ChunkGenerator::Decoration>& decorations)
+{
+    uint32_t const count = reader.varint();
+    for (uint32_t i = 0; i < count; ++i)
+    {
+        int const dx = unzigzag(reader.varint());
+        int const dy = unzigzag(reader.varint());
+        int const dz = unzigzag(reader.varint());
+        auto const x = reader.fixed<uint8_t>();
+        auto const y = reader.fixed<uint8_t>();
+        auto const z = reader.fixed<uint8_t>();
+        uint32_t const type = reader.varint();
+        if (!Chunk::isInBounds(x, y, z) || type >= BLOCK_TYPE_COUNT)
+            throw ChunkFormatError("Invalid decoration");
+
+        decorations.push_back({chunkPos + Magnum::Vector3i{dx, dy, dz}, x, y, z, Block{static_cast<BlockType>(type)}});
+    }
+}
+} // namespace
+
+void ChunkSerializer::encode(
+    Chunk const& chunk,
+    std::vector<std::byte>& out,
+    std::span<ChunkGenerator::Decoration const> decorations,
+    uint32_t decoratedBy)
+{
+    assert((decoratedBy & ~ChunkGenerator::ALL_DECORATION_SOURCES) == 0);
+
+    uint16_t sectionMask = 0;
+    for (int i = 0; i < CHUNK_SECTION_COUNT; ++i)
+    {
+        if (!chunk.getSection(i).isEmpty())
+            sectionMask |= static_cast<uint16_t>(1u << i);
+    }
+
+    Writer writer{out};
+    writer.fixed(MAGIC);
+    writer.fixed(FORMAT_VERSION);
+    writer.fixed(sectionMask);
+    writer.fixed(static_cast<int32_t>(chunk.getPosition().x()));
+    writer.fixed(static_cast<int32_t>(chunk.getPosition().y()));
+    writer.fixed(static_cast<int32_t>(chunk.getPosition().z()));
 
+    for (int i = 0; i < CHUNK_SECTION_COUNT; ++i)
+    {
+        if (sectionMask & (1u << i))
+            encode_section(chunk.getSection(i).getBlocks(), writer);
+    }
+    encode_decorations(chunk.getPosition(), decorations, writer);
+    writer.varint(decoratedBy);
+}
+
+std::vector<std::byte> ChunkSerializer::encode(Chunk const& chunk, std::span<ChunkGenerator::Decoration const> decorations, uint32_t decoratedBy)
+{
+    std::vector<std::byte> out;
+    encode(chunk, out, decorations, decoratedBy);
+    return out;
+}
+
+void ChunkSerializer::decode(std::span<std::byte const> data, Chunk& chunk)
+{
+    std::vector<ChunkGenerator::Decoration> decorations;
+    decode(data, chunk, decorations);
+}
+
+void ChunkSerializer::decode(std::span<std::byte const> data, Chunk& chunk, std::vector<ChunkGenerator::Decoration>& decorations)
+{
+    uint32_t decoratedBy = 0;
+    decode(data, chunk, decorations, decoratedBy);
+}
+
+void ChunkSerializer::decode(
+    std::span<std::byte const> data,
+    Chunk& chunk,
+    std::vector<ChunkGenerator::Decoration>& decorations,
+    uint32_t& decoratedBy)
+{
+    Reader reader{data};
+    Header const header = read_header(reader);
+
+    chunk.reset(header.position);
+    for (int i = 0; i < CHUNK_SECTION_COUNT; ++i)
+    {
+        if (header.sectionMask & (1u << i))
+            decode_section(reader, chunk, i);
+    }
+
+    // Version 1 had no decorations
+    decorations.clear();
+    if (header.version >= 2)
+        decode_decorations(reader, header.position, decorations);
+
+    // Before version 3 nothing tells which neighbours' decorations the chunk holds;
+    // placing them again could undo edits, missing some only leaves a canopy cut off
+    decoratedBy = ChunkGenerator::ALL_DECORATION_SOURCES;
+    if (header.version >= 3)
+    {
+        decoratedBy = reader.varint();
+        if ((decoratedBy & ~ChunkGenerator::ALL_DECORATION_SOURCES) != 0)
+            throw ChunkFormatError("Invalid decoration source mask");
+    }
+    if (!reader.atEnd())
+        throw ChunkFormatError("Chunk data has trailing bytes");
+
+    chunk.rebuildHeightmaps();
+}
+
+Magnum::Vector3i ChunkSerializer::peekPosition(std::span<std::byte const> data)
+{
+    Reader reader{data};
+    return read_header(reader).position;
+}
+
+} // namespace mc::world
@@ -0,0 +1,162 @@
+#include "world/ClimateMap.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+
+#include <utils/FastDivFloor.hpp>
+
+namespace mc::world
+{
+
+namespace
+{
+constexpr int CLIMATE_OCTAVES = 3;
+constexpr float CLIMATE_FREQUENCY = 0.0015f;
+constexpr float CONTINENTALNESS_FREQUENCY = 0.0008f; ///< Continents are wider than climate zones.
+constexpr int TEMPERATURE_SEED_OFFSET = 2; ///< Offsets after the density noise's, keeping every field independent.
+constexpr int HUMIDITY_SEED_OFFSET = 3;
+constexpr int CONTINENTALNESS_SEED_OFFSET = 4;
+
+void configure_climate_noise(FastNoiseLite& noise, int32_t seed, float frequency)
+{
+    noise.SetSeed(seed);
+    noise.SetNoiseType(FastNoiseLite::NoiseType_OpenSimplex2);
+    noise.SetFractalType(FastNoiseLite::FractalType_FBm);
+    noise.SetFractalOctaves(CLIMATE_OCTAVES);
+    noise.SetFrequency(frequency);
+}
+
+Climate lerp_climate(Climate const& a, Climate const& b, float t)
+{
+    return {
+        std::lerp(a.temperature, b.temperature, t),
+        std::lerp(a.humidity, b.humidity, t),
+        std::lerp(a.continentalness, b.continentalness, t),
+    };
+}
+} // namespace
+
+ClimateMap::ClimateMap(int32_t seed, std::size_t cacheTiles)
+    : m_tiles{cacheTiles}
+{
+    configure_climate_noise(m_temperature, seed + TEMPERATURE_SEED_OFFSET, CLIMATE_FREQUENCY);
+    configure_climate_noise(m_humidity, seed + HUMIDITY_SEED_OFFSET, CLIMATE_FREQUENCY);
+    configure_climate_noise(m_continentalness, seed + CONTINENTALNESS_SEED_OFFSET, CONTINENTALNESS_FREQUENCY);
+}
+
+void ClimateMap::sample(int worldX, int worldZ, int sizeX, int sizeZ, std::span<Climate> out) const
+{
+    assert(out.size() == static_cast<std::size_t>(sizeX) * sizeZ);
+    if (sizeX <= 0 || sizeZ <= 0)
+        return;
+
+    for (int chunkZ = utils::floor_div(worldZ, CHUNK_SIZE_Z); chunkZ <= utils::floor_div(worldZ + sizeZ - 1, CHUNK_SIZE_Z); ++chunkZ)
+    {
+        for (int chunkX = utils::floor_div(worldX, CHUNK_SIZE_X); chunkX <= utils::floor_div(worldX + sizeX - 1, CHUNK_SIZE_X); ++chunkX)
+        {
+            blendChunk(chunkX, chunkZ, worldX, worldZ, sizeX, sizeZ, out);
+        }
+    }
+}
+
+Climate ClimateMap::sampleAt(int worldX, int worldZ) const
+{
+    Climate climate;
+    sample(worldX, worldZ, 1, 1, {&climate, 1});
+    return climate;
+}
+
+Climate ClimateMap::sampleCoarse(int worldX, int worldZ) const
+{
+    assert(worldX % RESOLUTION == 0 && worldZ % RESOLUTION == 0);
+    auto const x = static_cast<float>(worldX);
+    auto const z = static_cast<float>(worldZ);
+    return {m_temperature.GetNoise(x, z), m_humidity.GetNoise(x, z), m_continentalness.GetNoise(x, z)};
+}
+
+ClimateMap::Stats ClimateMap::getStats() const
+{
+    std::lock_guard lock{m_cacheMutex};
+    Stats stats = m_stats;
+    stats.tiles = m_tiles.size();
+    return stats;
+}
+
+void ClimateMap::clearCache()
+{
+    std::lock_guard lock{m_cacheMutex};
+    m_tiles.clear();
+    m_stats = {};
+}
+
+ClimateMap::Tile ClimateMap::tile(int chunkX, int chunkZ) const
+{
+    Magnum::Vector3i const key{chunkX, 0, chunkZ};
+    {
+        std::lock_guard lock{m_cacheMutex};
+        ++m_stats.lookups;
+        if (auto const* cached = m_tiles.find(key))
+        {
+            ++m_stats.hits;
+            return *cached;
+        }
+    }
+
+    // Computed outside the lock; a tile two threads miss at once is computed twice, to
+    // the same values
+    Tile const computed = computeTile(chunkX, chunkZ);
+    std::lock_guard lock{m_cacheMutex};
+    m_tiles.insert(key, computed);
+    return computed;
+}
+
+ClimateMap::Tile ClimateMap::computeTile(int chunkX, int chunkZ) const
+{
+    Tile tile;
+    for (int pz = 0; pz < TILE_SIDE; ++pz)
+    {
+        for (int px = 0; px < TILE_SIDE; ++px)
+        {
+            tile[pz * TILE_SIDE + px] = sampleCoarse(chunkX * CHUNK_SIZE_X + px * RESOLUTION, chunkZ * CHUNK_SIZE_Z + pz * RESOLUTION);
+        }
+    }
+    return tile;
+}
+
+void ClimateMap::blendChunk(int chunkX, int chunkZ, int worldX, int worldZ, int sizeX, int sizeZ, std::span<Climate> out) const
+{
+    // The last cell of each row and column ends on the first samples of the next chunk
+    Tile const own = tile(chunkX, chunkZ);
+    Tile const east = tile(chunkX + 1, chunkZ);
+    Tile const south = tile(chunkX, chunkZ + 1);
+    Tile const southEast = tile(chunkX + 1, chunkZ + 1);
+    auto const point = [&](int px, int pz) -> Climate const& {
+        if (px < TILE_SIDE && pz < TILE_SIDE) return own[pz * TILE_SIDE + px];
+        if (pz < TILE_SIDE) return east[pz * TILE_SIDE];
+        if (px < TILE_SIDE) return south[px];
+        return southEast[0];
+    };
+
+    int const originX = chunkX * CHUNK_SIZE_X;
+    int const originZ = chunkZ * CHUNK_SIZE_Z;
+    int const firstX = std::max(worldX, originX);
+    int const lastX = std::min(worldX + sizeX, originX + CHUNK_SIZE_X) - 1;
+    int const firstZ = std::max(worldZ, originZ);
+    int const lastZ = std::min(worldZ + sizeZ, originZ + CHUNK_SIZE_Z) - 1;
+    for (int z = firstZ; z <= lastZ; ++z)
+    {
+        int const pz = (z - originZ) / RESOLUTION;
+        float const tz = static_cast<float>((z - originZ) % RESOLUTION) / RESOLUTION;
+        for (int x = firstX; x <= lastX; ++x)
+        {
+            int const px = (x - originX) / RESOLUTION;
+            float const tx = static_cast<float>((x - originX) % RESOLUTION) / RESOLUTION;
+            Climate const front = lerp_climate(point(px, pz), point(px + 1, pz), tx);
+            Climate const back = lerp_climate(point(px, pz + 1), point(px + 1, pz + 1), tx);
+            out[static_cast<std::size_t>(z - worldZ) * sizeX + (x - worldX)] = lerp_climate(front, back, tz);
+        }
+    }
+}
+
+} // namespace mc::world
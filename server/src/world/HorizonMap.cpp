@@ -0,0 +1,172 @@
+#include "world/HorizonMap.hpp"
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <unordered_set>
+
+#include <utils/FastDivFloor.hpp>
+
+namespace mc::world
+{
+
+namespace
+{
+/**
+ * @brief Square of blocks [min, max) along X and Z.
+ */
+struct BlockSquare
+{
+    int minX;
+    int minZ;
+    int maxX;
+    int maxZ;
+
+    [[nodiscard]] bool contains(BlockSquare const& other) const
+    {
+        return other.minX >= minX && other.maxX <= maxX && other.minZ >= minZ && other.maxZ <= maxZ;
+    }
+};
+} // namespace
+
+HorizonMap::HorizonMap(ChunkGenerator const& generator, HorizonOptions const& options)
+    : m_generator{generator}
+    , m_options{options}
+{
+    static_assert(HORIZON_BASE_STEP % ClimateMap::RESOLUTION == 0, "horizon samples must fall on the coarse climate samples");
+}
+
+int HorizonMap::ringRadius(int level) const
+{
+    // Level 0 covers the loaded area, every further level reaches past the one inside it
+    int const side = horizon_tile_side(0);
+    int radius = (m_options.innerRadius * CHUNK_SIZE_X + side - 1) / side + m_options.ringTiles;
+    for (int l = 1; l <= level; ++l)
+    {
+        radius = (radius + 1) / 2 + m_options.ringTiles;
+    }
+    return radius;
+}
+
+std::vector<Magnum::Vector3i> HorizonMap::wantedTiles(Magnum::Vector3i const& playerChunk) const
+{
+    int const playerX = playerChunk.x() * CHUNK_SIZE_X + CHUNK_SIZE_X / 2;
+    int const playerZ = playerChunk.z() * CHUNK_SIZE_Z + CHUNK_SIZE_Z / 2;
+    float const loadedRadius = (static_cast<float>(m_options.innerRadius) + 0.5f) * CHUNK_SIZE_X;
+    auto const isLoaded = [&](int x, int z) {
+        float const dx = static_cast<float>(x - playerX);
+        float const dz = static_cast<float>(z - playerZ);
+        return dx * dx + dz * dz <= loadedRadius * loadedRadius;
+    };
+
+    std::vector<Magnum::Vector3i> wanted;
+    BlockSquare inner{0, 0, 0, 0};
+    for (int level = 0; level < m_options.levels; ++level)
+    {
+        int const side = horizon_tile_side(level);
+        int const radius = ringRadius(level);
+        int const centerX = utils::floor_div(playerX, side);
+        int const centerZ = utils::floor_div(playerZ, side);
+
+        auto const first = wanted.size();
+        for (int tz = centerZ - radius; tz <= centerZ + radius; ++tz)
+        {
+            for (int tx = centerX - radius; tx <= centerX + radius; ++tx)
+            {
+                BlockSquare const tile{tx * side, tz * side, (tx + 1) * side, (tz + 1) * side};
+                bool const covered = level == 0
+                    ? isLoaded(tile.minX, tile.minZ) && isLoaded(tile.maxX, tile.minZ) && isLoaded(tile.minX, tile.maxZ) && isLoaded(tile.maxX, tile.maxZ)
+                    : inner.contains(tile);
+                if (!covered)
+                    wanted.emplace_back(tx, level, tz);
+            }
+        }
+
+        std::sort(wanted.begin() + static_cast<std::ptrdiff_t>(first), wanted.end(), [centerX, centerZ](auto const& a, auto const& b) {
+            auto const distance = [centerX, centerZ](Magnum::Vector3i const& key) {
+                return (key.x() - centerX) * (key.x() - centerX) + (key.z() - centerZ) * (key.z() - centerZ);
+            };
+            return distance(a) < distance(b);
+        });
+        inner = {(centerX - radius) * side, (centerZ - radius) * side, (centerX + radius + 1) * side, (centerZ + radius + 1) * side};
+    }
+    return wanted;
+}
+
+HorizonMap::Update HorizonMap::update(Magnum::Vector3i const& playerChunk, std::size_t maxNewTiles)
+{
+    auto const wanted = wantedTiles(playerChunk);
+
+    Update update;
+
+    // Dropped before generating, whatever the budget, so a player outrunning it never
+    // accumulates tiles
+    std::unordered_set<Magnum::Vector3i, utils::IVec3Hasher> const wantedSet(wanted.begin(), wanted.end());
+    for (auto it = m_tiles.begin(); it != m_tiles.end();)
+    {
+        if (wantedSet.contains(it->first))
+        {
+            ++it;
+            continue;
+        }
+        update.removed.push_back(it->first);
+        it = m_tiles.erase(it);
+    }
+    m_stats.tilesDropped += update.removed.size();
+
+    update.complete = true;
+    for (auto const& key : wanted)
+    {
+        if (m_tiles.contains(key))
+            continue;
+        if (update.added.size() >= maxNewTiles)
+        {
+            update.complete = false;
+            break;
+        }
+
+        auto& tile = m_tiles[key];
+        tile.key = key;
+        generateTile(tile);
+        update.added.push_back(key);
+    }
+    return update;
+}
+
+void HorizonMap::generateTile(HorizonTile& tile)
+{
+    constexpr std::size_t SAMPLE_COUNT = HORIZON_TILE_SAMPLES * HORIZON_TILE_SAMPLES;
+    auto const start = std::chrono::steady_clock::now();
+
+    std::array<int, SAMPLE_COUNT> heights;
+    std::array<BlockType, SAMPLE_COUNT> surface;
+    Magnum::Vector3i const origin = tile.origin();
+    m_generator.sampleHeightGrid(origin.x(), origin.z(), horizon_step(tile.level()), HORIZON_TILE_SAMPLES, HORIZON_TILE_SAMPLES, heights, surface);
+    for (std::size_t i = 0; i < SAMPLE_COUNT; ++i)
+    {
+        tile.heights[i] = static_cast<uint8_t>(std::clamp(heights[i], 0, CHUNK_SIZE_Y - 1));
+        tile.surface[i] = static_cast<uint8_t>(surface[i]);
+    }
+
+    ++m_stats.tilesGenerated;
+    m_stats.samples += SAMPLE_COUNT;
+    m_stats.generationSeconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+HorizonTile const* HorizonMap::getTile(Magnum::Vector3i const& key) const
+{
+    auto it = m_tiles.find(key);
+    return it != m_tiles.end() ? &it->second : nullptr;
+}
+
+std::unordered_map<Magnum::Vector3i, HorizonTile, utils::IVec3Hasher> const& HorizonMap::getTiles() const
+{
+    return m_tiles;
+}
+
+HorizonMap::Stats const& HorizonMap::getStats() const
+{
+    return m_stats;
+}
+
+} // namespace mc::world
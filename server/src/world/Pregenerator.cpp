@@ -0,0 +1,133 @@
+#include "world/Pregenerator.hpp"
+
+#include "world/World.hpp"
+
+#include <algorithm>
+#include <ranges>
+#include <thread>
+#include <vector>
+
+#include <concurrencpp/concurrencpp.h>
+#include <ecs/events/EventBus.hpp>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <sys/resource.h>
+#endif
+
+namespace mc::world
+{
+
+Pregenerator::Percentiles Pregenerator::Percentiles::of(utils::LatencyHistogram const& histogram)
+{
+    return {histogram.percentile(0.5), histogram.percentile(0.9), histogram.percentile(0.99), histogram.max()};
+}
+
+Pregenerator::Pregenerator(Options const& options)
+    : m_options{options}
+{
+    if (m_options.threads == 0)
+    {
+        m_options.threads = std::max(1u, std::thread::hardware_concurrency());
+    }
+}
+
+Pregenerator::Report Pregenerator::run() const
+{
+    concurrencpp::runtime runtime;
+    auto executor = runtime.make_executor<concurrencpp::thread_pool_executor>("pregen chunks", m_options.threads, std::chrono::seconds{10});
+    ecs::EventBus eventBus;
+    World world{executor, eventBus, m_options.seed};
+    world.setRegionBatching(m_options.regionChunks);
+    std::shared_ptr<concurrencpp::thread_pool_executor> readExecutor;
+    std::shared_ptr<concurrencpp::thread_pool_executor> writeExecutor;
+    if (!m_options.worldDirectory.empty())
+    {
+        readExecutor = runtime.make_executor<concurrencpp::thread_pool_executor>("pregen reads", 2, std::chrono::seconds{10});
+        writeExecutor = runtime.make_executor<concurrencpp::thread_pool_executor>("pregen writes", 1, std::chrono::seconds{10});
+        world.enablePersistence(m_options.worldDirectory, readExecutor, writeExecutor);
+    }
+
+    // Nearest first, so an interrupted run still leaves a usable area around spawn
+    float const r = static_cast<float>(m_options.radius) + 0.5f;
+    std::vector<Magnum::Vector3i> positions;
+    for (int x = -m_options.radius; x <= m_options.radius; ++x)
+    {
+        for (int z = -m_options.radius; z <= m_options.radius; ++z)
+        {
+            if (static_cast<float>(x * x + z * z) <= r * r)
+                positions.emplace_back(x, 0, z);
+        }
+    }
+    std::ranges::stable_sort(positions, {}, [](Magnum::Vector3i const& pos) { return pos.x() * pos.x() + pos.z() * pos.z(); });
+
+    auto const start = std::chrono::steady_clock::now();
+    world.submitChunkLoads(positions);
+    Report report;
+    while (!world.getPendingChunks().empty())
+    {
+        // Later stages are only scheduled from here, so stopping leaves the running jobs
+        if (m_options.stop != nullptr && m_options.stop->load(std::memory_order_relaxed))
+        {
+            report.stopped = true;
+            break;
+        }
+        world.integrateFinishedChunks();
+        std::this_thread::sleep_for(std::chrono::milliseconds{1});
+    }
+    report.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    // Only committed chunks are saved; neighbours stopped at an earlier stage are not
+    // complete and generate again when loaded
+    if (world.getPersistence() != nullptr)
+    {
+        auto const writeStart = std::chrono::steady_clock::now();
+        for (auto const& chunkPos : world.getChunks() | std::views::keys)
+        {
+            world.markChunkDirty(chunkPos);
+        }
+        world.saveAll();
+        report.writeSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - writeStart).count();
+
+        auto const stats = world.getPersistence()->getStats();
+        report.chunksWritten = stats.written;
+        report.bytesWritten = stats.bytesWritten;
+    }
+    report.chunks = report.stopped
+        ? static_cast<std::size_t>(std::ranges::count_if(positions, [&world](Magnum::Vector3i const& pos) { return world.isChunkLoaded(pos); }))
+        : positions.size();
+    report.threads = m_options.threads;
+    report.stageRuns = world.getGenerationStats().stageRuns;
+    for (std::size_t stage = 0; stage < GENERATION_STAGE_COUNT; ++stage)
+    {
+        report.stageTimes[stage] = Percentiles::of(world.getStageTimes(static_cast<GenerationStage>(stage)));
+    }
+    report.loadLatency = Percentiles::of(world.getLoadLatency());
+    report.sections = world.getSectionTableStats();
+    report.peakMemoryBytes = peak_memory_usage();
+
+    executor->shutdown();
+    if (readExecutor)
+    {
+        readExecutor->shutdown();
+        writeExecutor->shutdown();
+    }
+    return report;
+}
+
+std::size_t peak_memory_usage()
+{
+#if defined(__unix__) || defined(__APPLE__)
+    rusage usage{};
+    if (getrusage(RUSAGE_SELF, &usage) != 0)
+        return 0;
+#if defined(__APPLE__)
+    return static_cast<std::size_t>(usage.ru_maxrss); // Bytes on macOS
+#else
+    return static_cast<std::size_t>(usage.ru_maxrss) * 1024; // Kilobytes on Linux
+#endif
+#else
+    return 0;
+#endif
+}
+
+} // namespace mc::world
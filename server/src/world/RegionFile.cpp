@@ -0,0 +1,453 @@
+#include "world/RegionFile.hpp"
+
+#include <core/Logger.hpp>
+
+#include <algorithm>
+#include <bit>
+#include <cstring>
+#include <mutex>
+#include <stdexcept>
+#include <system_error>
+#include <utility>
+
+#if defined(_WIN32)
+#define NOMINMAX
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace mc::world
+{
+
+namespace
+{
+static_assert((REGION_SIZE & (REGION_SIZE - 1)) == 0, "Region-local coordinates are taken with a mask");
+static_assert(REGION_CHUNK_COUNT * sizeof(uint32_t) == REGION_HEADER_SECTORS * REGION_SECTOR_SIZE, "The header fills whole sectors");
+
+constexpr std::size_t HEADER_BYTES = REGION_HEADER_SECTORS * REGION_SECTOR_SIZE;
+
+constexpr uint32_t MAX_SECTOR_COUNT = 0xFF;
+constexpr uint32_t MAX_FIRST_SECTOR = 0xFFFFFF;
+
+constexpr uint32_t first_sector(uint32_t entry)
+{
+    return entry >> 8;
+}
+
+constexpr uint32_t sector_count(uint32_t entry)
+{
+    return entry & MAX_SECTOR_COUNT;
+}
+
+uint32_t load_u32(std::byte const* bytes)
+{
+    uint32_t value = 0;
+    for (std::size_t i = 0; i < sizeof(uint32_t); ++i)
+    {
+        value |= std::to_integer<uint32_t>(bytes[i]) << (i * 8);
+    }
+    return value;
+}
+
+void store_u32(std::byte* bytes, uint32_t value)
+{
+    for (std::size_t i = 0; i < sizeof(uint32_t); ++i)
+    {
+        bytes[i] = static_cast<std::byte>(value >> (i * 8));
+    }
+}
+
+[[noreturn]] void throw_last_error(char const* what)
+{
+#if defined(_WIN32)
+    throw std::system_error(static_cast<int>(GetLastError()), std::system_category(), what);
+#else
+    throw std::system_error(errno, std::generic_category(), what);
+#endif
+}
+} // namespace
+
+#if defined(_WIN32)
+
+class RegionFile::NativeFile
+{
+public:
+    explicit NativeFile(std::filesystem::path const& path)
+        : m_handle{CreateFileW(path.c_str(), GENERIC_READ | GENERIC_WRITE, FILE_SHARE_READ, nullptr, OPEN_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr)}
+    {
+        if (m_handle == INVALID_HANDLE_VALUE) throw_last_error("Cannot open region file");
+    }
+
+    ~NativeFile()
+    {
+        unmap();
+        CloseHandle(m_handle);
+    }
+
+    [[nodiscard]] uint64_t size() const
+    {
+        LARGE_INTEGER size{};
+        if (!GetFileSizeEx(m_handle, &size)) throw_last_error("Cannot stat region file");
+        return static_cast<uint64_t>(size.QuadPart);
+    }
+
+    void writeAt(uint64_t offset, std::span<std::byte const> data)
+    {
+        while (!data.empty())
+        {
+            OVERLAPPED overlapped{};
+            overlapped.Offset = static_cast<DWORD>(offset);
+            overlapped.OffsetHigh = static_cast<DWORD>(offset >> 32);
+            DWORD written = 0;
+            if (!WriteFile(m_handle, data.data(), static_cast<DWORD>(data.size()), &written, &overlapped))
+                throw_last_error("Cannot write region file");
+            data = data.subspan(written);
+            offset += written;
+        }
+    }
+
+    void sync()
+    {
+        if (!FlushFileBuffers(m_handle)) throw_last_error("Cannot sync region file");
+    }
+
+    void syncData()
+    {
+        sync();
+    }
+
+    void resize(uint64_t size)
+    {
+        FILE_END_OF_FILE_INFO info{};
+        info.EndOfFile.QuadPart = static_cast<LONGLONG>(size);
+        unmap();
+        if (!SetFileInformationByHandle(m_handle, FileEndOfFileInfo, &info, sizeof(info)))
+            throw_last_error("Cannot extend region file");
+    }
+
+    std::span<std::byte const> map(uint64_t size)
+    {
+        unmap();
+        m_mappingHandle = CreateFileMappingW(m_handle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        if (m_mappingHandle == nullptr) throw_last_error("Cannot map region file");
+        void const* view = MapViewOfFile(m_mappingHandle, FILE_MAP_READ, 0, 0, 0);
+        if (view == nullptr) throw_last_error("Cannot map region file");
+        m_view = static_cast<std::byte const*>(view);
+        return {m_view, static_cast<std::size_t>(size)};
+    }
+
+private:
+    void unmap()
+    {
+        if (m_view != nullptr) UnmapViewOfFile(m_view);
+        if (m_mappingHandle != nullptr) CloseHandle(m_mappingHandle);
+        m_view = nullptr;
+        m_mappingHandle = nullptr;
+    }
+
+    HANDLE m_handle;
+    HANDLE m_mappingHandle = nullptr;
+    std::byte const* m_view = nullptr;
+};
+
+#else
+
+class RegionFile::NativeFile
+{
+public:
+    explicit NativeFile(std::filesystem::path const& path)
+        : m_fd{::open(path.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0644)}
+    {
+        if (m_fd < 0) throw_last_error("Cannot open region file");
+    }
+
+    ~NativeFile()
+    {
+        unmap();
+        ::close(m_fd);
+    }
+
+    [[nodiscard]] uint64_t size() const
+    {
+        struct stat info{};
+        if (::fstat(m_fd, &info) != 0) throw_last_error("Cannot stat region file");
+        return static_cast<uint64_t>(info.st_size);
+    }
+
+    void writeAt(uint64_t offset, std::span<std::byte const> data)
+    {
+        while (!data.empty())
+        {
+            ssize_t const written = ::pwrite(m_fd, data.data(), data.size(), static_cast<off_t>(offset));
+            if (written < 0)
+            {
+                if (errno == EINTR) continue;
+                throw_last_error("Cannot write region file");
+            }
+            data = data.subspan(static_cast<std::size_t>(written));
+            offset += static_cast<uint64_t>(written);
+        }
+    }
+
+    void sync()
+    {
+        if (::fsync(m_fd) != 0) throw_last_error("Cannot sync region file");
+    }
+
+    /**
+     * @brief Flushes written data, without the metadata a later read does not need.
+     */
+    void syncData()
+    {
+#if defined(__APPLE__)
+        sync();
+#else
+        if (::fdatasync(m_fd) != 0) throw_last_error("Cannot sync region file");
+#endif
+    }
+
+    void resize(uint64_t size)
+    {
+        while (::ftruncate(m_fd, static_cast<off_t>(size)) != 0)
+        {
+            if (errno != EINTR) throw_last_error("Cannot extend region file");
+        }
+    }
+
+    std::span<std::byte const> map(uint64_t size)
+    {
+        unmap();
+        void* view = ::mmap(nullptr, static_cast<std::size_t>(size), PROT_READ, MAP_SHARED, m_fd, 0);
+        if (view == MAP_FAILED) throw_last_error("Cannot map region file");
+        m_view = {static_cast<std::byte const*>(view), static_cast<std::size_t>(size)};
+        return m_view;
+    }
+
+private:
+    void unmap()
+    {
+        if (!m_view.empty()) ::munmap(const_cast<std::byte*>(m_view.data()), m_view.size());
+        m_view = {};
+    }
+
+    int m_fd;
+    std::span<std::byte const> m_view;
+};
+
+#endif
+
+RegionFile::RegionFile(std::filesystem::path path)
+    : m_path{std::move(path)}
+    , m_file{std::make_unique<NativeFile>(m_path)}
+{
+    uint64_t size = m_file->size();
+    if (size < HEADER_BYTES)
+    {
+        // New (or cut off before its header was written): start from an empty header
+        std::array<std::byte, HEADER_BYTES> const header{};
+        m_file->writeAt(0, header);
+        size = HEADER_BYTES;
+    }
+
+    // A partial last sector holds a record cut short by a crash; only whole sectors count
+    std::size_t const sectors = static_cast<std::size_t>(size / REGION_SECTOR_SIZE);
+    m_usedSectors.assign(sectors, false);
+    markSectors(0, REGION_HEADER_SECTORS, true);
+    m_mapping = m_file->map(static_cast<uint64_t>(sectors) * REGION_SECTOR_SIZE);
+
+    for (std::size_t i = 0; i < m_header.size(); ++i)
+    {
+        uint32_t const entry = load_u32(m_mapping.data() + i * sizeof(uint32_t));
+        uint32_t const first = first_sector(entry);
+        uint32_t const count = sector_count(entry);
+        if (entry == 0) continue;
+
+        bool valid = first >= REGION_HEADER_SECTORS && count >= 1 && first + count <= sectors;
+        for (uint32_t sector = first; valid && sector < first + count; ++sector)
+        {
+            valid = !m_usedSectors[sector];
+        }
+        if (!valid)
+        {
+            LOG(WARN, "Dropping invalid entry {} of region file {}", i, m_path.string());
+            continue;
+        }
+        m_header[i] = entry;
+        markSectors(first, count, true);
+    }
+    m_syncedHeader = m_header;
+}
+
+RegionFile::~RegionFile()
+{
+    try
+    {
+        sync();
+    }
+    catch (std::exception const& e)
+    {
+        LOG(ERROR, "Could not sync region file {}: {}", m_path.string(), e.what());
+    }
+}
+
+Magnum::Vector3i RegionFile::regionOf(Magnum::Vector3i const& chunkPos)
+{
+    constexpr int SHIFT = std::countr_zero(static_cast<unsigned>(REGION_SIZE));
+    return {chunkPos.x() >> SHIFT, 0, chunkPos.z() >> SHIFT};
+}
+
+bool RegionFile::contains(Magnum::Vector3i const& chunkPos) const
+{
+    std::shared_lock lock{m_mutex};
+    return m_header[localIndex(chunkPos)] != 0;
+}
+
+bool RegionFile::read(Magnum::Vector3i const& chunkPos, std::vector<std::byte>& out) const
+{
+    return visit(chunkPos, [&out](std::span<std::byte const> record) { out.assign(record.begin(), record.end()); });
+}
+
+void RegionFile::write(Magnum::Vector3i const& chunkPos, std::span<std::byte const> data)
+{
+    if (data.size() > MAX_CHUNK_BYTES)
+        throw std::length_error("Encoded chunk does not fit into a region file record");
+
+    auto const count = static_cast<uint32_t>((data.size() + sizeof(uint32_t) + REGION_SECTOR_SIZE - 1) / REGION_SECTOR_SIZE);
+    std::unique_lock lock{m_mutex};
+    uint32_t const first = allocate(count);
+
+    // Length and data are written in one go, the padding of the last sector is left as is
+    std::vector<std::byte> record(sizeof(uint32_t) + data.size());
+    store_u32(record.data(), static_cast<uint32_t>(data.size()));
+    std::memcpy(record.data() + sizeof(uint32_t), data.data(), data.size());
+    m_file->writeAt(static_cast<uint64_t>(first) * REGION_SECTOR_SIZE, record);
+
+    setEntry(localIndex(chunkPos), first << 8 | count);
+}
+
+void RegionFile::erase(Magnum::Vector3i const& chunkPos)
+{
+    std::unique_lock lock{m_mutex};
+    std::size_t const index = localIndex(chunkPos);
+    if (m_header[index] != 0)
+        setEntry(index, 0);
+}
+
+void RegionFile::sync()
+{
+    std::unique_lock lock{m_mutex};
+    if (m_dirtyEntries.empty())
+        return;
+
+    // The records reach the disk before the header entries pointing at them, and those
+    // before the sectors of the copies they replace are handed out again
+    m_file->syncData();
+    for (std::size_t const index : m_dirtyEntries)
+    {
+        std::array<std::byte, sizeof(uint32_t)> bytes;
+        store_u32(bytes.data(), m_header[index]);
+        m_file->writeAt(index * sizeof(uint32_t), bytes);
+    }
+    m_file->syncData();
+
+    for (std::size_t const index : m_dirtyEntries)
+    {
+        uint32_t const old = m_syncedHeader[index];
+        if (old != 0 && old != m_header[index])
+            markSectors(first_sector(old), sector_count(old), false);
+        m_syncedHeader[index] = m_header[index];
+    }
+    m_dirtyEntries.clear();
+}
+
+RegionFile::Stats RegionFile::getStats() const
+{
+    std::shared_lock lock{m_mutex};
+    Stats stats;
+    stats.chunks = static_cast<std::size_t>(std::ranges::count_if(m_header, [](uint32_t entry) { return entry != 0; }));
+    stats.sectors = m_usedSectors.size();
+    stats.freeSectors = static_cast<std::size_t>(std::ranges::count(m_usedSectors, false));
+    return stats;
+}
+
+std::filesystem::path const& RegionFile::getPath() const
+{
+    return m_path;
+}
+
+std::size_t RegionFile::localIndex(Magnum::Vector3i const& chunkPos)
+{
+    return static_cast<std::size_t>(chunkPos.z() & (REGION_SIZE - 1)) * REGION_SIZE + static_cast<std::size_t>(chunkPos.x() & (REGION_SIZE - 1));
+}
+
+std::optional<std::span<std::byte const>> RegionFile::recordOf(Magnum::Vector3i const& chunkPos) const
+{
+    uint32_t const entry = m_header[localIndex(chunkPos)];
+    if (entry == 0) return std::nullopt;
+
+    std::size_t const offset = static_cast<std::size_t>(first_sector(entry)) * REGION_SECTOR_SIZE;
+    std::size_t const capacity = static_cast<std::size_t>(sector_count(entry)) * REGION_SECTOR_SIZE - sizeof(uint32_t);
+    uint32_t const length = load_u32(m_mapping.data() + offset);
+    if (length > capacity)
+        throw std::runtime_error("Corrupt chunk record in region file " + m_path.string());
+
+    return m_mapping.subspan(offset + sizeof(uint32_t), length);
+}
+
+uint32_t RegionFile::allocate(uint32_t count)
+{
+    // First fit; the sectors of the copy being replaced stay taken until the header moves on
+    std::size_t runStart = REGION_HEADER_SECTORS;
+    for (std::size_t sector = REGION_HEADER_SECTORS; sector < m_usedSectors.size(); ++sector)
+    {
+        if (m_usedSectors[sector])
+        {
+            runStart = sector + 1;
+        }
+        else if (sector + 1 - runStart == count)
+        {
+            markSectors(static_cast<uint32_t>(runStart), count, true);
+            return static_cast<uint32_t>(runStart);
+        }
+    }
+
+    // Extend the free run at the end of the file, if any, past the end
+    if (runStart + count - 1 > MAX_FIRST_SECTOR)
+        throw std::length_error("Region file is full");
+    grow(runStart + count);
+    markSectors(static_cast<uint32_t>(runStart), count, true);
+    return static_cast<uint32_t>(runStart);
+}
+
+void RegionFile::markSectors(uint32_t first, uint32_t count, bool used)
+{
+    std::fill_n(m_usedSectors.begin() + first, count, used);
+}
+
+void RegionFile::setEntry(std::size_t index, uint32_t entry)
+{
+    // The copy the header on disk points to stays until sync() moves the header on; a
+    // copy written since the last sync() was never referenced on disk and is freed now
+    uint32_t const old = m_header[index];
+    if (old != 0 && old != m_syncedHeader[index])
+        markSectors(first_sector(old), sector_count(old), false);
+    m_header[index] = entry;
+    m_dirtyEntries.insert(index);
+}
+
+void RegionFile::grow(std::size_t sectors)
+{
+    // Doubling keeps the number of remaps logarithmic in the file size; the sectors past
+    // the last record are free and taken by later writes, also after a restart
+    std::size_t const capacity = std::min(std::max(sectors, m_usedSectors.size() * 2), static_cast<std::size_t>(MAX_FIRST_SECTOR) + MAX_SECTOR_COUNT);
+    m_file->resize(static_cast<uint64_t>(capacity) * REGION_SECTOR_SIZE);
+    m_usedSectors.resize(capacity, false);
+    m_mapping = m_file->map(static_cast<uint64_t>(capacity) * REGION_SECTOR_SIZE);
+}
+
+} // namespace mc::world
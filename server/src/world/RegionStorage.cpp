@@ -0,0 +1,111 @@
+#include "world/RegionStorage.hpp"
+
+#include <string>
+#include <utility>
+
+namespace mc::world
+{
+
+RegionStorage::RegionStorage(std::filesystem::path directory, std::size_t maxOpenFiles)
+    : m_directory{std::move(directory)}
+    , m_files{maxOpenFiles}
+{}
+
+std::filesystem::path RegionStorage::regionPath(Magnum::Vector3i const& region) const
+{
+    return m_directory / ("r." + std::to_string(region.x()) + "." + std::to_string(region.z()) + ".region");
+}
+
+bool RegionStorage::contains(Magnum::Vector3i const& chunkPos)
+{
+    auto const file = find(chunkPos);
+    return file != nullptr && file->contains(chunkPos);
+}
+
+bool RegionStorage::read(Magnum::Vector3i const& chunkPos, std::vector<std::byte>& out)
+{
+    auto const file = find(chunkPos);
+    return file != nullptr && file->read(chunkPos, out);
+}
+
+void RegionStorage::write(Magnum::Vector3i const& chunkPos, std::span<std::byte const> data)
+{
+    findOrCreate(chunkPos)->write(chunkPos, data);
+}
+
+void RegionStorage::erase(Magnum::Vector3i const& chunkPos)
+{
+    if (auto const file = find(chunkPos))
+        file->erase(chunkPos);
+}
+
+void RegionStorage::sync()
+{
+    std::vector<std::shared_ptr<RegionFile>> files;
+    {
+        std::lock_guard lock{m_mutex};
+        m_files.forEach([&files](Magnum::Vector3i const&, std::shared_ptr<RegionFile> const& file) { files.push_back(file); });
+    }
+    for (auto const& file : files)
+    {
+        file->sync();
+    }
+}
+
+std::filesystem::path const& RegionStorage::getDirectory() const
+{
+    return m_directory;
+}
+
+std::shared_ptr<RegionFile> RegionStorage::find(Magnum::Vector3i const& chunkPos)
+{
+    Magnum::Vector3i const region = RegionFile::regionOf(chunkPos);
+    std::shared_ptr<RegionFile> evicted; // Closed, and so synced, after the lock is released
+    std::lock_guard lock{m_mutex};
+    if (auto const* file = m_files.find(region))
+        return *file;
+    if (m_missingRegions.contains(region))
+        return nullptr;
+
+    // Opening an existing file only reads its header, cheap enough to do under the lock
+    if (!std::filesystem::exists(regionPath(region)))
+    {
+        m_missingRegions.insert(region);
+        return nullptr;
+    }
+    return open(region, evicted);
+}
+
+std::shared_ptr<RegionFile> RegionStorage::findOrCreate(Magnum::Vector3i const& chunkPos)
+{
+    Magnum::Vector3i const region = RegionFile::regionOf(chunkPos);
+    std::shared_ptr<RegionFile> evicted; // Closed, and so synced, after the lock is released
+    std::lock_guard lock{m_mutex};
+    if (auto const* file = m_files.find(region))
+        return *file;
+
+    std::filesystem::create_directories(m_directory);
+    auto file = open(region, evicted);
+    m_missingRegions.erase(region);
+    return file;
+}
+
+std::shared_ptr<RegionFile> RegionStorage::open(Magnum::Vector3i const& region, std::shared_ptr<RegionFile>& evicted)
+{
+    std::shared_ptr<RegionFile> file;
+    if (auto it = m_openFiles.find(region); it != m_openFiles.end())
+        file = it->second.lock();
+    if (!file)
+    {
+        file = std::make_shared<RegionFile>(regionPath(region));
+        m_openFiles[region] = file;
+    }
+
+    // Forget files nobody holds anymore once there are plenty of them
+    if (m_openFiles.size() > 2 * m_files.capacity())
+        std::erase_if(m_openFiles, [](auto const& entry) { return entry.second.expired(); });
+
+    return m_files.insert(region, std::move(file), &evicted);
+}
+
+} // namespace mc::world
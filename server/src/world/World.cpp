@@ -1,22 +1,19 @@
 #include "world/World.hpp"
 
-#include "world/ChunkSerializer.hpp"
+#include "world/RegionFile.hpp"
 
+#include <algorithm>
+#include <exception>
 #include <ranges>
+#include <thread>
+#include <tuple>
 
 #include <Magnum/Math/Functions.h>
 #include <concurrencpp/concurrencpp.h>
 #include <core/Logger.hpp>
 #include <ecs/events/EventBus.hpp>
 #include <ecs/events/Events.hpp>
-
-namespace
-{
-constexpr int div_floor(int a, int b)
-{
-    return (a < 0) ? ((a - b + 1) / b) : (a / b);
-}
-} // namespace
+#include <utils/FastDivFloor.hpp>
 
 namespace mc::world
 {
@@ -24,23 +21,60 @@ namespace mc::world
 World::World(
     std::shared_ptr<concurrencpp::thread_pool_executor> chunkExecutor,
     ecs::EventBus& eventBus,
-    int32_t seed)
+    int32_t seed,
+    NoiseBackend noiseBackend)
     : m_chunkExecutor{std::move(chunkExecutor)}
     , m_eventBus{eventBus}
     , m_seed{seed}
-    , m_generator{seed}
-{}
+    , m_generator{seed, noiseBackend}
+{
+    m_generator.setBiomesEnabled(true);
+}
+
+World::~World()
+{
+    for (auto* jobs : {&m_pendingJobs, &m_diskJobs})
+    {
+        for (auto& job : *jobs)
+        {
+            job.result.wait();
+        }
+    }
+
+    // Chunks modified since their last save would be lost otherwise
+    if (m_persistence)
+    {
+        try
+        {
+            saveAll();
+        }
+        catch (std::exception const& e)
+        {
+            LOG(ERROR, "Could not save the world into {}: {}", m_persistence->getDirectory().string(), e.what());
+        }
+    }
+}
 
 Chunk const* World::getChunk(Magnum::Vector3i const& chunkPos) const
 {
+    if (m_chunkGrid.covers(chunkPos))
+    {
+        return m_chunkGrid.get(chunkPos);
+    }
+
     auto it = m_chunks.find(chunkPos);
     if (it != m_chunks.end())
     {
-        return &it->second;
+        return it->second;
     }
     return nullptr;
 }
 
+void World::recenterChunkGrid(Magnum::Vector3i const& centerChunk, uint8_t radius)
+{
+    m_chunkGrid.recenter(centerChunk, radius, m_chunks);
+}
+
 void World::enqueueChunk(Magnum::Vector3i const& chunkPos)
 {
     m_pendingChunks.insert(chunkPos);
@@ -48,51 +82,473 @@ void World::enqueueChunk(Magnum::Vector3i const& chunkPos)
 
 void World::submitChunkLoad(Magnum::Vector3i const& chunkPos)
 {
-    if (m_chunks.contains(chunkPos) || m_pendingChunks.contains(chunkPos))
+    submitChunkLoads({&chunkPos, 1});
+}
+
+void World::submitChunkLoads(std::span<Magnum::Vector3i const> chunkPositions)
+{
+    // Chunks are acquired here on the owning thread; workers only fill them in place
+    for (auto const& chunkPos : chunkPositions)
+    {
+        if (isChunkLoaded(chunkPos) || m_pendingChunks.contains(chunkPos))
+            continue;
+
+        enqueueChunk(chunkPos);
+
+        // Saves in flight come first: the disk only holds older versions of them
+        auto saved = m_persistence ? m_persistence->findPending(chunkPos) : nullptr;
+        if (saved || (m_persistence && m_persistence->isStored(chunkPos)))
+        {
+            // Reads count once they succeed
+            if (saved)
+                ++m_loadStats.hits;
+            auto [it, inserted] = m_generation.try_emplace(chunkPos);
+            auto& state = it->second;
+            if (inserted)
+                state.chunk = m_chunkPool.acquire(chunkPos);
+            state.submitted = std::chrono::steady_clock::now();
+            state.saved = std::move(saved);
+            state.onDisk = state.saved == nullptr;
+
+            // Loaded instead of generated; a job running on it already is waited for
+            state.target = GenerationStage::FINALIZED;
+            m_waitingChunks.erase(chunkPos);
+            m_pendingRestores.push_back(chunkPos);
+            continue;
+        }
+
+        ++m_loadStats.misses;
+        requestStage(chunkPos, GenerationStage::FINALIZED);
+        m_generation.at(chunkPos).submitted = std::chrono::steady_clock::now();
+    }
+    restorePendingChunks();
+    scheduleStages();
+}
+
+void World::requestStage(Magnum::Vector3i const& chunkPos, GenerationStage target)
+{
+    auto [it, inserted] = m_generation.try_emplace(chunkPos);
+    auto& state = it->second;
+    if (inserted)
+    {
+        state.chunk = m_chunkPool.acquire(chunkPos);
+    }
+    else if (state.target >= target)
+    {
         return;
+    }
+
+    state.target = target;
+    if (!state.isBusy() && state.stage < target && !state.isStored())
+    {
+        m_waitingChunks.insert(chunkPos);
+    }
+}
+
+void World::scheduleStages()
+{
+    // One job per region and first stage, so terrain noise is sampled once per region
+    using RegionBatches = std::unordered_map<Magnum::Vector3i, std::vector<GenerationState*>, utils::IVec3Hasher>;
+    std::array<RegionBatches, GENERATION_STAGE_COUNT> batches;
+
+    std::vector<Magnum::Vector3i> const waiting(m_waitingChunks.begin(), m_waitingChunks.end());
+    for (auto const& chunkPos : waiting)
+    {
+        auto& state = m_generation.at(chunkPos);
+        GenerationStage const first = next_stage(state.stage);
+
+        // Stages only touch the chunk itself, so one job runs all of them; the generator
+        // always runs TERRAIN and SURFACE together
+        state.scheduled = std::max(state.target, GenerationStage::SURFACE);
+        m_waitingChunks.erase(chunkPos);
+        batches[static_cast<std::size_t>(first)][getRegionOf(chunkPos)].push_back(&state);
+    }
 
-    enqueueChunk(chunkPos);
+    for (auto& regions : batches)
+    {
+        for (auto& chunks : regions | std::views::values)
+        {
+            submitJob(std::move(chunks));
+        }
+    }
+}
 
-    auto job = m_chunkExecutor->submit([chunkPos, this]() {
-        SPAM_LOG(DEBUG, "Enqueue chunk at [{}, {}] for generation on thread {}", chunkPos.x(), chunkPos.z(), std::this_thread::get_id());
-        return m_generator.generate(chunkPos);
+void World::submitJob(std::vector<GenerationState*> chunks)
+{
+    auto job = m_chunkExecutor->submit([chunks, this]() {
+        SPAM_LOG(DEBUG, "Generating {} chunk(s) from [{}, {}] up to {} on thread {}",
+            chunks.size(), chunks.front()->chunk->getPosition().x(), chunks.front()->chunk->getPosition().z(),
+            stage_name(chunks.front()->scheduled), std::this_thread::get_id());
+        runStages(chunks);
     });
 
-    m_pendingChunkResults[chunkPos] = std::move(job);
+    m_pendingJobs.push_back({std::move(chunks), std::move(job)});
+}
+
+void World::runStages(std::span<GenerationState* const> chunks)
+{
+    using clock = std::chrono::steady_clock;
+
+    GenerationStage stage = next_stage(chunks.front()->stage);
+    if (stage == GenerationStage::TERRAIN)
+    {
+        std::vector<Chunk*> regionChunks;
+        regionChunks.reserve(chunks.size());
+        for (auto* state : chunks)
+        {
+            regionChunks.push_back(state->chunk);
+        }
+        auto const start = clock::now();
+        m_generator.generateRegion(regionChunks);
+        auto const perChunk = (clock::now() - start) / static_cast<int64_t>(chunks.size());
+        for (std::size_t i = 0; i < chunks.size(); ++i)
+        {
+            m_stageTimes[static_cast<std::size_t>(GenerationStage::TERRAIN)].record(perChunk);
+        }
+        stage = next_stage(GenerationStage::SURFACE);
+    }
+
+    for (auto* state : chunks)
+    {
+        for (auto step = stage; step <= state->scheduled; step = next_stage(step))
+        {
+            auto const start = clock::now();
+            switch (step)
+            {
+            case GenerationStage::FEATURES:
+                state->overflow.clear();
+                m_generator.generateFeatures(*state->chunk, state->overflow);
+                break;
+            case GenerationStage::FINALIZED:
+                state->chunk->internSections(m_sectionTable);
+                break;
+            default:
+                break;
+            }
+            m_stageTimes[static_cast<std::size_t>(step)].record(clock::now() - start);
+        }
+    }
 }
 
 void World::integrateFinishedChunks()
 {
-    std::vector<Magnum::Vector3i> toRemove;
-    toRemove.reserve(m_pendingChunkResults.size());
-    for (auto& [pos, result] : m_pendingChunkResults)
+    bool advanced = integrateDiskJobs();
+    for (std::size_t i = 0; i < m_pendingJobs.size();)
     {
-        if (result.status() != concurrencpp::result_status::value)
+        auto& job = m_pendingJobs[i];
+        if (job.result.status() != concurrencpp::result_status::value)
+        {
+            ++i;
             continue;
+        }
+
+        job.result.get();
+        for (auto* state : job.chunks)
+        {
+            Magnum::Vector3i const chunkPos = state->chunk->getPosition();
+            for (auto stage = next_stage(state->stage); stage <= state->scheduled; stage = next_stage(stage))
+            {
+                ++m_stageRuns[static_cast<std::size_t>(stage)];
+                if (stage == GenerationStage::FEATURES)
+                    addDecorations(chunkPos, std::move(state->overflow));
+            }
+            state->stage = state->scheduled;
+
+            // Chunks to restore wait in m_pendingRestores instead
+            if (state->isStored())
+                continue;
+
+            if (state->stage == GenerationStage::FINALIZED)
+            {
+                recordLoad(*state, LoadSource::GENERATOR);
+                uint32_t decoratedBy = 0;
+                applyDecorations(chunkPos, *state->chunk, decoratedBy);
+                m_decoratedBy.insert_or_assign(chunkPos, decoratedBy);
+                commitChunk(chunkPos, state->chunk);
+            }
+            else if (state->stage < state->target)
+                m_waitingChunks.insert(chunkPos);
+        }
+        advanced = true;
 
-        auto chunk = result.get();
-        commitChunk(pos, std::move(chunk));
-        toRemove.push_back(pos);
+        // Order of pending jobs does not matter
+        std::swap(job, m_pendingJobs.back());
+        m_pendingJobs.pop_back();
     }
 
-    for (auto const& pos : toRemove)
+    if (advanced)
     {
-        m_pendingChunkResults.erase(pos);
+        restorePendingChunks();
+        scheduleStages();
     }
 }
 
-void World::commitChunk(Magnum::Vector3i chunkPos, Chunk chunkPtr)
+void World::setRegionBatching(int regionChunks)
+{
+    m_regionChunks = std::max(1, regionChunks);
+}
+
+int World::getRegionBatching() const
+{
+    return m_regionChunks;
+}
+
+Magnum::Vector3i World::getRegionOf(Magnum::Vector3i const& chunkPos) const
+{
+    return {utils::floor_div(chunkPos.x(), m_regionChunks), 0, utils::floor_div(chunkPos.z(), m_regionChunks)};
+}
+
+void World::commitChunk(Magnum::Vector3i chunkPos, Chunk* chunk)
 {
     SPAM_LOG(INFO, "Committing chunk [{}, {}] into final map", chunkPos.x(), chunkPos.z());
-    m_chunks.insert_or_assign(chunkPos, std::move(chunkPtr));
+    auto [it, inserted] = m_chunks.try_emplace(chunkPos, chunk);
+    if (!inserted)
+    {
+        m_chunkPool.release(it->second);
+        it->second = chunk;
+    }
+    m_chunkGrid.set(chunkPos, chunk);
     m_pendingChunks.erase(chunkPos);
 
     m_eventBus.emit(ecs::ChunkLoaded{chunkPos});
 }
 
+void World::restorePendingChunks()
+{
+    // One read job per region file, like generation jobs
+    std::unordered_map<Magnum::Vector3i, std::vector<GenerationState*>, utils::IVec3Hasher> diskBatches;
+    std::erase_if(m_pendingRestores, [this, &diskBatches](Magnum::Vector3i const& chunkPos) {
+        // Dropped out of range meanwhile
+        auto it = m_generation.find(chunkPos);
+        if (it == m_generation.end() || !it->second.isStored())
+            return true;
+
+        // Restored once the job generating it, requested before it was saved, is done
+        auto& state = it->second;
+        if (state.isBusy())
+            return false;
+
+        if (state.saved)
+        {
+            // Sections are shared with the saved copy, which the write executor only reads
+            SPAM_LOG(DEBUG, "Restoring chunk [{}, {}] from its pending save", chunkPos.x(), chunkPos.z());
+            auto const saved = std::move(state.saved);
+            *state.chunk = saved->chunk;
+            commitStoredChunk(state, saved->decorations, LoadSource::PENDING_SAVE, saved->decoratedBy);
+        }
+        else
+        {
+            state.scheduled = GenerationStage::FINALIZED;
+            diskBatches[RegionFile::regionOf(chunkPos)].push_back(&state);
+        }
+        return true;
+    });
+
+    for (auto& chunks : diskBatches | std::views::values)
+    {
+        submitDiskJob(std::move(chunks));
+    }
+}
+
+void World::submitDiskJob(std::vector<GenerationState*> chunks)
+{
+    auto job = m_readExecutor->submit([chunks, this]() {
+        SPAM_LOG(DEBUG, "Reading {} chunk(s) from [{}, {}] on thread {}",
+            chunks.size(), chunks.front()->chunk->getPosition().x(), chunks.front()->chunk->getPosition().z(), std::this_thread::get_id());
+        for (auto* state : chunks)
+        {
+            readStoredChunk(*state);
+        }
+    });
+
+    m_diskJobs.push_back({std::move(chunks), std::move(job)});
+}
+
+void World::readStoredChunk(GenerationState& state)
+{
+    Magnum::Vector3i const chunkPos = state.chunk->getPosition();
+    try
+    {
+        state.onDisk = m_persistence->load(chunkPos, *state.chunk, state.overflow, state.decoratedBy);
+    }
+    catch (std::exception const& e)
+    {
+        LOG(ERROR, "Could not read saved chunk [{}, {}], generating it again: {}", chunkPos.x(), chunkPos.z(), e.what());
+        state.onDisk = false;
+    }
+
+    if (state.onDisk)
+        state.chunk->internSections(m_sectionTable);
+    else
+        state.chunk->reset(chunkPos);
+}
+
+bool World::integrateDiskJobs()
+{
+    bool advanced = false;
+    for (std::size_t i = 0; i < m_diskJobs.size();)
+    {
+        auto& job = m_diskJobs[i];
+        if (job.result.status() != concurrencpp::result_status::value)
+        {
+            ++i;
+            continue;
+        }
+
+        job.result.get();
+        for (auto* state : job.chunks)
+        {
+            Magnum::Vector3i const chunkPos = state->chunk->getPosition();
+            if (state->onDisk)
+            {
+                ++m_loadStats.hits;
+                commitStoredChunk(*state, std::move(state->overflow), LoadSource::DISK, state->decoratedBy);
+                continue;
+            }
+
+            // Generated from scratch instead
+            ++m_loadStats.misses;
+            ++m_loadStats.failures;
+            removeDecorationsFrom(chunkPos);
+            state->stage = GenerationStage::EMPTY;
+            state->scheduled = GenerationStage::EMPTY;
+            state->target = GenerationStage::EMPTY;
+            requestStage(chunkPos, GenerationStage::FINALIZED);
+        }
+        advanced = true;
+
+        std::swap(job, m_diskJobs.back());
+        m_diskJobs.pop_back();
+    }
+    return advanced;
+}
+
+void World::commitStoredChunk(
+    GenerationState& state,
+    std::vector<ChunkGenerator::Decoration> decorations,
+    LoadSource source,
+    uint32_t decoratedBy)
+{
+    Magnum::Vector3i const chunkPos = state.chunk->getPosition();
+    applyDecorations(chunkPos, *state.chunk, decoratedBy);
+    m_decoratedBy.insert_or_assign(chunkPos, decoratedBy);
+    removeDecorationsFrom(chunkPos);
+    addDecorations(chunkPos, std::move(decorations));
+
+    state.stage = GenerationStage::FINALIZED;
+    state.scheduled = GenerationStage::FINALIZED;
+    state.target = GenerationStage::FINALIZED;
+    state.onDisk = false;
+    m_waitingChunks.erase(chunkPos);
+    recordLoad(state, source);
+    commitChunk(chunkPos, state.chunk);
+}
+
+void World::recordLoad(GenerationState const& state, LoadSource source)
+{
+    ++m_loadStats.committed[static_cast<std::size_t>(source)];
+    auto const latency = std::chrono::steady_clock::now() - state.submitted;
+    m_loadLatency.record(latency);
+    m_sourceLatency[static_cast<std::size_t>(source)].record(latency);
+}
+
+void World::addDecorations(Magnum::Vector3i const& source, std::vector<ChunkGenerator::Decoration> overflow)
+{
+    // Features only reach the adjacent chunks, so sorting by target is a handful of groups
+    std::ranges::stable_sort(overflow, {}, [](auto const& decoration) {
+        return std::tuple{decoration.chunkPos.z(), decoration.chunkPos.x()};
+    });
+
+    for (auto first = overflow.begin(); first != overflow.end();)
+    {
+        Magnum::Vector3i const target = first->chunkPos;
+        auto const last = std::find_if(first, overflow.end(), [&target](auto const& decoration) { return decoration.chunkPos != target; });
+
+        auto& pending = m_pendingDecorations[target];
+        auto it = std::ranges::find(pending, source, &PendingDecorations::source);
+        if (it == pending.end())
+            it = pending.insert(pending.end(), {source, {}});
+        it->blocks.assign(first, last);
+
+        // A loaded neighbour is patched now, unless it holds them already (restored from a
+        // save, or patched by an earlier generation of the source); one still generating
+        // gets them when it commits
+        auto loaded = m_chunks.find(target);
+        if (loaded != m_chunks.end())
+        {
+            uint32_t& decoratedBy = m_decoratedBy[target];
+            uint32_t const bit = ChunkGenerator::decorationSourceBit(source - target);
+            if ((decoratedBy & bit) == 0)
+            {
+                ChunkGenerator::applyDecorations(*loaded->second, it->blocks);
+                loaded->second->internSections(m_sectionTable);
+                decoratedBy |= bit;
+                m_eventBus.emit(ecs::ChunkModified{target});
+            }
+        }
+        first = last;
+    }
+}
+
+void World::applyDecorations(Magnum::Vector3i const& chunkPos, Chunk& chunk, uint32_t& decoratedBy)
+{
+    auto it = m_pendingDecorations.find(chunkPos);
+    if (it == m_pendingDecorations.end())
+        return;
+
+    for (auto const& pending : it->second)
+    {
+        // Placing blocks a save already holds again would undo the edits made to them since
+        uint32_t const bit = ChunkGenerator::decorationSourceBit(pending.source - chunkPos);
+        if ((decoratedBy & bit) != 0)
+            continue;
+        ChunkGenerator::applyDecorations(chunk, pending.blocks);
+        decoratedBy |= bit;
+    }
+    chunk.internSections(m_sectionTable);
+}
+
+std::vector<ChunkGenerator::Decoration> World::decorationsFrom(Magnum::Vector3i const& source) const
+{
+    std::vector<ChunkGenerator::Decoration> decorations;
+    int const reach = ChunkGenerator::FEATURE_REACH;
+    for (int dz = -reach; dz <= reach; ++dz)
+    {
+        for (int dx = -reach; dx <= reach; ++dx)
+        {
+            auto it = m_pendingDecorations.find(source + Magnum::Vector3i{dx, 0, dz});
+            if (it == m_pendingDecorations.end())
+                continue;
+
+            auto pending = std::ranges::find(it->second, source, &PendingDecorations::source);
+            if (pending != it->second.end())
+                decorations.insert(decorations.end(), pending->blocks.begin(), pending->blocks.end());
+        }
+    }
+    return decorations;
+}
+
+void World::removeDecorationsFrom(Magnum::Vector3i const& source)
+{
+    int const reach = ChunkGenerator::FEATURE_REACH;
+    for (int dz = -reach; dz <= reach; ++dz)
+    {
+        for (int dx = -reach; dx <= reach; ++dx)
+        {
+            auto it = m_pendingDecorations.find(source + Magnum::Vector3i{dx, 0, dz});
+            if (it == m_pendingDecorations.end())
+                continue;
+
+            std::erase_if(it->second, [&source](PendingDecorations const& pending) { return pending.source == source; });
+            if (it->second.empty())
+                m_pendingDecorations.erase(it);
+        }
+    }
+}
+
 bool World::isChunkLoaded(Magnum::Vector3i const& pos) const
 {
-    return m_chunks.contains(pos);
+    return getChunk(pos) != nullptr;
 }
 
 bool World::isChunkPending(Magnum::Vector3i const& pos) const
@@ -100,7 +556,7 @@ bool World::isChunkPending(Magnum::Vector3i const& pos) const
     return m_pendingChunks.contains(pos);
 }
 
-std::unordered_map<Magnum::Vector3i, Chunk, utils::IVec3Hasher> const& World::getChunks() const
+std::unordered_map<Magnum::Vector3i, Chunk*, utils::IVec3Hasher> const& World::getChunks() const
 {
     return m_chunks;
 }
@@ -115,8 +571,19 @@ int32_t World::getSeed() const
     return m_seed;
 }
 
+ChunkGenerator const& World::getGenerator() const
+{
+    return m_generator;
+}
+
 size_t World::unloadChunksOutsideRadius(Magnum::Vector3i const& centerChunk, uint8_t radius)
 {
+    size_t const dropped = dropGenerationOutsideRadius(centerChunk, radius);
+    if (dropped > 0)
+    {
+        SPAM_LOG(DEBUG, "Dropped {} chunks still generating outside radius {}", dropped, radius);
+    }
+
     auto chunksToUnload = findChunksToUnload(centerChunk, radius);
 
     if (chunksToUnload.empty())
@@ -128,24 +595,35 @@ size_t World::unloadChunksOutsideRadius(Magnum::Vector3i const& centerChunk, uin
 
     for (auto const& chunkPos : chunksToUnload)
     {
-        // TODO: Save dirty chunks to disk before unloading
-        if (m_dirtyChunks.contains(chunkPos))
+        // Modified chunks are moved to the persistence, which writes them behind
+        if (m_dirtyChunks.erase(chunkPos) > 0 && m_persistence)
+            saveChunk(chunkPos, true);
+        m_decoratedBy.erase(chunkPos);
+
+        // Hand the chunk back to the pool for reuse by a later load
+        if (auto it = m_chunks.find(chunkPos); it != m_chunks.end())
         {
-            SPAM_LOG(DEBUG, "TODO: Save dirty chunk [{}, {}] to disk", chunkPos.x(), chunkPos.z());
-            // ChunkSerializer::saveChunkAsync(*m_chunks[chunkPos], m_worldSavePath);
-            m_dirtyChunks.erase(chunkPos);
+            m_chunkPool.release(it->second);
+            m_chunks.erase(it);
+            m_chunkGrid.set(chunkPos, nullptr);
         }
-
-        // Remove chunk from memory
-        m_chunks.erase(chunkPos);
+        m_generation.erase(chunkPos);
+        removeDecorationsFrom(chunkPos);
 
         // Emit event so systems can clean up related data
         m_eventBus.emit(ecs::ChunkUnloaded{chunkPos});
 
         SPAM_LOG(DEBUG, "Unloaded chunk [{}, {}]", chunkPos.x(), chunkPos.z());
     }
-
-    LOG(INFO, "Chunks remaining in memory: {}", m_chunks.size());
+    if (m_persistence)
+        m_persistence->flush();
+
+    auto const& poolStats = m_chunkPool.getStats();
+    LOG(INFO, "Chunks remaining in memory: {} (pool occupancy {:.0f}%, reuse rate {:.0f}%, climate cache hit rate {:.0f}%)",
+        m_chunks.size(),
+        poolStats.occupancy() * 100.0,
+        poolStats.reuseRate() * 100.0,
+        m_generator.getClimateMap().getStats().hitRate() * 100.0);
     return chunksToUnload.size();
 }
 
@@ -170,11 +648,83 @@ std::vector<Magnum::Vector3i> World::findChunksToUnload(Magnum::Vector3i const&
     return toUnload;
 }
 
+size_t World::dropGenerationOutsideRadius(Magnum::Vector3i const& centerChunk, int radius)
+{
+    std::vector<Magnum::Vector3i> toDrop;
+    for (auto const& [chunkPos, state] : m_generation)
+    {
+        int const dx = chunkPos.x() - centerChunk.x();
+        int const dz = chunkPos.z() - centerChunk.z();
+        if (dx * dx + dz * dz > radius * radius && state.stage != GenerationStage::FINALIZED && !state.isBusy())
+        {
+            toDrop.push_back(chunkPos);
+        }
+    }
+
+    for (auto const& chunkPos : toDrop)
+    {
+        auto it = m_generation.find(chunkPos);
+        if (it->second.stage >= GenerationStage::FEATURES)
+            removeDecorationsFrom(chunkPos);
+        m_chunkPool.release(it->second.chunk);
+        m_generation.erase(it);
+        m_waitingChunks.erase(chunkPos);
+        m_pendingChunks.erase(chunkPos);
+    }
+    return toDrop.size();
+}
+
 size_t World::getLoadedChunkCount() const
 {
     return m_chunks.size();
 }
 
+ChunkPool::Stats const& World::getChunkPoolStats() const
+{
+    return m_chunkPool.getStats();
+}
+
+SectionTable::Stats World::getSectionTableStats()
+{
+    return m_sectionTable.getStats();
+}
+
+ClimateMap::Stats World::getClimateStats() const
+{
+    return m_generator.getClimateMap().getStats();
+}
+
+utils::LatencyHistogram const& World::getStageTimes(GenerationStage stage) const
+{
+    return m_stageTimes[static_cast<std::size_t>(stage)];
+}
+
+utils::LatencyHistogram const& World::getLoadLatency() const
+{
+    return m_loadLatency;
+}
+
+utils::LatencyHistogram const& World::getLoadLatency(LoadSource source) const
+{
+    return m_sourceLatency[static_cast<std::size_t>(source)];
+}
+
+World::LoadStats const& World::getLoadStats() const
+{
+    return m_loadStats;
+}
+
+World::GenerationStats World::getGenerationStats() const
+{
+    GenerationStats stats;
+    stats.stageRuns = m_stageRuns;
+    for (auto const& state : m_generation | std::views::values)
+    {
+        ++stats.chunksAtStage[static_cast<std::size_t>(state.stage)];
+    }
+    return stats;
+}
+
 void World::markChunkDirty(Magnum::Vector3i const& chunkPos)
 {
     if (m_chunks.contains(chunkPos))
@@ -184,4 +734,101 @@ void World::markChunkDirty(Magnum::Vector3i const& chunkPos)
     }
 }
 
+void World::enablePersistence(
+    std::filesystem::path const& directory,
+    std::shared_ptr<concurrencpp::thread_pool_executor> readExecutor,
+    std::shared_ptr<concurrencpp::thread_pool_executor> writeExecutor,
+    CompressionSettings compression,
+    std::vector<std::byte> dictionary)
+{
+    m_readExecutor = std::move(readExecutor);
+    m_persistence = std::make_unique<ChunkPersistence>(directory / "region", std::move(writeExecutor), compression, std::move(dictionary));
+    m_lastAutosave = std::chrono::steady_clock::now();
+    auto const& compressor = m_persistence->getCompressor();
+    LOG(INFO, "Saving modified chunks into {} ({}{})", directory.string(), codec_name(compressor.getSettings().codec),
+        compressor.getDictionary().empty() ? "" : " with a dictionary");
+}
+
+void World::setAutosave(AutosaveSettings settings)
+{
+    m_autosave = settings;
+}
+
+void World::saveChunk(Magnum::Vector3i const& chunkPos, bool unloading)
+{
+    Chunk* chunk = m_chunks.at(chunkPos);
+    auto const decoratedBy = m_decoratedBy.find(chunkPos);
+    m_persistence->save(unloading ? std::move(*chunk) : Chunk{*chunk}, decorationsFrom(chunkPos),
+        decoratedBy != m_decoratedBy.end() ? decoratedBy->second : 0);
+}
+
+void World::tickAutosave()
+{
+    using clock = std::chrono::steady_clock;
+    if (!m_persistence)
+        return;
+
+    auto const start = clock::now();
+    if (m_autosaveQueue.empty() && start - m_lastAutosave >= m_autosave.interval)
+    {
+        m_lastAutosave = start;
+        m_autosaveQueue.assign(m_dirtyChunks.begin(), m_dirtyChunks.end());
+        SPAM_LOG(DEBUG, "Autosaving {} modified chunks", m_autosaveQueue.size());
+
+        // Chunks saved on unload since the last pass
+        if (m_autosaveQueue.empty())
+            m_persistence->sync();
+    }
+
+    // Copies are cheap, sections being shared copy-on-write; the write executor encodes and writes
+    bool handedOver = false;
+    while (!m_autosaveQueue.empty() && (!handedOver || clock::now() - start < m_autosave.sliceBudget))
+    {
+        Magnum::Vector3i const chunkPos = m_autosaveQueue.back();
+        m_autosaveQueue.pop_back();
+
+        // Saved on unload since the pass started
+        if (m_dirtyChunks.erase(chunkPos) == 0)
+            continue;
+
+        saveChunk(chunkPos, false);
+        handedOver = true;
+    }
+
+    if (handedOver)
+    {
+        // The pass only protects against crashes once its region files are synced
+        if (m_autosaveQueue.empty())
+            m_persistence->sync();
+        else
+            m_persistence->flush();
+        m_autosaveSlices.record(clock::now() - start);
+    }
+    m_persistence->collect();
+}
+
+void World::saveAll()
+{
+    if (!m_persistence)
+        return;
+
+    for (auto const& chunkPos : m_dirtyChunks)
+    {
+        saveChunk(chunkPos, false);
+    }
+    m_dirtyChunks.clear();
+    m_autosaveQueue.clear();
+    m_persistence->wait();
+}
+
+ChunkPersistence const* World::getPersistence() const
+{
+    return m_persistence.get();
+}
+
+utils::LatencyHistogram const& World::getAutosaveSlices() const
+{
+    return m_autosaveSlices;
+}
+
 } // namespace mc::world
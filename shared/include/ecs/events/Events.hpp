@@ -27,4 +27,12 @@ struct ChunkUnloaded
     Magnum::Vector3i position;
 };
 
+/**
+ * @brief Blocks of a loaded chunk changed, e.g. a neighbour's tree reached into it.
+ */
+struct ChunkModified
+{
+    Magnum::Vector3i position;
+};
+
 } // namespace mc::ecs
@@ -1,24 +1,60 @@
 #pragma once
 
-#include <functional>
+#include <cstddef>
+#include <cstdint>
 
 #include <Magnum/Math/Vector3.h>
 
 namespace mc::utils
 {
+
+/**
+ * @brief Spreads the low 21 bits of @p v so that two zero bits follow every bit.
+ */
+constexpr uint64_t spread_bits_by_3(uint32_t v)
+{
+    uint64_t x = v & 0x1fffff;
+    x = (x | x << 32) & 0x001f00000000ffffULL;
+    x = (x | x << 16) & 0x001f0000ff0000ffULL;
+    x = (x | x << 8) & 0x100f00f00f00f00fULL;
+    x = (x | x << 4) & 0x10c30c30c30c30c3ULL;
+    x = (x | x << 2) & 0x1249249249249249ULL;
+    return x;
+}
+
+/**
+ * @brief Interleaves the low 21 bits of each coordinate into a 63-bit Morton code.
+ *
+ * Unique for every position with coordinates in [-2^20, 2^20).
+ */
+constexpr uint64_t morton_encode(Magnum::Vector3i const& v)
+{
+    return spread_bits_by_3(static_cast<uint32_t>(v.x())) |
+        spread_bits_by_3(static_cast<uint32_t>(v.y())) << 1 |
+        spread_bits_by_3(static_cast<uint32_t>(v.z())) << 2;
+}
+
+/**
+ * @brief MurmurHash3 64-bit finalizer: every input bit affects every output bit.
+ */
+constexpr uint64_t mix64(uint64_t k)
+{
+    k ^= k >> 33;
+    k *= 0xff51afd7ed558ccdULL;
+    k ^= k >> 33;
+    k *= 0xc4ceb9fe1a85ec53ULL;
+    k ^= k >> 33;
+    return k;
+}
+
 struct IVec3Hasher
 {
+    // Morton interleaving keeps distinct nearby positions distinct (y is usually 0, and
+    // x/z span a small range), the finalizer then scatters them over all bits so both
+    // prime-modulo (std::unordered_map) and power-of-two masked (tsl) tables spread well
     std::size_t operator()(Magnum::Vector3i const& v) const
     {
-        // Hash each component individually
-        std::size_t h1 = std::hash<int>()(v.x());
-        std::size_t h2 = std::hash<int>()(v.y());
-        std::size_t h3 = std::hash<int>()(v.z());
-
-        // Combine the hashes using bitwise operations:
-        //  - XOR to blend hash bits
-        //  - shifts to spread entropy and reduce overlap
-        return h1 ^ (h2 << 1) ^ (h3 << 2);
+        return static_cast<std::size_t>(mix64(morton_encode(v)));
     }
 };
 } // namespace mc::utils
@@ -0,0 +1,128 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+
+namespace mc::utils
+{
+
+namespace detail
+{
+inline constexpr int LATENCY_SUB_BUCKET_BITS = 3;
+inline constexpr uint64_t LATENCY_SUB_BUCKETS = uint64_t{1} << LATENCY_SUB_BUCKET_BITS;
+inline constexpr std::size_t LATENCY_BUCKET_COUNT = (64 - LATENCY_SUB_BUCKET_BITS + 1) * LATENCY_SUB_BUCKETS;
+
+constexpr std::size_t latency_bucket_of(uint64_t ns)
+{
+    if (ns < LATENCY_SUB_BUCKETS)
+        return static_cast<std::size_t>(ns);
+
+    // ns >> shift lies in [LATENCY_SUB_BUCKETS, 2 * LATENCY_SUB_BUCKETS)
+    int const shift = std::bit_width(ns) - 1 - LATENCY_SUB_BUCKET_BITS;
+    return static_cast<std::size_t>((static_cast<uint64_t>(shift) + 1) * LATENCY_SUB_BUCKETS + (ns >> shift) - LATENCY_SUB_BUCKETS);
+}
+
+/**
+ * @brief Largest duration, in nanoseconds, that falls into @p bucket.
+ */
+constexpr uint64_t latency_bucket_end(std::size_t bucket)
+{
+    if (bucket < LATENCY_SUB_BUCKETS)
+        return bucket;
+
+    int const shift = static_cast<int>(bucket / LATENCY_SUB_BUCKETS) - 1;
+    uint64_t const lower = (LATENCY_SUB_BUCKETS + bucket % LATENCY_SUB_BUCKETS) << shift;
+    return lower + ((uint64_t{1} << shift) - 1);
+}
+
+static_assert(latency_bucket_of(~uint64_t{0}) == LATENCY_BUCKET_COUNT - 1);
+static_assert(latency_bucket_end(latency_bucket_of(1000)) >= 1000 && latency_bucket_end(latency_bucket_of(1000) - 1) < 1000);
+} // namespace detail
+
+/**
+ * @brief Histogram of durations, recorded lock-free from any thread.
+ *
+ * Buckets are log-linear: every power of two of nanoseconds is split into SUB_BUCKETS
+ * equal buckets, so a percentile is off by at most 1 / SUB_BUCKETS of its value while
+ * the whole range of uint64_t nanoseconds fits in a fixed array.
+ */
+class LatencyHistogram
+{
+public:
+    static constexpr uint64_t SUB_BUCKETS = detail::LATENCY_SUB_BUCKETS;
+    static constexpr std::size_t BUCKET_COUNT = detail::LATENCY_BUCKET_COUNT;
+
+    void record(std::chrono::nanoseconds duration)
+    {
+        uint64_t const ns = duration.count() > 0 ? static_cast<uint64_t>(duration.count()) : 0;
+        m_buckets[detail::latency_bucket_of(ns)].fetch_add(1, std::memory_order_relaxed);
+        m_count.fetch_add(1, std::memory_order_relaxed);
+        m_sum.fetch_add(ns, std::memory_order_relaxed);
+
+        uint64_t max = m_max.load(std::memory_order_relaxed);
+        while (ns > max && !m_max.compare_exchange_weak(max, ns, std::memory_order_relaxed)) {}
+    }
+
+    [[nodiscard]] uint64_t count() const
+    {
+        return m_count.load(std::memory_order_relaxed);
+    }
+
+    [[nodiscard]] std::chrono::nanoseconds max() const
+    {
+        return std::chrono::nanoseconds{m_max.load(std::memory_order_relaxed)};
+    }
+
+    [[nodiscard]] std::chrono::nanoseconds mean() const
+    {
+        uint64_t const n = count();
+        return std::chrono::nanoseconds{n == 0 ? 0 : m_sum.load(std::memory_order_relaxed) / n};
+    }
+
+    /**
+     * @brief Duration that a @p fraction (0 to 1) of the recorded ones do not exceed,
+     * rounded up to the end of its bucket.
+     */
+    [[nodiscard]] std::chrono::nanoseconds percentile(double fraction) const
+    {
+        uint64_t const n = count();
+        if (n == 0)
+            return std::chrono::nanoseconds{0};
+
+        auto const rank = static_cast<uint64_t>(std::ceil(fraction * static_cast<double>(n)));
+        uint64_t seen = 0;
+        for (std::size_t bucket = 0; bucket < BUCKET_COUNT; ++bucket)
+        {
+            seen += m_buckets[bucket].load(std::memory_order_relaxed);
+            if (seen >= rank && seen > 0)
+                return std::min(std::chrono::nanoseconds{detail::latency_bucket_end(bucket)}, max());
+        }
+        return max();
+    }
+
+    /**
+     * @brief Not atomic with respect to concurrent record() calls.
+     */
+    void reset()
+    {
+        for (auto& bucket : m_buckets)
+            bucket.store(0, std::memory_order_relaxed);
+        m_count.store(0, std::memory_order_relaxed);
+        m_sum.store(0, std::memory_order_relaxed);
+        m_max.store(0, std::memory_order_relaxed);
+    }
+
+private:
+    std::array<std::atomic<uint64_t>, BUCKET_COUNT> m_buckets{};
+    std::atomic<uint64_t> m_count{0};
+    std::atomic<uint64_t> m_sum{0};
+    std::atomic<uint64_t> m_max{0};
+};
+
+} // namespace mc::utils
@@ -0,0 +1,110 @@
+#pragma once
+
+#include <cstddef>
+#include <functional>
+#include <iterator>
+#include <list>
+#include <unordered_map>
+#include <utility>
+
+namespace mc::utils
+{
+
+/**
+ * @brief Fixed-capacity map that evicts its least recently used entry. Not thread-safe.
+ */
+template <typename KEY, typename VALUE, typename HASH = std::hash<KEY>>
+class LruCache
+{
+public:
+    explicit LruCache(std::size_t capacity)
+        : m_capacity{capacity > 0 ? capacity : 1}
+    {
+        m_index.reserve(m_capacity);
+    }
+
+    /**
+     * @brief Value of @p key, marked as most recently used, or nullptr.
+     *
+     * The pointer stays valid until the entry is evicted.
+     */
+    VALUE const* find(KEY const& key)
+    {
+        auto it = m_index.find(key);
+        if (it == m_index.end())
+            return nullptr;
+
+        m_entries.splice(m_entries.begin(), m_entries, it->second);
+        return &it->second->second;
+    }
+
+    /**
+     * @brief Inserts or replaces the value of @p key, evicting the oldest entry when full.
+     *
+     * @param evicted Receives the value of the evicted entry instead of it being destroyed,
+     * so that the caller can release it later
+     */
+    VALUE const& insert(KEY const& key, VALUE value, VALUE* evicted = nullptr)
+    {
+        if (auto it = m_index.find(key); it != m_index.end())
+        {
+            it->second->second = std::move(value);
+            m_entries.splice(m_entries.begin(), m_entries, it->second);
+            return it->second->second;
+        }
+
+        if (m_entries.size() == m_capacity)
+        {
+            // Reuse the evicted node instead of allocating a new one
+            m_index.erase(m_entries.back().first);
+            if (evicted != nullptr)
+                *evicted = std::move(m_entries.back().second);
+            m_entries.splice(m_entries.begin(), m_entries, std::prev(m_entries.end()));
+            m_entries.front() = {key, std::move(value)};
+        }
+        else
+        {
+            m_entries.emplace_front(key, std::move(value));
+        }
+        m_index.emplace(key, m_entries.begin());
+        return m_entries.front().second;
+    }
+
+    /**
+     * @brief Calls @p visit(key, value) on every entry, most recently used first, leaving
+     * the order as it is.
+     */
+    template <typename VISITOR>
+    void forEach(VISITOR&& visit) const
+    {
+        for (auto const& [key, value] : m_entries)
+        {
+            visit(key, value);
+        }
+    }
+
+    [[nodiscard]] std::size_t size() const
+    {
+        return m_entries.size();
+    }
+
+    [[nodiscard]] std::size_t capacity() const
+    {
+        return m_capacity;
+    }
+
+    void clear()
+    {
+        m_index.clear();
+        m_entries.clear();
+    }
+
+private:
+    using Entry = std::pair<KEY, VALUE>;
+
+    std::size_t m_capacity;
+    std::list<Entry> m_entries; ///< Most recently used first.
+    std::unordered_map<KEY, typename std::list<Entry>::iterator, HASH> m_index;
+};
+
+} // namespace mc::utils
@@ -26,6 +26,16 @@ public:
         return m_set.contains(val);
     }
 
+    /**
+     * @brief Removes a queued value; its heap entry is skipped by a later pop().
+     *
+     * @return True if the value was queued
+     */
+    bool erase(T const& value)
+    {
+        return m_set.erase(value) != 0;
+    }
+
     std::optional<T> pop()
     {
         while (!m_queue.empty())
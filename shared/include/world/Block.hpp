@@ -1,5 +1,7 @@
 #pragma once
 
+#include <array>
+#include <cstddef>
 #include <cstdint>
 
 namespace mc::world
@@ -11,21 +13,114 @@ enum class BlockType : uint16_t
     GRASS, ///< Grass-covered block; solid and opaque.
     DIRT, ///< Dirt block; solid and opaque.
     STONE, ///< Stone block; solid and opaque.
-    WATER, ///< Water block; transparent but not air.
+    WATER, ///< Water block; transparent fluid.
+    LOG, ///< Tree trunk; solid and opaque.
+    LEAVES, ///< Tree foliage; solid and opaque (rendered with the opaque leaf texture).
+    SAND, ///< Desert surface; solid and opaque.
+    SNOW, ///< Snow-covered surface of cold biomes; solid and opaque.
+
+    COUNT ///< Number of block types; not a block itself.
+};
+
+inline constexpr std::size_t BLOCK_TYPE_COUNT = static_cast<std::size_t>(BlockType::COUNT);
+
+/**
+ * @brief Per-type block properties, combined as a bitset.
+ */
+enum class BlockFlag : uint8_t
+{
+    NONE = 0,
+    SOLID = 1 << 0, ///< Collides and produces mesh faces.
+    OCCLUDING = 1 << 1, ///< Opaque: hides faces behind it and blocks light.
+    FLUID = 1 << 2, ///< Flows; never solid.
+    LIGHT_EMITTING = 1 << 3, ///< Emits light of its own.
 };
 
+constexpr BlockFlag operator|(BlockFlag lhs, BlockFlag rhs)
+{
+    return static_cast<BlockFlag>(static_cast<uint8_t>(lhs) | static_cast<uint8_t>(rhs));
+}
+
+constexpr bool has_flag(BlockFlag flags, BlockFlag flag)
+{
+    return (static_cast<uint8_t>(flags) & static_cast<uint8_t>(flag)) != 0;
+}
+
+namespace detail
+{
+constexpr BlockFlag block_flags_of(BlockType type)
+{
+    using enum BlockType;
+    switch (type)
+    {
+    case AIR: return BlockFlag::NONE;
+    case GRASS:
+    case DIRT:
+    case STONE:
+    case LOG:
+    case LEAVES:
+    case SAND:
+    case SNOW: return BlockFlag::SOLID | BlockFlag::OCCLUDING;
+    case WATER: return BlockFlag::FLUID;
+    case COUNT: break;
+    }
+    return BlockFlag::NONE;
+}
+
+constexpr std::array<BlockFlag, BLOCK_TYPE_COUNT> make_block_flags()
+{
+    std::array<BlockFlag, BLOCK_TYPE_COUNT> flags{};
+    for (std::size_t type = 0; type < BLOCK_TYPE_COUNT; ++type)
+    {
+        flags[type] = block_flags_of(static_cast<BlockType>(type));
+    }
+    return flags;
+}
+} // namespace detail
+
+/**
+ * @brief Flags of every block type, indexed by BlockType and resolved at compile time.
+ *
+ * New block types only need a case in detail::block_flags_of().
+ */
+inline constexpr std::array<BlockFlag, BLOCK_TYPE_COUNT> BLOCK_FLAGS = detail::make_block_flags();
+
+constexpr BlockFlag block_flags(BlockType type)
+{
+    return BLOCK_FLAGS[static_cast<std::size_t>(type)];
+}
+
 struct Block
 {
     BlockType type{BlockType::AIR};
 
-    [[nodiscard]] bool isTransparent() const
+    [[nodiscard]] constexpr BlockFlag flags() const
+    {
+        return block_flags(type);
+    }
+
+    [[nodiscard]] constexpr bool isTransparent() const
     {
-        return type == BlockType::AIR || type == BlockType::WATER;
+        return !has_flag(flags(), BlockFlag::OCCLUDING);
     }
 
-    [[nodiscard]] bool isSolid() const
+    [[nodiscard]] constexpr bool isSolid() const
     {
-        return type != BlockType::AIR;
+        return has_flag(flags(), BlockFlag::SOLID);
+    }
+
+    [[nodiscard]] constexpr bool isFluid() const
+    {
+        return has_flag(flags(), BlockFlag::FLUID);
+    }
+
+    [[nodiscard]] constexpr bool isLightEmitting() const
+    {
+        return has_flag(flags(), BlockFlag::LIGHT_EMITTING);
     }
 };
+
+static_assert(!Block{BlockType::AIR}.isSolid() && Block{BlockType::AIR}.isTransparent());
+static_assert(Block{BlockType::STONE}.isSolid() && !Block{BlockType::STONE}.isTransparent());
+static_assert(Block{BlockType::WATER}.isFluid() && Block{BlockType::WATER}.isTransparent());
 } // namespace mc::world
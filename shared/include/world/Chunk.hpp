@@ -1,36 +1,262 @@
 #pragma once
 
 #include "world/Block.hpp"
+#include "world/ChunkSection.hpp"
 
 #include <array>
+#include <bitset>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <span>
 
 #include <Magnum/Math/Vector3.h>
 
 namespace mc::world
 {
 
+class SectionTable;
+
 constexpr int CHUNK_SIZE_X = 16;
 constexpr int CHUNK_SIZE_Y = 256;
 constexpr int CHUNK_SIZE_Z = 16;
+constexpr int CHUNK_SLICE_AREA = CHUNK_SIZE_X * CHUNK_SIZE_Z;
+constexpr int CHUNK_VOLUME = CHUNK_SLICE_AREA * CHUNK_SIZE_Y;
+constexpr int CHUNK_SECTION_COUNT = CHUNK_SIZE_Y / SECTION_SIZE;
+
+/// Height reported for a column that has no block matching the heightmap.
+constexpr int NO_HEIGHT = -1;
+
+enum class HeightmapType : uint8_t
+{
+    HIGHEST_SOLID = 0, ///< Highest block with BlockFlag::SOLID (fluids excluded).
+    HIGHEST_NON_TRANSPARENT, ///< Highest block that is not transparent (light cannot pass).
+    COUNT
+};
 
+/// One bit per block of a column, bit y % 64 of word y / 64.
+using ColumnMask = std::array<uint64_t, CHUNK_SIZE_Y / 64>;
+
+static_assert(CHUNK_SIZE_X == SECTION_SIZE && CHUNK_SIZE_Z == SECTION_SIZE, "A section must span the whole chunk horizontally");
+
+/**
+ * @brief A 16x256x16 column of blocks, stored as vertical sections.
+ *
+ * Blocks follow a single linear order, x fastest, then z, then y (see blockIndex()):
+ * a horizontal slice is one contiguous run of CHUNK_SLICE_AREA blocks, a section one
+ * contiguous run of SECTION_VOLUME blocks, and a column strides by CHUNK_SLICE_AREA.
+ * Loops over blocks should nest y, z, x (x innermost) to walk storage in order.
+ *
+ * Per-column heightmaps are kept up to date by every write, so callers can bound their
+ * Y loops by the actual terrain height instead of scanning up to CHUNK_SIZE_Y.
+ *
+ * Bulk edits and queries (fillRegion(), replaceBlocks(), countBlocks(), buildColumnMasks())
+ * work on whole sections and packed words instead of going block by block.
+ *
+ * Sections are shared copy-on-write: all-air sections point at one common instance,
+ * internSections() shares identical sections between chunks, and a write to a shared
+ * section copies it first. Copying a chunk is therefore cheap.
+ */
 class Chunk
 {
 public:
-    using block_volume = std::array<std::array<std::array<Block, CHUNK_SIZE_Z>, CHUNK_SIZE_Y>, CHUNK_SIZE_X>;
-
     explicit Chunk(Magnum::Vector3i const& position);
 
+    /**
+     * @brief Turns the chunk back into an all-air chunk at a new position, for reuse.
+     */
+    void reset(Magnum::Vector3i const& position);
+
     [[nodiscard]] Magnum::Vector3i const& getPosition() const;
 
+    /// @throws std::out_of_range if the local coordinates fall outside the chunk.
     [[nodiscard]] Block getBlock(int x, int y, int z) const;
+    /// @throws std::out_of_range if the local coordinates fall outside the chunk.
     void setBlock(int x, int y, int z, Block block);
 
+    /**
+     * @brief Hot-path accessors without range checks.
+     *
+     * Coordinates must be inside the chunk; this is only asserted in debug builds.
+     */
+    [[nodiscard]] Block getBlockUnchecked(int x, int y, int z) const
+    {
+        assert(isInBounds(x, y, z));
+        return m_sections[y / SECTION_SIZE]->getBlock(x, y % SECTION_SIZE, z);
+    }
+
+    void setBlockUnchecked(int x, int y, int z, Block block)
+    {
+        assert(isInBounds(x, y, z));
+        writableSection(y / SECTION_SIZE).setBlock(x, y % SECTION_SIZE, z, block);
+        updateHeightmaps(x, y, z, block);
+    }
+
+    /**
+     * @brief Copies the column at (x, z) into @p out, bottom to top.
+     */
+    void column(int x, int z, std::span<Block, CHUNK_SIZE_Y> out) const;
+    void setColumn(int x, int z, std::span<Block const, CHUNK_SIZE_Y> blocks);
+
+    /**
+     * @brief Copies the horizontal slice at height @p y into @p out, x fastest then z.
+     */
+    void slice(int y, std::span<Block, CHUNK_SLICE_AREA> out) const;
+    void setSlice(int y, std::span<Block const, CHUNK_SLICE_AREA> blocks);
+
+    /**
+     * @brief Vertical 16-block section of the chunk.
+     *
+     * @param index Section index, from 0 (bottom) to CHUNK_SECTION_COUNT - 1 (top).
+     */
+    [[nodiscard]] ChunkSection const& getSection(int index) const;
+
+    /**
+     * @brief Replaces every block of a section in O(1) (plus a heightmap update).
+     */
+    void fillSection(int index, Block block);
+
+    /**
+     * @brief Section @p index, replaced by an all-air section owned by this chunk, for
+     * decoders that write a whole section at once.
+     *
+     * Heightmaps are left as they are; call rebuildHeightmaps() once every section is written.
+     */
+    ChunkSection& replaceSection(int index);
+
+    /**
+     * @brief Recomputes every heightmap from the blocks, after replaceSection().
+     */
+    void rebuildHeightmaps();
+
+    /**
+     * @brief Sets every block in the box [min, max] (inclusive, local coordinates).
+     *
+     * Sections covered entirely are filled in O(1), the others one storage run at a time.
+     * A box with min > max on any axis is empty.
+     *
+     * @throws std::out_of_range if a corner falls outside the chunk.
+     */
+    void fillRegion(Magnum::Vector3i const& min, Magnum::Vector3i const& max, Block block);
+
+    /**
+     * @brief Turns every block of type @p from into @p to.
+     *
+     * Sections without @p from are left untouched; the others only rewrite their palette
+     * or, when @p to is already present, their packed indices.
+     */
+    void replaceBlocks(BlockType from, BlockType to);
+
+    /**
+     * @brief Number of blocks of a type, from the palette reference counts of each section.
+     */
+    [[nodiscard]] std::size_t countBlocks(BlockType type) const;
+    [[nodiscard]] std::array<std::size_t, BLOCK_TYPE_COUNT> countBlocksByType() const;
+
+    /**
+     * @brief Builds a 256-bit mask per column of the blocks having @p flag.
+     *
+     * BlockFlag::SOLID gives occupancy masks and BlockFlag::OCCLUDING opacity masks.
+     *
+     * @param out Masks indexed z * CHUNK_SIZE_X + x
+     */
+    void buildColumnMasks(BlockFlag flag, std::span<ColumnMask, CHUNK_SLICE_AREA> out) const;
+
+    /**
+     * @brief Y of the highest block of column (x, z) matching the heightmap, or NO_HEIGHT.
+     */
+    [[nodiscard]] int getHeight(HeightmapType type, int x, int z) const
+    {
+        assert(isInBounds(x, 0, z));
+        return m_heightmaps[static_cast<std::size_t>(type)][static_cast<std::size_t>(z) * CHUNK_SIZE_X + x];
+    }
+
+    /**
+     * @brief Highest getHeight() over all columns of the chunk, or NO_HEIGHT.
+     */
+    [[nodiscard]] int getMaxHeight(HeightmapType type) const;
+
+    /**
+     * @brief Shares every section with identical sections already interned in @p table.
+     *
+     * Interned sections become immutable and are copied on the next write.
+     */
+    void internSections(SectionTable& table);
+
+    /**
+     * @brief Number of sections this chunk shares with other chunks or the table.
+     */
+    [[nodiscard]] int getSharedSectionCount() const;
+
+    /**
+     * @brief Approximate memory used by this chunk and the sections it owns, in bytes.
+     *
+     * Interned sections and the common air section are not included; SectionTable
+     * accounts for interned ones.
+     */
+    [[nodiscard]] std::size_t memoryUsage() const;
+
     static Magnum::Vector3i getChunkOfPosition(Magnum::Vector3i const& position);
     static Magnum::Vector3i getChunkOfPosition(Magnum::Vector3d const& position);
 
+    /**
+     * @brief Linear index of a block in the documented storage order.
+     */
+    static constexpr std::size_t blockIndex(int x, int y, int z)
+    {
+        return (static_cast<std::size_t>(y) * CHUNK_SIZE_Z + z) * CHUNK_SIZE_X + x;
+    }
+
+    static constexpr bool isInBounds(int x, int y, int z)
+    {
+        return x >= 0 && x < CHUNK_SIZE_X && y >= 0 && y < CHUNK_SIZE_Y && z >= 0 && z < CHUNK_SIZE_Z;
+    }
+
 private:
+    static void checkBounds(int x, int y, int z);
+    static bool matchesHeightmap(HeightmapType type, Block block);
+    static BlockFlag heightmapFlag(HeightmapType type);
+
+    void updateHeightmaps(int x, int y, int z, Block block);
+
+    /**
+     * @brief Section @p index, copied first if it is shared so that it can be modified.
+     */
+    ChunkSection& writableSection(int index)
+    {
+        auto& section = m_sections[index];
+        if (m_immutableSections.test(index) || section.use_count() != 1)
+        {
+            section = std::make_shared<ChunkSection>(*section);
+            m_immutableSections.reset(index);
+        }
+        return *section;
+    }
+
+    /**
+     * @brief Replaces section @p index with a uniform one without copying the old contents.
+     */
+    void resetSection(int index, Block block);
+
+    /**
+     * @brief Recomputes one heightmap for every column from column masks.
+     */
+    void rebuildHeightmap(HeightmapType type);
+
+    /**
+     * @brief Scans column (x, z) downwards from @p fromY for the highest matching block.
+     */
+    [[nodiscard]] int16_t findHighest(HeightmapType type, int x, int z, int fromY) const;
+
+private:
+    using heightmap = std::array<int16_t, CHUNK_SLICE_AREA>;
+    static constexpr std::size_t HEIGHTMAP_COUNT = static_cast<std::size_t>(HeightmapType::COUNT);
+
     Magnum::Vector3i m_position; ///< Chunk position in chunk-space (not world-space).
-    block_volume m_blocks; ///< 3D grid of blocks within the chunk.
+    std::array<std::shared_ptr<ChunkSection>, CHUNK_SECTION_COUNT> m_sections; ///< Vertical sections, bottom to top.
+    std::bitset<CHUNK_SECTION_COUNT> m_immutableSections; ///< Sections that must never be written in place (interned or the common air section).
+    std::array<heightmap, HEIGHTMAP_COUNT> m_heightmaps; ///< Per-column heights, indexed z * CHUNK_SIZE_X + x.
 };
 
 } // namespace mc::world
@@ -0,0 +1,100 @@
+#pragma once
+
+#include "world/Block.hpp"
+#include "world/PalettedContainer.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+
+namespace mc::world
+{
+
+constexpr int SECTION_SIZE = 16;
+constexpr int SECTION_AREA = SECTION_SIZE * SECTION_SIZE;
+constexpr int SECTION_VOLUME = SECTION_AREA * SECTION_SIZE;
+constexpr int SECTION_MASK_WORDS = SECTION_VOLUME / 64; ///< Words of a one-bit-per-block section mask.
+
+/**
+ * @brief A 16x16x16 cube of blocks, the vertical building unit of a chunk.
+ *
+ * A section whose palette holds a single block type is uniform: it keeps no index
+ * data, and callers can skip it in O(1) via isEmpty()/isUniform().
+ *
+ * Blocks are stored x fastest, then z, then y: index = (y * 16 + z) * 16 + x.
+ * Coordinates are not range-checked; Chunk validates them.
+ */
+class ChunkSection
+{
+public:
+    ChunkSection() = default;
+
+    [[nodiscard]] Block getBlock(int x, int y, int z) const;
+    void setBlock(int x, int y, int z, Block block);
+
+    /// @brief Copies the horizontal slice at local @p y into @p out, x fastest.
+    void getSlice(int y, std::span<Block, SECTION_AREA> out) const;
+    void setSlice(int y, std::span<Block const, SECTION_AREA> blocks);
+
+    /// @brief Copies the 16 blocks of column (x, z) into @p out, bottom to top.
+    void getColumn(int x, int z, std::span<Block, SECTION_SIZE> out) const;
+    void setColumn(int x, int z, std::span<Block const, SECTION_SIZE> blocks);
+
+    /**
+     * @brief Replaces every block of the section, turning it into a uniform section.
+     */
+    void fill(Block block);
+
+    /**
+     * @brief Sets every block in the box [min, max] (inclusive, local coordinates).
+     *
+     * Runs of blocks that are contiguous in storage, and single columns, are written in one go.
+     */
+    void fillBox(int minX, int minY, int minZ, int maxX, int maxY, int maxZ, Block block);
+
+    /// @brief Turns every block of type @p from into @p to.
+    void replace(BlockType from, BlockType to);
+
+    /// @return Number of blocks of the given type.
+    [[nodiscard]] std::size_t count(BlockType type) const;
+    /// @brief Adds the number of blocks of every type to @p counts, indexed by BlockType.
+    void countAll(std::span<std::size_t, BLOCK_TYPE_COUNT> counts) const;
+
+    /**
+     * @brief Sets bit toIndex(x, y, z) of @p out when that block has @p flag.
+     */
+    void matchFlag(BlockFlag flag, std::span<uint64_t, SECTION_MASK_WORDS> out) const;
+
+    /// @return True if every block of the section is air.
+    [[nodiscard]] bool isEmpty() const;
+    /// @return True if every block of the section has the same type.
+    [[nodiscard]] bool isUniform() const;
+    /// @return True if every block of the section is the same solid type.
+    [[nodiscard]] bool isUniformSolid() const;
+    /// @return The only block of a uniform section; meaningless otherwise.
+    [[nodiscard]] Block getUniformBlock() const;
+
+    /**
+     * @brief Palette-compressed storage, in toIndex() order, for codecs that read or
+     * write the palette and indices directly (see ChunkSerializer).
+     */
+    [[nodiscard]] PalettedContainer const& getBlocks() const;
+    [[nodiscard]] PalettedContainer& getBlocks();
+
+    [[nodiscard]] std::size_t memoryUsage() const;
+
+    /// @brief Hash of the encoded blocks, for interning identical sections (see SectionTable).
+    [[nodiscard]] uint64_t contentHash() const;
+    bool operator==(ChunkSection const& other) const = default;
+
+private:
+    static constexpr std::size_t toIndex(int x, int y, int z)
+    {
+        return (static_cast<std::size_t>(y) * SECTION_SIZE + z) * SECTION_SIZE + x;
+    }
+
+private:
+    PalettedContainer m_blocks{SECTION_VOLUME}; ///< Palette-compressed blocks, all air by default.
+};
+
+} // namespace mc::world
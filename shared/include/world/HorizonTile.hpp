@@ -0,0 +1,71 @@
+#pragma once
+
+#include "world/Block.hpp"
+#include "world/Chunk.hpp"
+
+#include <array>
+#include <cstdint>
+
+#include <Magnum/Math/Vector3.h>
+
+namespace mc::world
+{
+
+inline constexpr int HORIZON_TILE_CELLS = 16; ///< Cells along each side of a tile.
+inline constexpr int HORIZON_TILE_SAMPLES = HORIZON_TILE_CELLS + 1; ///< Samples along each side; the last row and column are shared with the next tiles.
+inline constexpr int HORIZON_BASE_STEP = 4; ///< Blocks between samples on level 0; doubles with every level.
+
+static_assert(CHUNK_SIZE_Y <= 256, "horizon heights are stored in a byte");
+static_assert(BLOCK_TYPE_COUNT <= 256, "horizon surface blocks are stored in a byte");
+
+/**
+ * @brief Blocks between the samples of a horizon tile on @p level.
+ */
+constexpr int horizon_step(int level)
+{
+    return HORIZON_BASE_STEP << level;
+}
+
+/**
+ * @brief Blocks covered by each side of a horizon tile on @p level.
+ */
+constexpr int horizon_tile_side(int level)
+{
+    return HORIZON_TILE_CELLS * horizon_step(level);
+}
+
+/**
+ * @brief Coarse surface of a square of distant terrain, for horizon meshes.
+ *
+ * Tiles of a level form a grid aligned on world (0, 0); their key holds the tile's
+ * grid position in x and z and its level in y. A tile is a few hundred bytes whatever
+ * the area it covers.
+ */
+struct HorizonTile
+{
+    Magnum::Vector3i key; ///< {tile x, level, tile z}.
+    std::array<uint8_t, HORIZON_TILE_SAMPLES * HORIZON_TILE_SAMPLES> heights{}; ///< Highest terrain block of each sample, x fastest.
+    std::array<uint8_t, HORIZON_TILE_SAMPLES * HORIZON_TILE_SAMPLES> surface{}; ///< BlockType on top of each sample.
+
+    [[nodiscard]] int level() const { return key.y(); }
+
+    /**
+     * @brief World position of the first sample, at y 0.
+     */
+    [[nodiscard]] Magnum::Vector3i origin() const
+    {
+        return {key.x() * horizon_tile_side(level()), 0, key.z() * horizon_tile_side(level())};
+    }
+
+    [[nodiscard]] int heightAt(int sampleX, int sampleZ) const
+    {
+        return heights[sampleZ * HORIZON_TILE_SAMPLES + sampleX];
+    }
+
+    [[nodiscard]] BlockType surfaceAt(int sampleX, int sampleZ) const
+    {
+        return static_cast<BlockType>(surface[sampleZ * HORIZON_TILE_SAMPLES + sampleX]);
+    }
+};
+
+} // namespace mc::world
@@ -0,0 +1,50 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+
+namespace mc::world::packed
+{
+
+/**
+ * @brief Kernels over bit-packed fields as stored by PalettedContainer.
+ *
+ * Fields are 1, 2, 4, 8 or 16 bits wide, 64 / bits per word, never straddling a word,
+ * with field i of a word at bit i * bits. Every kernel has a portable scalar version
+ * working on whole words at a time and an AVX2 version picked at runtime when the CPU
+ * supports it; both produce identical results.
+ */
+enum class Isa : uint8_t
+{
+    SCALAR,
+    AVX2,
+};
+
+/**
+ * @brief Fastest instruction set supported by the running CPU, detected once.
+ */
+[[nodiscard]] Isa best_isa();
+
+/**
+ * @brief Rewrites every field equal to @p from as @p to.
+ *
+ * @param count Number of fields in use; unused trailing fields of the last word are left alone.
+ */
+void replace(std::span<uint64_t> words, uint8_t bits, std::size_t count, uint16_t from, uint16_t to, Isa isa = best_isa());
+
+/**
+ * @brief Sets bit i of @p out to whether lut[field i] is non-zero, clearing all other bits.
+ *
+ * @param lut One byte per possible field value in use (typically per palette entry)
+ * @param out At least (count + 63) / 64 words
+ */
+void match(
+    std::span<uint64_t const> words,
+    uint8_t bits,
+    std::size_t count,
+    std::span<uint8_t const> lut,
+    std::span<uint64_t> out,
+    Isa isa = best_isa());
+
+} // namespace mc::world::packed
@@ -0,0 +1,161 @@
+#pragma once
+
+#include "world/Block.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace mc::world
+{
+
+/**
+ * @brief Palette-compressed storage for a fixed number of blocks.
+ *
+ * Every distinct block type is stored once in a palette; the container itself only
+ * keeps bit-packed palette indices. The index width grows when a new type does not
+ * fit into the palette and shrinks again once enough palette entries fall out of use
+ * to leave a free entry at the narrower width. A container holding a single block type
+ * keeps no index data at all.
+ */
+class PalettedContainer
+{
+public:
+    explicit PalettedContainer(std::size_t size, Block fill = {});
+
+    [[nodiscard]] Block get(std::size_t index) const;
+    void set(std::size_t index, Block block);
+
+    /**
+     * @brief Decodes out.size() blocks starting at @p first, @p stride entries apart.
+     */
+    void getStrided(std::size_t first, std::size_t stride, std::span<Block> out) const;
+
+    /**
+     * @brief Writes blocks.size() blocks starting at @p first, @p stride entries apart.
+     */
+    void setStrided(std::size_t first, std::size_t stride, std::span<Block const> blocks);
+
+    /**
+     * @brief Sets every block to the same type and releases the index data.
+     */
+    void fill(Block block);
+
+    /**
+     * @brief Sets @p count consecutive blocks starting at @p first to the same type.
+     */
+    void fillRange(std::size_t first, std::size_t count, Block block);
+
+    /**
+     * @brief Sets @p count blocks starting at @p first, @p stride entries apart, to the same type.
+     */
+    void fillStrided(std::size_t first, std::size_t stride, std::size_t count, Block block);
+
+    /**
+     * @brief Turns every block of type @p from into @p to.
+     *
+     * Renames the palette entry when @p to is not present yet; otherwise rewrites the
+     * packed indices a word at a time (see packed::replace).
+     */
+    void replace(BlockType from, BlockType to);
+
+    /**
+     * @brief Number of blocks of the given type, read from the palette reference counts.
+     */
+    [[nodiscard]] std::size_t count(BlockType type) const;
+
+    /**
+     * @brief Adds the number of blocks of every type to @p counts, indexed by BlockType.
+     */
+    void countAll(std::span<std::size_t, BLOCK_TYPE_COUNT> counts) const;
+
+    /**
+     * @brief Sets bit i of @p out when block i has @p flag.
+     *
+     * @param out At least (size() + 63) / 64 words
+     */
+    void matchFlag(BlockFlag flag, std::span<uint64_t> out) const;
+
+    /**
+     * @brief Palette entries as stored, unreferenced ones included (see paletteCount()).
+     */
+    [[nodiscard]] std::span<BlockType const> palette() const;
+
+    /// @return Number of blocks referencing palette entry @p paletteIndex.
+    [[nodiscard]] uint32_t paletteCount(uint16_t paletteIndex) const;
+
+    /// @return Palette entry block @p index references.
+    [[nodiscard]] uint16_t paletteIndexAt(std::size_t index) const;
+
+    /**
+     * @brief End of the run of blocks starting at @p first that reference the same palette
+     * entry, comparing whole packed words where the run covers them.
+     */
+    [[nodiscard]] std::size_t runEnd(std::size_t first) const;
+
+    /**
+     * @brief Replaces the contents with a new palette, every block referencing its first
+     * entry, so that a decoder can write indices straight into the packed storage.
+     *
+     * @param palette Between 1 and 65536 distinct block types
+     */
+    void assignPalette(std::span<BlockType const> palette);
+
+    /**
+     * @brief Sets @p count consecutive blocks starting at @p first to an existing palette
+     * entry, keeping the palette as it is.
+     */
+    void fillIndexRange(std::size_t first, std::size_t count, uint16_t paletteIndex);
+
+    [[nodiscard]] std::size_t size() const;
+    [[nodiscard]] std::size_t paletteSize() const;
+    [[nodiscard]] uint8_t bitsPerEntry() const;
+
+    /**
+     * @brief Approximate heap + inline memory used by this container, in bytes.
+     */
+    [[nodiscard]] std::size_t memoryUsage() const;
+
+    /**
+     * @brief Hash of the encoded contents, consistent with operator==.
+     */
+    [[nodiscard]] uint64_t contentHash() const;
+
+    /**
+     * @brief True when both containers hold the same blocks with the same encoding.
+     *
+     * Containers with equal blocks but a different palette order compare unequal.
+     */
+    bool operator==(PalettedContainer const& other) const = default;
+
+private:
+    [[nodiscard]] uint16_t readIndex(std::size_t index) const;
+    void writeIndex(std::size_t index, uint16_t paletteIndex);
+
+    uint16_t acquirePaletteIndex(BlockType type);
+    void releasePaletteIndex(uint16_t paletteIndex);
+
+    /**
+     * @brief Re-packs to a narrower width once the live entries fit it with room to spare.
+     */
+    void shrinkIfSparse();
+
+    /**
+     * @brief Re-packs all indices with a new width, dropping unused palette entries.
+     */
+    void repack(uint8_t bits);
+
+    static uint8_t bitsForPalette(std::size_t paletteSize);
+
+private:
+    std::size_t m_size; ///< Number of blocks stored.
+    uint8_t m_bits{0}; ///< Bits per packed index (0, 1, 2, 4, 8 or 16).
+    uint8_t m_entriesPerWordLog2{0}; ///< log2(64 / m_bits), used to locate an index without dividing.
+    std::size_t m_liveEntries{1}; ///< Palette entries with a non-zero reference count.
+    std::vector<BlockType> m_palette; ///< Distinct block types referenced by indices.
+    std::vector<uint32_t> m_counts; ///< Reference count of every palette entry.
+    std::vector<uint64_t> m_data; ///< Bit-packed palette indices, never straddling a word.
+};
+
+} // namespace mc::world
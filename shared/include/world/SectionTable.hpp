@@ -0,0 +1,56 @@
+#pragma once
+
+#include "world/ChunkSection.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+
+namespace mc::world
+{
+
+/**
+ * @brief Thread-safe table of interned chunk sections, keyed by content hash.
+ *
+ * Chunks hand their sections to intern() once they are built; identical sections
+ * (same blocks with the same palette encoding) then share one immutable instance.
+ * The table only holds weak references, so a section is freed as soon as the last
+ * chunk using it drops it. Chunks copy an interned section before modifying it.
+ */
+class SectionTable
+{
+public:
+    struct Stats
+    {
+        std::size_t lookups = 0; ///< Sections passed to intern().
+        std::size_t hits = 0; ///< Lookups answered with an already interned section.
+        std::size_t uniqueSections = 0; ///< Interned sections still in use.
+        std::size_t memoryUsage = 0; ///< Bytes held by the interned sections still in use.
+    };
+
+    /**
+     * @brief Returns the interned section equal to @p section, registering it if none exists.
+     */
+    [[nodiscard]] std::shared_ptr<ChunkSection> intern(std::shared_ptr<ChunkSection> section);
+
+    /**
+     * @brief Current statistics; also drops entries of sections no longer in use.
+     */
+    [[nodiscard]] Stats getStats();
+
+private:
+    void removeExpired();
+
+private:
+    static constexpr std::size_t SWEEP_INTERVAL = 4096; ///< intern() calls between sweeps of expired entries.
+
+    std::mutex m_mutex;
+    std::unordered_multimap<uint64_t, std::weak_ptr<ChunkSection>> m_sections; ///< Interned sections by content hash.
+    std::size_t m_lookups = 0;
+    std::size_t m_hits = 0;
+    std::size_t m_sinceSweep = 0;
+};
+
+} // namespace mc::world
@@ -2,15 +2,49 @@
 
 #include "Magnum/Math/Functions.h"
 #include "utils/FastDivFloor.hpp"
+#include "world/SectionTable.hpp"
 
-#include <array>
+#include <algorithm>
+#include <bit>
+#include <stdexcept>
 
 namespace mc::world
 {
 
+namespace
+{
+/// All-air section shared by every chunk until it gets written to.
+std::shared_ptr<ChunkSection> const& empty_section()
+{
+    static auto const section = std::make_shared<ChunkSection>();
+    return section;
+}
+
+/// True when writing @p blocks into @p section cannot change it, so a shared section need not be copied.
+bool is_noop_write(ChunkSection const& section, std::span<Block const> blocks)
+{
+    if (!section.isUniform()) return false;
+    BlockType const type = section.getUniformBlock().type;
+    return std::ranges::all_of(blocks, [type](Block block) { return block.type == type; });
+}
+} // namespace
+
 Chunk::Chunk(Magnum::Vector3i const& position)
     : m_position(position)
-{}
+{
+    reset(position);
+}
+
+void Chunk::reset(Magnum::Vector3i const& position)
+{
+    m_position = position;
+    m_sections.fill(empty_section());
+    m_immutableSections.set();
+    for (auto& heights : m_heightmaps)
+    {
+        heights.fill(NO_HEIGHT);
+    }
+}
 
 Magnum::Vector3i const& Chunk::getPosition() const
 {
@@ -19,12 +53,355 @@ Magnum::Vector3i const& Chunk::getPosition() const
 
 Block Chunk::getBlock(int x, int y, int z) const
 {
-    return m_blocks.at(x).at(y).at(z);
+    checkBounds(x, y, z);
+    return m_sections[y / SECTION_SIZE]->getBlock(x, y % SECTION_SIZE, z);
 }
 
 void Chunk::setBlock(int x, int y, int z, Block block)
 {
-    m_blocks.at(x).at(y).at(z) = block;
+    checkBounds(x, y, z);
+    setBlockUnchecked(x, y, z, block);
+}
+
+void Chunk::column(int x, int z, std::span<Block, CHUNK_SIZE_Y> out) const
+{
+    checkBounds(x, 0, z);
+    for (int i = 0; i < CHUNK_SECTION_COUNT; ++i)
+    {
+        m_sections[i]->getColumn(x, z, out.subspan(i * SECTION_SIZE).first<SECTION_SIZE>());
+    }
+}
+
+void Chunk::setColumn(int x, int z, std::span<Block const, CHUNK_SIZE_Y> blocks)
+{
+    checkBounds(x, 0, z);
+    for (int i = 0; i < CHUNK_SECTION_COUNT; ++i)
+    {
+        auto const sectionBlocks = blocks.subspan(i * SECTION_SIZE).first<SECTION_SIZE>();
+        if (!is_noop_write(*m_sections[i], sectionBlocks))
+            writableSection(i).setColumn(x, z, sectionBlocks);
+    }
+
+    for (std::size_t type = 0; type < HEIGHTMAP_COUNT; ++type)
+    {
+        m_heightmaps[type][static_cast<std::size_t>(z) * CHUNK_SIZE_X + x] = findHighest(static_cast<HeightmapType>(type), x, z, CHUNK_SIZE_Y - 1);
+    }
+}
+
+void Chunk::slice(int y, std::span<Block, CHUNK_SLICE_AREA> out) const
+{
+    checkBounds(0, y, 0);
+    m_sections[y / SECTION_SIZE]->getSlice(y % SECTION_SIZE, out);
+}
+
+void Chunk::setSlice(int y, std::span<Block const, CHUNK_SLICE_AREA> blocks)
+{
+    checkBounds(0, y, 0);
+    if (!is_noop_write(*m_sections[y / SECTION_SIZE], blocks))
+        writableSection(y / SECTION_SIZE).setSlice(y % SECTION_SIZE, blocks);
+
+    for (int z = 0; z < CHUNK_SIZE_Z; ++z)
+    {
+        for (int x = 0; x < CHUNK_SIZE_X; ++x)
+        {
+            updateHeightmaps(x, y, z, blocks[static_cast<std::size_t>(z) * CHUNK_SIZE_X + x]);
+        }
+    }
+}
+
+ChunkSection const& Chunk::getSection(int index) const
+{
+    return *m_sections.at(index);
+}
+
+void Chunk::fillSection(int index, Block block)
+{
+    resetSection(index, block);
+
+    int const sectionMinY = index * SECTION_SIZE;
+    int const sectionMaxY = sectionMinY + SECTION_SIZE - 1;
+    for (std::size_t type = 0; type < HEIGHTMAP_COUNT; ++type)
+    {
+        auto const heightmapType = static_cast<HeightmapType>(type);
+        bool const matches = matchesHeightmap(heightmapType, block);
+        for (int z = 0; z < CHUNK_SIZE_Z; ++z)
+        {
+            for (int x = 0; x < CHUNK_SIZE_X; ++x)
+            {
+                int16_t& height = m_heightmaps[type][static_cast<std::size_t>(z) * CHUNK_SIZE_X + x];
+                if (matches)
+                    height = std::max<int16_t>(height, sectionMaxY);
+                else if (height >= sectionMinY && height <= sectionMaxY)
+                    height = findHighest(heightmapType, x, z, sectionMinY - 1);
+            }
+        }
+    }
+}
+
+ChunkSection& Chunk::replaceSection(int index)
+{
+    auto& section = m_sections.at(index);
+    if (m_immutableSections.test(index) || section.use_count() != 1)
+    {
+        section = std::make_shared<ChunkSection>();
+        m_immutableSections.reset(index);
+    }
+    else
+    {
+        section->fill(Block{});
+    }
+    return *section;
+}
+
+void Chunk::rebuildHeightmaps()
+{
+    for (std::size_t type = 0; type < HEIGHTMAP_COUNT; ++type)
+    {
+        rebuildHeightmap(static_cast<HeightmapType>(type));
+    }
+}
+
+void Chunk::fillRegion(Magnum::Vector3i const& min, Magnum::Vector3i const& max, Block block)
+{
+    checkBounds(min.x(), min.y(), min.z());
+    checkBounds(max.x(), max.y(), max.z());
+    if (min.x() > max.x() || min.y() > max.y() || min.z() > max.z())
+        return;
+
+    for (int sectionIndex = min.y() / SECTION_SIZE; sectionIndex <= max.y() / SECTION_SIZE; ++sectionIndex)
+    {
+        int const sectionMinY = sectionIndex * SECTION_SIZE;
+        int const minY = std::max(min.y(), sectionMinY) - sectionMinY;
+        int const maxY = std::min(max.y(), sectionMinY + SECTION_SIZE - 1) - sectionMinY;
+        bool const wholeSection = minY == 0 && maxY == SECTION_SIZE - 1 &&
+            min.x() == 0 && max.x() == CHUNK_SIZE_X - 1 && min.z() == 0 && max.z() == CHUNK_SIZE_Z - 1;
+        if (wholeSection)
+            resetSection(sectionIndex, block);
+        else
+            writableSection(sectionIndex).fillBox(min.x(), minY, min.z(), max.x(), maxY, max.z(), block);
+    }
+
+    for (std::size_t type = 0; type < HEIGHTMAP_COUNT; ++type)
+    {
+        auto const heightmapType = static_cast<HeightmapType>(type);
+        bool const matches = matchesHeightmap(heightmapType, block);
+        for (int z = min.z(); z <= max.z(); ++z)
+        {
+            for (int x = min.x(); x <= max.x(); ++x)
+            {
+                int16_t& height = m_heightmaps[type][static_cast<std::size_t>(z) * CHUNK_SIZE_X + x];
+                if (matches)
+                    height = std::max<int16_t>(height, static_cast<int16_t>(max.y()));
+                else if (height >= min.y() && height <= max.y())
+                    height = findHighest(heightmapType, x, z, min.y() - 1);
+            }
+        }
+    }
+}
+
+void Chunk::replaceBlocks(BlockType from, BlockType to)
+{
+    for (int i = 0; i < CHUNK_SECTION_COUNT; ++i)
+    {
+        // Only copy shared sections that actually change
+        if (m_sections[i]->count(from) != 0)
+            writableSection(i).replace(from, to);
+    }
+
+    for (std::size_t type = 0; type < HEIGHTMAP_COUNT; ++type)
+    {
+        auto const heightmapType = static_cast<HeightmapType>(type);
+        if (matchesHeightmap(heightmapType, Block{from}) != matchesHeightmap(heightmapType, Block{to}))
+            rebuildHeightmap(heightmapType);
+    }
+}
+
+std::size_t Chunk::countBlocks(BlockType type) const
+{
+    std::size_t total = 0;
+    for (auto const& section : m_sections)
+    {
+        total += section->count(type);
+    }
+    return total;
+}
+
+std::array<std::size_t, BLOCK_TYPE_COUNT> Chunk::countBlocksByType() const
+{
+    std::array<std::size_t, BLOCK_TYPE_COUNT> counts{};
+    for (auto const& section : m_sections)
+    {
+        section->countAll(counts);
+    }
+    return counts;
+}
+
+void Chunk::buildColumnMasks(BlockFlag flag, std::span<ColumnMask, CHUNK_SLICE_AREA> out) const
+{
+    std::ranges::fill(out, ColumnMask{});
+
+    std::array<uint64_t, SECTION_MASK_WORDS> sectionMask;
+    for (int sectionIndex = 0; sectionIndex < CHUNK_SECTION_COUNT; ++sectionIndex)
+    {
+        auto const& section = *m_sections[sectionIndex];
+        int const sectionMinY = sectionIndex * SECTION_SIZE;
+        std::size_t const word = static_cast<std::size_t>(sectionMinY) / 64;
+        int const shift = sectionMinY % 64;
+
+        if (section.isUniform())
+        {
+            if (!has_flag(section.getUniformBlock().flags(), flag)) continue;
+            for (auto& column : out)
+                column[word] |= uint64_t{0xffff} << shift;
+            continue;
+        }
+
+        // Transpose the section mask (rows of 16 x per y and z) into per-column bits
+        section.matchFlag(flag, sectionMask);
+        for (int y = 0; y < SECTION_SIZE; ++y)
+        {
+            for (int z = 0; z < SECTION_SIZE; ++z)
+            {
+                std::size_t const first = (static_cast<std::size_t>(y) * SECTION_SIZE + z) * SECTION_SIZE;
+                auto row = static_cast<uint32_t>((sectionMask[first / 64] >> (first % 64)) & 0xffff);
+                while (row != 0)
+                {
+                    int const x = std::countr_zero(row);
+                    out[static_cast<std::size_t>(z) * CHUNK_SIZE_X + x][word] |= uint64_t{1} << (shift + y);
+                    row &= row - 1;
+                }
+            }
+        }
+    }
+}
+
+int Chunk::getMaxHeight(HeightmapType type) const
+{
+    return *std::ranges::max_element(m_heightmaps[static_cast<std::size_t>(type)]);
+}
+
+void Chunk::internSections(SectionTable& table)
+{
+    for (int i = 0; i < CHUNK_SECTION_COUNT; ++i)
+    {
+        if (m_immutableSections.test(i)) continue;
+
+        m_sections[i] = table.intern(std::move(m_sections[i]));
+        m_immutableSections.set(i);
+    }
+}
+
+int Chunk::getSharedSectionCount() const
+{
+    return static_cast<int>(std::ranges::count_if(m_sections, [](auto const& section) { return section.use_count() > 1; }));
+}
+
+std::size_t Chunk::memoryUsage() const
+{
+    std::size_t total = sizeof(*this);
+    for (int i = 0; i < CHUNK_SECTION_COUNT; ++i)
+    {
+        if (!m_immutableSections.test(i))
+            total += m_sections[i]->memoryUsage();
+    }
+    return total;
+}
+
+bool Chunk::matchesHeightmap(HeightmapType type, Block block)
+{
+    return has_flag(block.flags(), heightmapFlag(type));
+}
+
+BlockFlag Chunk::heightmapFlag(HeightmapType type)
+{
+    switch (type)
+    {
+    case HeightmapType::HIGHEST_SOLID: return BlockFlag::SOLID;
+    case HeightmapType::HIGHEST_NON_TRANSPARENT: return BlockFlag::OCCLUDING;
+    default: return BlockFlag::NONE;
+    }
+}
+
+void Chunk::updateHeightmaps(int x, int y, int z, Block block)
+{
+    std::size_t const column = static_cast<std::size_t>(z) * CHUNK_SIZE_X + x;
+    for (std::size_t type = 0; type < HEIGHTMAP_COUNT; ++type)
+    {
+        auto const heightmapType = static_cast<HeightmapType>(type);
+        int16_t& height = m_heightmaps[type][column];
+        if (matchesHeightmap(heightmapType, block))
+        {
+            if (y > height) height = static_cast<int16_t>(y);
+        }
+        else if (y == height)
+        {
+            height = findHighest(heightmapType, x, z, y - 1);
+        }
+    }
+}
+
+void Chunk::rebuildHeightmap(HeightmapType type)
+{
+    std::array<ColumnMask, CHUNK_SLICE_AREA> masks;
+    buildColumnMasks(heightmapFlag(type), masks);
+
+    auto& heights = m_heightmaps[static_cast<std::size_t>(type)];
+    for (std::size_t column = 0; column < masks.size(); ++column)
+    {
+        int16_t height = NO_HEIGHT;
+        for (int word = static_cast<int>(masks[column].size()) - 1; word >= 0; --word)
+        {
+            if (uint64_t const bits = masks[column][word]; bits != 0)
+            {
+                height = static_cast<int16_t>(word * 64 + 63 - std::countl_zero(bits));
+                break;
+            }
+        }
+        heights[column] = height;
+    }
+}
+
+void Chunk::resetSection(int index, Block block)
+{
+    auto& section = m_sections.at(index);
+    if (block.type == BlockType::AIR)
+    {
+        section = empty_section();
+        m_immutableSections.set(index);
+    }
+    else if (m_immutableSections.test(index) || section.use_count() != 1)
+    {
+        section = std::make_shared<ChunkSection>();
+        section->fill(block);
+        m_immutableSections.reset(index);
+    }
+    else
+    {
+        section->fill(block);
+    }
+}
+
+int16_t Chunk::findHighest(HeightmapType type, int x, int z, int fromY) const
+{
+    for (int y = fromY; y >= 0; --y)
+    {
+        auto const& section = *m_sections[y / SECTION_SIZE];
+        if (section.isUniform() && !matchesHeightmap(type, section.getUniformBlock()))
+        {
+            // Nothing in this section can match, jump to the top of the one below
+            y -= y % SECTION_SIZE;
+            continue;
+        }
+        if (matchesHeightmap(type, section.getBlock(x, y % SECTION_SIZE, z)))
+            return static_cast<int16_t>(y);
+    }
+    return NO_HEIGHT;
+}
+
+void Chunk::checkBounds(int x, int y, int z)
+{
+    if (!isInBounds(x, y, z))
+        throw std::out_of_range("Chunk block coordinates out of range");
 }
 
 Magnum::Vector3i Chunk::getChunkOfPosition(Magnum::Vector3i const& position)
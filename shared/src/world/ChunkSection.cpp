@@ -0,0 +1,132 @@
+#include "world/ChunkSection.hpp"
+
+namespace mc::world
+{
+
+Block ChunkSection::getBlock(int x, int y, int z) const
+{
+    return m_blocks.get(toIndex(x, y, z));
+}
+
+void ChunkSection::setBlock(int x, int y, int z, Block block)
+{
+    m_blocks.set(toIndex(x, y, z), block);
+}
+
+void ChunkSection::getSlice(int y, std::span<Block, SECTION_AREA> out) const
+{
+    m_blocks.getStrided(toIndex(0, y, 0), 1, out);
+}
+
+void ChunkSection::setSlice(int y, std::span<Block const, SECTION_AREA> blocks)
+{
+    m_blocks.setStrided(toIndex(0, y, 0), 1, blocks);
+}
+
+void ChunkSection::getColumn(int x, int z, std::span<Block, SECTION_SIZE> out) const
+{
+    m_blocks.getStrided(toIndex(x, 0, z), SECTION_AREA, out);
+}
+
+void ChunkSection::setColumn(int x, int z, std::span<Block const, SECTION_SIZE> blocks)
+{
+    m_blocks.setStrided(toIndex(x, 0, z), SECTION_AREA, blocks);
+}
+
+void ChunkSection::fill(Block block)
+{
+    m_blocks.fill(block);
+}
+
+void ChunkSection::fillBox(int minX, int minY, int minZ, int maxX, int maxY, int maxZ, Block block)
+{
+    bool const fullRows = minX == 0 && maxX == SECTION_SIZE - 1;
+    bool const fullSlices = fullRows && minZ == 0 && maxZ == SECTION_SIZE - 1;
+
+    // Whole slices are contiguous across y, whole rows across z, otherwise one run per row
+    if (fullSlices)
+    {
+        m_blocks.fillRange(toIndex(0, minY, 0), static_cast<std::size_t>(maxY - minY + 1) * SECTION_AREA, block);
+        return;
+    }
+    if (minX == maxX && minZ == maxZ)
+    {
+        m_blocks.fillStrided(toIndex(minX, minY, minZ), SECTION_AREA, static_cast<std::size_t>(maxY - minY + 1), block);
+        return;
+    }
+
+    for (int y = minY; y <= maxY; ++y)
+    {
+        if (fullRows)
+        {
+            m_blocks.fillRange(toIndex(0, y, minZ), static_cast<std::size_t>(maxZ - minZ + 1) * SECTION_SIZE, block);
+            continue;
+        }
+        for (int z = minZ; z <= maxZ; ++z)
+        {
+            m_blocks.fillRange(toIndex(minX, y, z), static_cast<std::size_t>(maxX - minX + 1), block);
+        }
+    }
+}
+
+void ChunkSection::replace(BlockType from, BlockType to)
+{
+    m_blocks.replace(from, to);
+}
+
+std::size_t ChunkSection::count(BlockType type) const
+{
+    return m_blocks.count(type);
+}
+
+void ChunkSection::countAll(std::span<std::size_t, BLOCK_TYPE_COUNT> counts) const
+{
+    m_blocks.countAll(counts);
+}
+
+void ChunkSection::matchFlag(BlockFlag flag, std::span<uint64_t, SECTION_MASK_WORDS> out) const
+{
+    m_blocks.matchFlag(flag, out);
+}
+
+bool ChunkSection::isEmpty() const
+{
+    return isUniform() && getUniformBlock().type == BlockType::AIR;
+}
+
+bool ChunkSection::isUniform() const
+{
+    return m_blocks.paletteSize() == 1;
+}
+
+bool ChunkSection::isUniformSolid() const
+{
+    return isUniform() && getUniformBlock().isSolid();
+}
+
+Block ChunkSection::getUniformBlock() const
+{
+    return m_blocks.get(0);
+}
+
+PalettedContainer const& ChunkSection::getBlocks() const
+{
+    return m_blocks;
+}
+
+PalettedContainer& ChunkSection::getBlocks()
+{
+    return m_blocks;
+}
+
+std::size_t ChunkSection::memoryUsage() const
+{
+    return m_blocks.memoryUsage();
+}
+
+uint64_t ChunkSection::contentHash() const
+{
+    return m_blocks.contentHash();
+}
+
+} // namespace mc::world
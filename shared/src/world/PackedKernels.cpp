@@ -0,0 +1,214 @@
+#include "world/PackedKernels.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define MC_PACKED_X86 1
+#include <immintrin.h>
+#endif
+
+namespace mc::world::packed
+{
+
+namespace
+{
+/// Word with the lowest bit of every field set.
+constexpr uint64_t field_ones(uint8_t bits)
+{
+    return ~uint64_t{0} / ((uint64_t{1} << bits) - 1);
+}
+
+/// Mask of the bits used by the first @p fields fields of a word.
+constexpr uint64_t used_bits(std::size_t fields, uint8_t bits)
+{
+    std::size_t const used = fields * bits;
+    return used >= 64 ? ~uint64_t{0} : (uint64_t{1} << used) - 1;
+}
+
+/**
+ * @brief SWAR replace of one word: fields equal to @p from become @p to.
+ *
+ * Field-wise zero test of word ^ from without carries between fields, then the high
+ * bit of every matching field is widened to the whole field.
+ */
+constexpr uint64_t replace_word(uint64_t word, uint8_t bits, uint64_t fromPattern, uint64_t toPattern, uint64_t high)
+{
+    uint64_t const low = ~high;
+    uint64_t const x = word ^ fromPattern;
+    uint64_t const zero = ~(((x & low) + low) | x | low) & high;
+    uint64_t const lsb = zero >> (bits - 1);
+    uint64_t const matched = (lsb << bits) - lsb; // lsb * (2^bits - 1), fields never overlap
+    return (word & ~matched) | (toPattern & matched);
+}
+
+/// Spreads 32 bits over the even bits of a 64-bit word.
+constexpr uint64_t spread_even(uint32_t v)
+{
+    uint64_t x = v;
+    x = (x | x << 16) & 0x0000ffff0000ffffULL;
+    x = (x | x << 8) & 0x00ff00ff00ff00ffULL;
+    x = (x | x << 4) & 0x0f0f0f0f0f0f0f0fULL;
+    x = (x | x << 2) & 0x3333333333333333ULL;
+    x = (x | x << 1) & 0x5555555555555555ULL;
+    return x;
+}
+
+void replace_scalar(std::span<uint64_t> words, uint8_t bits, std::size_t count, uint16_t from, uint16_t to, std::size_t firstWord)
+{
+    uint64_t const ones = field_ones(bits);
+    uint64_t const high = ones << (bits - 1);
+    std::size_t const perWord = 64 / bits;
+    std::size_t const usedWords = (count + perWord - 1) / perWord;
+    for (std::size_t w = firstWord; w < usedWords; ++w)
+    {
+        uint64_t const replaced = replace_word(words[w], bits, ones * from, ones * to, high);
+        std::size_t const fields = std::min(perWord, count - w * perWord);
+        uint64_t const keep = used_bits(fields, bits);
+        words[w] = (words[w] & ~keep) | (replaced & keep);
+    }
+}
+
+void match_scalar(
+    std::span<uint64_t const> words,
+    uint8_t bits,
+    std::size_t count,
+    std::span<uint8_t const> lut,
+    std::span<uint64_t> out,
+    std::size_t first)
+{
+    uint64_t const mask = (uint64_t{1} << bits) - 1;
+    std::size_t const perWord = 64 / bits;
+
+    // first is a multiple of 64, and every output word covers whole input words
+    for (std::size_t o = first / 64; o * 64 < count; ++o)
+    {
+        std::size_t const fields = std::min<std::size_t>(64, count - o * 64);
+        uint64_t const* next = words.data() + o * 64 / perWord;
+        uint64_t result = 0;
+        uint64_t word = 0;
+        std::size_t left = 0;
+        for (std::size_t j = 0; j < fields; ++j)
+        {
+            if (left-- == 0)
+            {
+                word = *next++;
+                left = perWord - 1;
+            }
+            result |= static_cast<uint64_t>(lut[word & mask] != 0) << j;
+            word >>= bits;
+        }
+        out[o] = result;
+    }
+}
+
+#ifdef MC_PACKED_X86
+__attribute__((target("avx2"))) std::size_t replace_avx2(std::span<uint64_t> words, uint8_t bits, std::size_t count, uint16_t from, uint16_t to)
+{
+    uint64_t const ones = field_ones(bits);
+    __m256i const high = _mm256_set1_epi64x(static_cast<long long>(ones << (bits - 1)));
+    __m256i const low = _mm256_set1_epi64x(static_cast<long long>(~(ones << (bits - 1))));
+    __m256i const fromPattern = _mm256_set1_epi64x(static_cast<long long>(ones * from));
+    __m256i const toPattern = _mm256_set1_epi64x(static_cast<long long>(ones * to));
+    __m128i const shiftDown = _mm_cvtsi32_si128(bits - 1);
+    __m128i const shiftUp = _mm_cvtsi32_si128(bits);
+
+    // Only whole words go through the vector loop; the scalar tail handles the partial one
+    std::size_t const fullWords = count / (64 / bits);
+    std::size_t w = 0;
+    for (; w + 4 <= fullWords; w += 4)
+    {
+        auto* ptr = reinterpret_cast<__m256i*>(words.data() + w);
+        __m256i const word = _mm256_loadu_si256(ptr);
+        __m256i const x = _mm256_xor_si256(word, fromPattern);
+        __m256i const sum = _mm256_add_epi64(_mm256_and_si256(x, low), low);
+        __m256i const zero = _mm256_andnot_si256(_mm256_or_si256(_mm256_or_si256(sum, x), low), high);
+        __m256i const lsb = _mm256_srl_epi64(zero, shiftDown);
+        __m256i const matched = _mm256_sub_epi64(_mm256_sll_epi64(lsb, shiftUp), lsb);
+        __m256i const result = _mm256_or_si256(_mm256_andnot_si256(matched, word), _mm256_and_si256(toPattern, matched));
+        _mm256_storeu_si256(ptr, result);
+    }
+    return w;
+}
+
+/// 4-bit fields: 64 nibbles per 256-bit load, looked up 32 at a time with a byte shuffle.
+__attribute__((target("avx2"))) std::size_t match4_avx2(
+    std::span<uint64_t const> words,
+    std::size_t count,
+    std::span<uint8_t const> lut,
+    std::span<uint64_t> out)
+{
+    alignas(16) std::array<uint8_t, 16> table{};
+    for (std::size_t i = 0; i < std::min(lut.size(), table.size()); ++i)
+    {
+        table[i] = lut[i] != 0 ? 0xff : 0x00;
+    }
+
+    __m256i const lutVector = _mm256_broadcastsi128_si256(_mm_load_si128(reinterpret_cast<__m128i const*>(table.data())));
+    __m256i const nibble = _mm256_set1_epi8(0x0f);
+
+    std::size_t i = 0;
+    for (; i + 64 <= count; i += 64)
+    {
+        __m256i const packed = _mm256_loadu_si256(reinterpret_cast<__m256i const*>(words.data() + i / 16));
+        __m256i const even = _mm256_shuffle_epi8(lutVector, _mm256_and_si256(packed, nibble));
+        __m256i const odd = _mm256_shuffle_epi8(lutVector, _mm256_and_si256(_mm256_srli_epi16(packed, 4), nibble));
+        auto const evenBits = static_cast<uint32_t>(_mm256_movemask_epi8(even));
+        auto const oddBits = static_cast<uint32_t>(_mm256_movemask_epi8(odd));
+        out[i / 64] = spread_even(evenBits) | spread_even(oddBits) << 1;
+    }
+    return i;
+}
+
+bool cpu_has_avx2()
+{
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("avx2");
+}
+#endif
+} // namespace
+
+Isa best_isa()
+{
+#ifdef MC_PACKED_X86
+    static Isa const isa = cpu_has_avx2() ? Isa::AVX2 : Isa::SCALAR;
+    return isa;
+#else
+    return Isa::SCALAR;
+#endif
+}
+
+void replace(std::span<uint64_t> words, uint8_t bits, std::size_t count, uint16_t from, uint16_t to, Isa isa)
+{
+    assert(bits != 0 && words.size() * (64 / bits) >= count);
+    std::size_t done = 0;
+#ifdef MC_PACKED_X86
+    if (isa == Isa::AVX2)
+        done = replace_avx2(words, bits, count, from, to);
+#else
+    (void)isa;
+#endif
+    replace_scalar(words, bits, count, from, to, done);
+}
+
+void match(
+    std::span<uint64_t const> words,
+    uint8_t bits,
+    std::size_t count,
+    std::span<uint8_t const> lut,
+    std::span<uint64_t> out,
+    Isa isa)
+{
+    assert(bits != 0 && words.size() * (64 / bits) >= count && out.size() * 64 >= count);
+    std::size_t done = 0;
+#ifdef MC_PACKED_X86
+    if (isa == Isa::AVX2 && bits == 4)
+        done = match4_avx2(words, count, lut, out);
+#else
+    (void)isa;
+#endif
+    match_scalar(words, bits, count, lut, out, done);
+}
+
+} // namespace mc::world::packed
@@ -0,0 +1,446 @@
+#include "world/PalettedContainer.hpp"
+
+#include "utils/IVec3Hasher.hpp"
+#include "world/PackedKernels.hpp"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+
+namespace mc::world
+{
+
+namespace
+{
+/// Free palette entries a narrower index width must leave, so that a block toggling
+/// between two types across a width boundary does not repack the container every edit.
+constexpr std::size_t SHRINK_MARGIN = 1;
+
+constexpr std::size_t palette_capacity(uint8_t bits)
+{
+    return std::size_t{1} << bits;
+}
+
+constexpr std::size_t words_for(std::size_t size, uint8_t bits)
+{
+    if (bits == 0) return 0;
+    std::size_t const perWord = 64 / bits;
+    return (size + perWord - 1) / perWord;
+}
+
+constexpr uint8_t entries_per_word_log2(uint8_t bits)
+{
+    return bits == 0 ? 0 : static_cast<uint8_t>(6 - std::countr_zero(bits));
+}
+
+/// A packed word whose every index equals @p paletteIndex.
+constexpr uint64_t broadcast(uint16_t paletteIndex, uint8_t bits)
+{
+    return static_cast<uint64_t>(paletteIndex) * (~uint64_t{0} / ((uint64_t{1} << bits) - 1));
+}
+} // namespace
+
+PalettedContainer::PalettedContainer(std::size_t size, Block fill)
+    : m_size{size}
+    , m_palette{fill.type}
+    , m_counts{static_cast<uint32_t>(size)}
+{}
+
+Block PalettedContainer::get(std::size_t index) const
+{
+    return Block{m_palette[readIndex(index)]};
+}
+
+void PalettedContainer::set(std::size_t index, Block block)
+{
+    uint16_t const oldIndex = readIndex(index);
+    if (m_palette[oldIndex] == block.type) return;
+
+    uint16_t const newIndex = acquirePaletteIndex(block.type);
+    if (m_counts[newIndex]++ == 0) ++m_liveEntries;
+    writeIndex(index, newIndex);
+
+    releasePaletteIndex(oldIndex);
+}
+
+void PalettedContainer::getStrided(std::size_t first, std::size_t stride, std::span<Block> out) const
+{
+    if (m_bits == 0)
+    {
+        std::ranges::fill(out, Block{m_palette[0]});
+        return;
+    }
+
+    std::size_t index = first;
+    for (auto& block : out)
+    {
+        block = Block{m_palette[readIndex(index)]};
+        index += stride;
+    }
+}
+
+void PalettedContainer::setStrided(std::size_t first, std::size_t stride, std::span<Block const> blocks)
+{
+    std::size_t index = first;
+    for (auto const& block : blocks)
+    {
+        set(index, block);
+        index += stride;
+    }
+}
+
+void PalettedContainer::fill(Block block)
+{
+    m_bits = 0;
+    m_entriesPerWordLog2 = 0;
+    m_liveEntries = 1;
+    m_palette.assign(1, block.type);
+    m_counts.assign(1, static_cast<uint32_t>(m_size));
+    m_data = {};
+}
+
+void PalettedContainer::fillRange(std::size_t first, std::size_t count, Block block)
+{
+    if (first == 0 && count == m_size)
+    {
+        fill(block);
+        return;
+    }
+
+    fillStrided(first, 1, count, block);
+}
+
+void PalettedContainer::fillStrided(std::size_t first, std::size_t stride, std::size_t count, Block block)
+{
+    if (count == 0) return;
+
+    uint16_t const newIndex = acquirePaletteIndex(block.type);
+    for (std::size_t i = first; i < first + count * stride; i += stride)
+    {
+        uint16_t const oldIndex = readIndex(i);
+        if (oldIndex == newIndex) continue;
+
+        --m_counts[oldIndex];
+        ++m_counts[newIndex];
+        writeIndex(i, newIndex);
+    }
+
+    // Entries are only released once the whole range is written, so indices stay stable above
+    m_liveEntries = static_cast<std::size_t>(std::ranges::count_if(m_counts, [](uint32_t c) { return c != 0; }));
+    shrinkIfSparse();
+}
+
+void PalettedContainer::replace(BlockType from, BlockType to)
+{
+    if (from == to) return;
+
+    auto const fromIt = std::ranges::find(m_palette, from);
+    if (fromIt == m_palette.end()) return;
+    auto const fromIndex = static_cast<uint16_t>(fromIt - m_palette.begin());
+    if (m_counts[fromIndex] == 0) return;
+
+    auto const toIt = std::ranges::find(m_palette, to);
+    if (toIt == m_palette.end() || m_counts[toIt - m_palette.begin()] == 0)
+    {
+        // Nothing references `to`, so renaming the entry is enough. A stale entry of `to`
+        // takes over the old name to keep a single palette entry per type.
+        if (toIt != m_palette.end()) *toIt = from;
+        m_palette[fromIndex] = to;
+        return;
+    }
+
+    auto const toIndex = static_cast<uint16_t>(toIt - m_palette.begin());
+    packed::replace(m_data, m_bits, m_size, fromIndex, toIndex);
+    m_counts[toIndex] += m_counts[fromIndex];
+    m_counts[fromIndex] = 0;
+
+    --m_liveEntries;
+    shrinkIfSparse();
+}
+
+std::size_t PalettedContainer::count(BlockType type) const
+{
+    auto const it = std::ranges::find(m_palette, type);
+    return it != m_palette.end() ? m_counts[it - m_palette.begin()] : 0;
+}
+
+void PalettedContainer::countAll(std::span<std::size_t, BLOCK_TYPE_COUNT> counts) const
+{
+    for (std::size_t i = 0; i < m_palette.size(); ++i)
+    {
+        counts[static_cast<std::size_t>(m_palette[i])] += m_counts[i];
+    }
+}
+
+void PalettedContainer::matchFlag(BlockFlag flag, std::span<uint64_t> out) const
+{
+    if (m_bits == 0)
+    {
+        bool const matches = has_flag(block_flags(m_palette[0]), flag);
+        std::size_t const words = (m_size + 63) / 64;
+        std::fill_n(out.begin(), words, matches ? ~uint64_t{0} : 0);
+        if (matches && m_size % 64 != 0)
+            out[words - 1] = (uint64_t{1} << (m_size % 64)) - 1;
+        return;
+    }
+
+    // Palettes of up to 8-bit indices fit on the stack, wider ones are rare enough to allocate
+    std::array<uint8_t, 256> smallLut{};
+    std::vector<uint8_t> largeLut;
+    std::span<uint8_t> lut = std::span{smallLut}.first(std::min(m_palette.size(), smallLut.size()));
+    if (m_palette.size() > smallLut.size())
+    {
+        largeLut.resize(m_palette.size());
+        lut = largeLut;
+    }
+    for (std::size_t i = 0; i < m_palette.size(); ++i)
+    {
+        lut[i] = has_flag(block_flags(m_palette[i]), flag);
+    }
+
+    packed::match(m_data, m_bits, m_size, lut, out);
+}
+
+std::span<BlockType const> PalettedContainer::palette() const
+{
+    return m_palette;
+}
+
+uint32_t PalettedContainer::paletteCount(uint16_t paletteIndex) const
+{
+    return m_counts[paletteIndex];
+}
+
+uint16_t PalettedContainer::paletteIndexAt(std::size_t index) const
+{
+    return readIndex(index);
+}
+
+std::size_t PalettedContainer::runEnd(std::size_t first) const
+{
+    if (m_bits == 0) return m_size;
+
+    uint16_t const paletteIndex = readIndex(first);
+    std::size_t const perWord = std::size_t{1} << m_entriesPerWordLog2;
+    std::size_t index = first + 1;
+    for (; index < m_size && (index & (perWord - 1)) != 0; ++index)
+    {
+        if (readIndex(index) != paletteIndex) return index;
+    }
+
+    uint64_t const pattern = broadcast(paletteIndex, m_bits);
+    while (index + perWord <= m_size && m_data[index >> m_entriesPerWordLog2] == pattern)
+    {
+        index += perWord;
+    }
+    while (index < m_size && readIndex(index) == paletteIndex)
+    {
+        ++index;
+    }
+    return index;
+}
+
+void PalettedContainer::assignPalette(std::span<BlockType const> palette)
+{
+    m_bits = bitsForPalette(palette.size());
+    m_entriesPerWordLog2 = entries_per_word_log2(m_bits);
+    m_liveEntries = 1;
+    m_palette.assign(palette.begin(), palette.end());
+    m_counts.assign(palette.size(), 0);
+    m_counts[0] = static_cast<uint32_t>(m_size);
+    m_data.assign(words_for(m_size, m_bits), 0);
+}
+
+void PalettedContainer::fillIndexRange(std::size_t first, std::size_t count, uint16_t paletteIndex)
+{
+    auto const move = [this, paletteIndex](uint16_t oldIndex, uint32_t blocks) {
+        if ((m_counts[oldIndex] -= blocks) == 0) --m_liveEntries;
+        if (m_counts[paletteIndex] == 0) ++m_liveEntries;
+        m_counts[paletteIndex] += blocks;
+    };
+
+    std::size_t const end = first + count;
+    std::size_t const perWord = m_bits == 0 ? m_size : std::size_t{1} << m_entriesPerWordLog2;
+    uint64_t const pattern = m_bits == 0 ? 0 : broadcast(paletteIndex, m_bits);
+    std::size_t index = first;
+    while (index < end)
+    {
+        // Words that are entirely covered and entirely one entry, like the zeroed words a
+        // decoder starts from, are rewritten at once
+        if (m_bits != 0 && (index & (perWord - 1)) == 0 && index + perWord <= end)
+        {
+            uint64_t& word = m_data[index >> m_entriesPerWordLog2];
+            uint16_t const oldIndex = static_cast<uint16_t>(word & ((uint64_t{1} << m_bits) - 1));
+            if (word == broadcast(oldIndex, m_bits))
+            {
+                if (oldIndex != paletteIndex) move(oldIndex, static_cast<uint32_t>(perWord));
+                word = pattern;
+                index += perWord;
+                continue;
+            }
+        }
+
+        if (uint16_t const oldIndex = readIndex(index); oldIndex != paletteIndex)
+        {
+            move(oldIndex, 1);
+            writeIndex(index, paletteIndex);
+        }
+        ++index;
+    }
+}
+
+std::size_t PalettedContainer::size() const
+{
+    return m_size;
+}
+
+std::size_t PalettedContainer::paletteSize() const
+{
+    return m_liveEntries;
+}
+
+uint8_t PalettedContainer::bitsPerEntry() const
+{
+    return m_bits;
+}
+
+std::size_t PalettedContainer::memoryUsage() const
+{
+    return sizeof(*this) +
+        m_palette.capacity() * sizeof(BlockType) +
+        m_counts.capacity() * sizeof(uint32_t) +
+        m_data.capacity() * sizeof(uint64_t);
+}
+
+uint64_t PalettedContainer::contentHash() const
+{
+    uint64_t hash = utils::mix64(m_size ^ (static_cast<uint64_t>(m_bits) << 32));
+    auto const combine = [&hash](uint64_t value) { hash = utils::mix64(hash ^ value) + 0x9e3779b97f4a7c15ULL; };
+    for (std::size_t i = 0; i < m_palette.size(); ++i)
+    {
+        combine(static_cast<uint64_t>(m_palette[i]) | static_cast<uint64_t>(m_counts[i]) << 16);
+    }
+    for (uint64_t const word : m_data)
+    {
+        combine(word);
+    }
+    return hash;
+}
+
+uint16_t PalettedContainer::readIndex(std::size_t index) const
+{
+    if (m_bits == 0) return 0;
+
+    std::size_t const inWordMask = (std::size_t{1} << m_entriesPerWordLog2) - 1;
+    std::size_t const shift = (index & inWordMask) * m_bits;
+    uint64_t const mask = (uint64_t{1} << m_bits) - 1;
+    return static_cast<uint16_t>((m_data[index >> m_entriesPerWordLog2] >> shift) & mask);
+}
+
+void PalettedContainer::writeIndex(std::size_t index, uint16_t paletteIndex)
+{
+    if (m_bits == 0) return;
+
+    std::size_t const inWordMask = (std::size_t{1} << m_entriesPerWordLog2) - 1;
+    std::size_t const shift = (index & inWordMask) * m_bits;
+    uint64_t const mask = ((uint64_t{1} << m_bits) - 1) << shift;
+    uint64_t& word = m_data[index >> m_entriesPerWordLog2];
+    word = (word & ~mask) | (static_cast<uint64_t>(paletteIndex) << shift);
+}
+
+uint16_t PalettedContainer::acquirePaletteIndex(BlockType type)
+{
+    // Reuse an entry of the same type, even if it is currently unreferenced
+    if (auto it = std::ranges::find(m_palette, type); it != m_palette.end())
+        return static_cast<uint16_t>(it - m_palette.begin());
+
+    // Recycle an unreferenced slot before growing the palette
+    if (auto it = std::ranges::find(m_counts, 0u); it != m_counts.end())
+    {
+        auto const slot = static_cast<uint16_t>(it - m_counts.begin());
+        m_palette[slot] = type;
+        return slot;
+    }
+
+    if (m_palette.size() >= palette_capacity(m_bits))
+    {
+        // Every entry is live here, so repacking keeps existing indices stable
+        repack(bitsForPalette(m_palette.size() + 1));
+    }
+
+    m_palette.push_back(type);
+    m_counts.push_back(0);
+    return static_cast<uint16_t>(m_palette.size() - 1);
+}
+
+void PalettedContainer::releasePaletteIndex(uint16_t paletteIndex)
+{
+    if (--m_counts[paletteIndex] != 0) return;
+
+    --m_liveEntries;
+    shrinkIfSparse();
+}
+
+void PalettedContainer::shrinkIfSparse()
+{
+    // A single type drops the index data outright, which repacks nothing
+    uint8_t const bits = m_liveEntries == 1 ? 0 : bitsForPalette(m_liveEntries + SHRINK_MARGIN);
+    if (bits < m_bits)
+    {
+        repack(bits);
+    }
+}
+
+void PalettedContainer::repack(uint8_t bits)
+{
+    std::vector<BlockType> palette;
+    std::vector<uint32_t> counts;
+    std::vector<uint16_t> remap(m_palette.size(), 0);
+    palette.reserve(m_liveEntries + 1);
+    counts.reserve(m_liveEntries + 1);
+
+    for (std::size_t i = 0; i < m_palette.size(); ++i)
+    {
+        if (m_counts[i] == 0) continue;
+        remap[i] = static_cast<uint16_t>(palette.size());
+        palette.push_back(m_palette[i]);
+        counts.push_back(m_counts[i]);
+    }
+
+    // Without index data every index is 0, and entry 0 is live so it is remapped to 0 too:
+    // the new words stay zero. Otherwise each new word is packed in a register.
+    std::vector<uint64_t> data(words_for(m_size, bits), 0);
+    if (bits != 0 && m_bits != 0)
+    {
+        std::size_t const perWord = 64 / bits;
+        std::size_t i = 0;
+        for (auto& word : data)
+        {
+            std::size_t const end = std::min(m_size, i + perWord);
+            uint64_t packed = 0;
+            for (std::size_t shift = 0; i < end; ++i, shift += bits)
+            {
+                packed |= static_cast<uint64_t>(remap[readIndex(i)]) << shift;
+            }
+            word = packed;
+        }
+    }
+
+    m_bits = bits;
+    m_entriesPerWordLog2 = entries_per_word_log2(bits);
+    m_palette = std::move(palette);
+    m_counts = std::move(counts);
+    m_data = std::move(data);
+}
+
+uint8_t PalettedContainer::bitsForPalette(std::size_t paletteSize)
+{
+    if (paletteSize <= 1) return 0;
+    if (paletteSize <= 2) return 1;
+    if (paletteSize <= 4) return 2;
+    if (paletteSize <= 16) return 4;
+    if (paletteSize <= 256) return 8;
+    return 16;
+}
+
+} // namespace mc::world
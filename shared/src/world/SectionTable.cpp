@@ -0,0 +1,59 @@
+#include "world/SectionTable.hpp"
+
+namespace mc::world
+{
+
+std::shared_ptr<ChunkSection> SectionTable::intern(std::shared_ptr<ChunkSection> section)
+{
+    // Hash outside of the lock, it reads the whole section
+    uint64_t const hash = section->contentHash();
+
+    std::scoped_lock lock{m_mutex};
+    ++m_lookups;
+    if (++m_sinceSweep >= SWEEP_INTERVAL)
+    {
+        removeExpired();
+    }
+
+    auto [it, end] = m_sections.equal_range(hash);
+    while (it != end)
+    {
+        auto existing = it->second.lock();
+        if (!existing)
+        {
+            it = m_sections.erase(it);
+            continue;
+        }
+        if (*existing == *section)
+        {
+            ++m_hits;
+            return existing;
+        }
+        ++it;
+    }
+
+    m_sections.emplace(hash, section);
+    return section;
+}
+
+SectionTable::Stats SectionTable::getStats()
+{
+    std::scoped_lock lock{m_mutex};
+    removeExpired();
+
+    Stats stats{m_lookups, m_hits, m_sections.size(), 0};
+    for (auto const& entry : m_sections)
+    {
+        if (auto section = entry.second.lock())
+            stats.memoryUsage += section->memoryUsage();
+    }
+    return stats;
+}
+
+void SectionTable::removeExpired()
+{
+    std::erase_if(m_sections, [](auto const& entry) { return entry.second.expired(); });
+    m_sinceSweep = 0;
+}
+
+} // namespace mc::world
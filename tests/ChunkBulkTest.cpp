@@ -0,0 +1,200 @@
+#include <algorithm>
+#include <array>
+#include <random>
+#include <utility>
+#include <vector>
+
+#include <catch2/catch_test_macros.hpp>
+#include <world/Chunk.hpp>
+#include <world/ChunkGenerator.hpp>
+#include <world/PackedKernels.hpp>
+
+namespace
+{
+using namespace mc::world;
+
+constexpr int32_t SEED = 1337;
+
+// Reference implementations decode one field or one block at a time
+
+uint64_t read_field(std::vector<uint64_t> const& words, uint8_t bits, std::size_t i)
+{
+    std::size_t const perWord = 64 / bits;
+    return (words[i / perWord] >> (i % perWord * bits)) & ((uint64_t{1} << bits) - 1);
+}
+
+std::vector<uint64_t> reference_replace(std::vector<uint64_t> words, uint8_t bits, std::size_t count, uint16_t from, uint16_t to)
+{
+    std::size_t const perWord = 64 / bits;
+    for (std::size_t i = 0; i < count; ++i)
+    {
+        if (read_field(words, bits, i) != from) continue;
+        std::size_t const shift = i % perWord * bits;
+        words[i / perWord] = (words[i / perWord] & ~(((uint64_t{1} << bits) - 1) << shift)) | (uint64_t{to} << shift);
+    }
+    return words;
+}
+
+std::vector<uint64_t> reference_match(std::vector<uint64_t> const& words, uint8_t bits, std::size_t count, std::vector<uint8_t> const& lut)
+{
+    std::vector<uint64_t> out((count + 63) / 64, 0);
+    for (std::size_t i = 0; i < count; ++i)
+        out[i / 64] |= static_cast<uint64_t>(lut[read_field(words, bits, i)] != 0) << (i % 64);
+    return out;
+}
+
+bool same_chunk(Chunk const& a, Chunk const& b)
+{
+    for (int y = 0; y < CHUNK_SIZE_Y; ++y)
+        for (int z = 0; z < CHUNK_SIZE_Z; ++z)
+            for (int x = 0; x < CHUNK_SIZE_X; ++x)
+                if (a.getBlockUnchecked(x, y, z).type != b.getBlockUnchecked(x, y, z).type)
+                    return false;
+
+    for (auto type : {HeightmapType::HIGHEST_SOLID, HeightmapType::HIGHEST_NON_TRANSPARENT})
+        for (int z = 0; z < CHUNK_SIZE_Z; ++z)
+            for (int x = 0; x < CHUNK_SIZE_X; ++x)
+                if (a.getHeight(type, x, z) != b.getHeight(type, x, z))
+                    return false;
+    return true;
+}
+
+std::array<std::size_t, BLOCK_TYPE_COUNT> count_per_block(Chunk const& chunk)
+{
+    std::array<std::size_t, BLOCK_TYPE_COUNT> counts{};
+    for (int y = 0; y < CHUNK_SIZE_Y; ++y)
+        for (int z = 0; z < CHUNK_SIZE_Z; ++z)
+            for (int x = 0; x < CHUNK_SIZE_X; ++x)
+                ++counts[static_cast<std::size_t>(chunk.getBlockUnchecked(x, y, z).type)];
+    return counts;
+}
+
+void masks_per_block(Chunk const& chunk, BlockFlag flag, std::span<ColumnMask, CHUNK_SLICE_AREA> out)
+{
+    std::ranges::fill(out, ColumnMask{});
+    for (int y = 0; y < CHUNK_SIZE_Y; ++y)
+        for (int z = 0; z < CHUNK_SIZE_Z; ++z)
+            for (int x = 0; x < CHUNK_SIZE_X; ++x)
+                if (has_flag(chunk.getBlockUnchecked(x, y, z).flags(), flag))
+                    out[static_cast<std::size_t>(z) * CHUNK_SIZE_X + x][y / 64] |= uint64_t{1} << (y % 64);
+}
+
+std::vector<Chunk> generate_chunks(int count)
+{
+    ChunkGenerator const generator{SEED};
+    std::vector<Chunk> chunks;
+    chunks.reserve(count);
+    for (int i = 0; i < count; ++i)
+        chunks.push_back(generator.generate({i % 4, 0, i / 4}));
+    return chunks;
+}
+} // namespace
+
+TEST_CASE("Packed kernels match the per-field reference on every instruction set", "[packed]")
+{
+    std::vector<packed::Isa> isas{packed::Isa::SCALAR};
+    if (packed::best_isa() == packed::Isa::AVX2)
+        isas.push_back(packed::Isa::AVX2);
+
+    std::mt19937_64 rng{SEED};
+    for (uint8_t bits : {1, 2, 4, 8, 16})
+    {
+        uint64_t const fieldMax = (uint64_t{1} << bits) - 1;
+        std::uniform_int_distribution<uint64_t> field{0, fieldMax};
+        for (int trial = 0; trial < 200; ++trial)
+        {
+            std::size_t const count = trial % 2 == 0 ? SECTION_VOLUME : std::uniform_int_distribution<std::size_t>{1, SECTION_VOLUME}(rng);
+            std::vector<uint64_t> words((count + 64 / bits - 1) / (64 / bits));
+            for (auto& word : words)
+                word = rng();
+            auto const from = static_cast<uint16_t>(field(rng));
+            auto const to = static_cast<uint16_t>(field(rng));
+            std::vector<uint8_t> lut(fieldMax + 1);
+            for (auto& entry : lut)
+                entry = static_cast<uint8_t>(rng() & 1);
+
+            auto const expectedReplace = reference_replace(words, bits, count, from, to);
+            auto const expectedMatch = reference_match(words, bits, count, lut);
+            for (auto isa : isas)
+            {
+                INFO("bits " << int{bits} << ", count " << count << ", isa " << static_cast<int>(isa));
+                auto replaced = words;
+                packed::replace(replaced, bits, count, from, to, isa);
+                REQUIRE(replaced == expectedReplace);
+
+                std::vector<uint64_t> matched(expectedMatch.size(), ~uint64_t{0});
+                packed::match(words, bits, count, lut, matched, isa);
+                REQUIRE(matched == expectedMatch);
+            }
+        }
+    }
+}
+
+TEST_CASE("Bulk chunk reads match per-block reads", "[chunk]")
+{
+    std::array<ColumnMask, CHUNK_SLICE_AREA> masks;
+    std::array<ColumnMask, CHUNK_SLICE_AREA> expectedMasks;
+    for (auto const& chunk : generate_chunks(8))
+    {
+        INFO("chunk [" << chunk.getPosition().x() << ", " << chunk.getPosition().z() << "]");
+        REQUIRE(chunk.countBlocksByType() == count_per_block(chunk));
+
+        for (auto flag : {BlockFlag::SOLID, BlockFlag::OCCLUDING})
+        {
+            chunk.buildColumnMasks(flag, masks);
+            masks_per_block(chunk, flag, expectedMasks);
+            REQUIRE(masks == expectedMasks);
+        }
+    }
+}
+
+TEST_CASE("Bulk chunk writes match per-block writes", "[chunk]")
+{
+    std::mt19937_64 rng{SEED};
+    std::uniform_int_distribution<int> coordinate{0, CHUNK_SIZE_X - 1};
+    std::uniform_int_distribution<int> height{0, CHUNK_SIZE_Y - 1};
+    for (auto const& source : generate_chunks(8))
+    {
+        INFO("chunk [" << source.getPosition().x() << ", " << source.getPosition().z() << "]");
+
+        SECTION("replaceBlocks")
+        {
+            // DIRT -> STONE keeps heightmaps, GRASS -> AIR lowers them
+            for (auto [from, to] : {std::pair{BlockType::DIRT, BlockType::STONE}, std::pair{BlockType::GRASS, BlockType::AIR}})
+            {
+                Chunk bulk = source;
+                Chunk reference = source;
+                bulk.replaceBlocks(from, to);
+                for (int y = 0; y < CHUNK_SIZE_Y; ++y)
+                    for (int z = 0; z < CHUNK_SIZE_Z; ++z)
+                        for (int x = 0; x < CHUNK_SIZE_X; ++x)
+                            if (reference.getBlockUnchecked(x, y, z).type == from)
+                                reference.setBlockUnchecked(x, y, z, Block{to});
+                REQUIRE(same_chunk(bulk, reference));
+            }
+        }
+
+        SECTION("fillRegion")
+        {
+            // Random boxes, including full-width and multi-section ones
+            Chunk bulk = source;
+            Chunk reference = source;
+            for (int i = 0; i < 8; ++i)
+            {
+                int const x0 = i % 4 == 0 ? 0 : coordinate(rng), x1 = i % 4 == 0 ? CHUNK_SIZE_X - 1 : coordinate(rng);
+                int const z0 = i % 2 == 0 ? 0 : coordinate(rng), z1 = i % 2 == 0 ? CHUNK_SIZE_Z - 1 : coordinate(rng);
+                int const y0 = height(rng), y1 = height(rng);
+                Magnum::Vector3i const min{std::min(x0, x1), std::min(y0, y1), std::min(z0, z1)};
+                Magnum::Vector3i const max{std::max(x0, x1), std::max(y0, y1), std::max(z0, z1)};
+                Block const block{static_cast<BlockType>(rng() % BLOCK_TYPE_COUNT)};
+
+                bulk.fillRegion(min, max, block);
+                for (int y = min.y(); y <= max.y(); ++y)
+                    for (int z = min.z(); z <= max.z(); ++z)
+                        for (int x = min.x(); x <= max.x(); ++x)
+                            reference.setBlock(x, y, z, block);
+            }
+            REQUIRE(same_chunk(bulk, reference));
+        }
+    }
+}
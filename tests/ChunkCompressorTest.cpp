@@ -0,0 +1,108 @@
+#include "TestCommon.hpp"
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+#include <vector>
+
+#include <catch2/catch_test_macros.hpp>
+#include <concurrencpp/concurrencpp.h>
+#include <world/Chunk.hpp>
+#include <world/ChunkCompressor.hpp>
+#include <world/ChunkGenerator.hpp>
+#include <world/ChunkPersistence.hpp>
+#include <world/ChunkSerializer.hpp>
+
+namespace
+{
+using namespace mc::world;
+
+/**
+ * @brief Encoded generated chunks, enough to train a dictionary on.
+ */
+std::vector<std::vector<std::byte>> encoded_chunks(int side)
+{
+    ChunkGenerator generator{1337};
+    std::vector<std::vector<std::byte>> chunks;
+    std::vector<ChunkGenerator::Decoration> overflow;
+    for (int z = 0; z < side; ++z)
+    {
+        for (int x = 0; x < side; ++x)
+        {
+            Chunk chunk{{x * 7, 0, z * 7}};
+            generator.generate(chunk);
+            generator.generateFeatures(chunk, overflow);
+            chunks.push_back(ChunkSerializer::encode(chunk));
+        }
+    }
+    return chunks;
+}
+
+} // namespace
+
+TEST_CASE("Stored compressors read the frames of the original", "[compressor]")
+{
+    auto const chunks = encoded_chunks(16);
+    auto const dictionary = ChunkCompressor::trainDictionary(chunks);
+    auto const path = mc::test::unique_temp_directory("mc_compressor_test") / "chunks.dict";
+
+    ChunkCompressor const original{{CompressionCodec::ZSTD, 7}, dictionary};
+    original.store(path);
+    ChunkCompressor const loaded = ChunkCompressor::load(path);
+    REQUIRE(loaded.getSettings().codec == CompressionCodec::ZSTD);
+    REQUIRE(loaded.getSettings().level == 7);
+    REQUIRE(loaded.getDictionaryId() == original.getDictionaryId());
+
+    std::vector<std::byte> frame;
+    std::vector<std::byte> decompressed;
+    original.compress(chunks.front(), frame);
+    loaded.decompress(frame, decompressed);
+    REQUIRE(decompressed == chunks.front());
+
+    SECTION("corrupt files are rejected")
+    {
+        std::filesystem::resize_file(path, 9);
+        REQUIRE_THROWS_AS(ChunkCompressor::load(path), ChunkFormatError);
+        {
+            std::ofstream file{path, std::ios::binary | std::ios::trunc};
+            file << "MCCD\x01\x02\x00\x00\x00\x00not a dictionary";
+        }
+        REQUIRE_THROWS_AS(ChunkCompressor::load(path), ChunkFormatError);
+    }
+}
+
+TEST_CASE("Reopened worlds keep their compression and dictionary", "[compressor]")
+{
+    mc::test::init_logging();
+    auto const chunks = encoded_chunks(16);
+    auto const dictionary = ChunkCompressor::trainDictionary(chunks);
+    auto const directory = mc::test::unique_temp_directory("mc_compressor_persistence_test");
+    concurrencpp::runtime runtime;
+    auto ioExecutor = runtime.make_executor<concurrencpp::thread_pool_executor>("test io", 1, std::chrono::seconds{10});
+
+    Chunk saved{{3, 0, -4}};
+    ChunkGenerator{1337}.generate(saved);
+    {
+        ChunkPersistence persistence{directory, ioExecutor, {CompressionCodec::ZSTD, 5}, dictionary};
+        persistence.save(Chunk{saved}, {});
+        persistence.wait();
+    }
+
+    // Opened with the defaults, as a restarted server does
+    ChunkPersistence persistence{directory, ioExecutor};
+    REQUIRE(persistence.getCompressor().getSettings().codec == CompressionCodec::ZSTD);
+    REQUIRE(persistence.getCompressor().getSettings().level == 5);
+    REQUIRE(persistence.getCompressor().getDictionaryId() == ChunkCompressor{{}, dictionary}.getDictionaryId());
+
+    Chunk loaded{{0, 0, 0}};
+    std::vector<ChunkGenerator::Decoration> decorations;
+    uint32_t decoratedBy = 0;
+    REQUIRE(persistence.load(saved.getPosition(), loaded, decorations, decoratedBy));
+    REQUIRE(ChunkSerializer::encode(loaded) == ChunkSerializer::encode(saved));
+
+    auto const otherDictionary = ChunkCompressor::trainDictionary(encoded_chunks(12));
+    REQUIRE_THROWS_AS(ChunkPersistence(directory, ioExecutor, {}, otherDictionary), std::invalid_argument);
+}
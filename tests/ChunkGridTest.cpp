@@ -0,0 +1,36 @@
+#include "TestCommon.hpp"
+
+#include <catch2/catch_test_macros.hpp>
+#include <concurrencpp/concurrencpp.h>
+#include <ecs/events/EventBus.hpp>
+
+TEST_CASE("Chunks unloaded while outside the grid window stay unloaded when it returns", "[world]")
+{
+    using namespace mc;
+    test::init_logging();
+    concurrencpp::runtime runtime;
+    ecs::EventBus eventBus;
+    world::World world{runtime.thread_pool_executor(), eventBus, 1337};
+
+    // A radius of 2 gives an 8 wide grid, whose slots for x = 0 and 6 are outside the
+    // window centered on x = 3 and keep their chunks
+    world.recenterChunkGrid({0, 0, 0}, 2);
+    test::load_world(world, {0, 0, 0}, 1);
+    REQUIRE(world.isChunkLoaded({0, 0, 0}));
+
+    world.recenterChunkGrid({3, 0, 0}, 2);
+    REQUIRE(world.unloadChunksOutsideRadius({100, 0, 100}, 1) == 9);
+    REQUIRE(world.getChunks().empty());
+
+    world.recenterChunkGrid({0, 0, 0}, 2);
+    for (int z = -1; z <= 1; ++z)
+    {
+        for (int x = -1; x <= 1; ++x)
+            REQUIRE_FALSE(world.isChunkLoaded({x, 0, z}));
+    }
+
+    // Loaded again instead of being taken for still loaded
+    test::load_world(world, {0, 0, 0}, 1);
+    REQUIRE(world.getChunks().size() == 9);
+    REQUIRE(world.getChunk({0, 0, 0}) == world.getChunks().at({0, 0, 0}));
+}
@@ -0,0 +1,219 @@
+#include "TestCommon.hpp"
+
+#include <chrono>
+#include <cstddef>
+#include <filesystem>
+#include <future>
+#include <optional>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#include <catch2/catch_test_macros.hpp>
+#include <concurrencpp/concurrencpp.h>
+#include <ecs/events/EventBus.hpp>
+#include <world/Chunk.hpp>
+#include <world/ChunkGenerator.hpp>
+#include <world/ChunkPersistence.hpp>
+#include <world/RegionFile.hpp>
+#include <world/RegionStorage.hpp>
+#include <world/World.hpp>
+
+using namespace mc::world;
+
+namespace
+{
+/**
+ * @brief Leaves a neighbour's tree grew into a loaded chunk of @p world, away from its border.
+ */
+std::optional<ChunkGenerator::Decoration> find_neighbour_leaves(World const& world, int radius)
+{
+    std::vector<ChunkGenerator::Decoration> overflow;
+    for (auto const& [target, chunk] : world.getChunks())
+    {
+        if (target.x() * target.x() + target.z() * target.z() > (radius - 1) * (radius - 1))
+            continue;
+
+        for (int dz = -1; dz <= 1; ++dz)
+        {
+            for (int dx = -1; dx <= 1; ++dx)
+            {
+                Chunk source{target + Magnum::Vector3i{dx, 0, dz}};
+                world.getGenerator().generate(source);
+                overflow.clear();
+                world.getGenerator().generateFeatures(source, overflow);
+                for (auto const& decoration : overflow)
+                {
+                    if (decoration.chunkPos == target && decoration.block.type == BlockType::LEAVES
+                        && chunk->getBlock(decoration.x, decoration.y, decoration.z).type == BlockType::LEAVES)
+                        return decoration;
+                }
+            }
+        }
+    }
+    return std::nullopt;
+}
+
+uint64_t committed_from(World const& world, World::LoadSource source)
+{
+    return world.getLoadStats().committed[static_cast<std::size_t>(source)];
+}
+} // namespace
+
+TEST_CASE("Saves that cannot be written are retried, then reported", "[persistence]")
+{
+    mc::test::init_logging();
+    auto const directory = mc::test::unique_temp_directory("mc_persistence_test");
+    concurrencpp::runtime runtime;
+    auto ioExecutor = runtime.make_executor<concurrencpp::thread_pool_executor>("test io", 1, std::chrono::seconds{10});
+    ChunkPersistence persistence{directory, ioExecutor};
+
+    // A directory in the place of the region file makes every write of the chunk fail
+    Magnum::Vector3i const chunkPos{2, 0, 3};
+    auto const blocker = RegionStorage{directory}.regionPath(RegionFile::regionOf(chunkPos));
+    std::filesystem::create_directories(blocker);
+
+    Chunk chunk{chunkPos};
+    chunk.setBlock(1, 2, 3, Block{BlockType::STONE});
+    persistence.save(Chunk{chunk}, {});
+    REQUIRE_THROWS_AS(persistence.wait(), std::runtime_error);
+    auto stats = persistence.getStats();
+    REQUIRE(stats.retried == ChunkPersistence::MAX_WRITE_ATTEMPTS - 1);
+    REQUIRE(stats.failed == 1);
+    REQUIRE(stats.written == 0);
+
+    // Given up on, but kept in memory rather than lost
+    auto const pending = persistence.findPending(chunkPos);
+    REQUIRE(pending != nullptr);
+    REQUIRE(pending->chunk.getBlock(1, 2, 3).type == BlockType::STONE);
+    REQUIRE_THROWS_AS(persistence.wait(), std::runtime_error);
+
+    // The next save of the chunk tries again
+    std::filesystem::remove(blocker);
+    persistence.save(Chunk{chunk}, {});
+    REQUIRE_NOTHROW(persistence.wait());
+    stats = persistence.getStats();
+    REQUIRE(stats.written == 1);
+    REQUIRE(stats.pending == 0);
+    REQUIRE(persistence.isStored(chunkPos));
+}
+
+TEST_CASE("Autosave passes sync the region files they write", "[persistence]")
+{
+    mc::test::init_logging();
+    auto const directory = mc::test::unique_temp_directory("mc_autosave_sync_test");
+    concurrencpp::runtime runtime;
+    auto readExecutor = runtime.make_executor<concurrencpp::thread_pool_executor>("test reads", 1, std::chrono::seconds{10});
+    auto writeExecutor = runtime.make_executor<concurrencpp::thread_pool_executor>("test writes", 1, std::chrono::seconds{10});
+    mc::ecs::EventBus eventBus;
+    World world{runtime.thread_pool_executor(), eventBus, 1337};
+    world.enablePersistence(directory, readExecutor, writeExecutor);
+    world.setAutosave({std::chrono::milliseconds{0}, std::chrono::microseconds{500}});
+    mc::test::load_world(world, {0, 0, 0}, 1);
+
+    Magnum::Vector3i const chunkPos{1, 0, 0};
+    world.getChunks().at(chunkPos)->setBlock(1, 2, 3, Block{BlockType::STONE});
+    world.markChunkDirty(chunkPos);
+
+    // What a crash leaves behind: the header on disk, as another instance reads it
+    auto const path = RegionStorage{world.getPersistence()->getDirectory()}.regionPath(RegionFile::regionOf(chunkPos));
+    auto const synced = [&path, &chunkPos] { return std::filesystem::exists(path) && RegionFile{path}.contains(chunkPos); };
+    REQUIRE_FALSE(synced());
+
+    auto const deadline = std::chrono::steady_clock::now() + std::chrono::seconds{10};
+    while (!synced() && std::chrono::steady_clock::now() < deadline)
+    {
+        world.tickAutosave();
+        std::this_thread::sleep_for(std::chrono::milliseconds{1});
+    }
+    REQUIRE(synced());
+}
+
+TEST_CASE("Saved chunks come back from the in-flight buffer, then from disk", "[persistence]")
+{
+    mc::test::init_logging();
+    constexpr int RADIUS = 4;
+    constexpr int32_t SEED = 1337;
+    auto const directory = mc::test::unique_temp_directory("mc_world_persistence_test");
+    concurrencpp::runtime runtime;
+    auto readExecutor = runtime.make_executor<concurrencpp::thread_pool_executor>("test reads", 1, std::chrono::seconds{10});
+    auto writeExecutor = runtime.make_executor<concurrencpp::thread_pool_executor>("test writes", 1, std::chrono::seconds{10});
+    Magnum::Vector3i const far{1000, 0, 1000};
+
+    // The area generated without saves, and with the edit
+    mc::ecs::EventBus referenceBus;
+    World reference{runtime.thread_pool_executor(), referenceBus, SEED};
+    std::size_t const requested = mc::test::load_world(reference, {0, 0, 0}, RADIUS);
+    uint64_t const generatedDigest = mc::test::world_digest(reference);
+
+    // Leaves from a neighbour broken, which that neighbour generated again must not restore
+    auto const leaves = find_neighbour_leaves(reference, RADIUS);
+    REQUIRE(leaves.has_value());
+    Block const air{BlockType::AIR};
+    reference.getChunks().at(leaves->chunkPos)->setBlock(leaves->x, leaves->y, leaves->z, air);
+    uint64_t const editedDigest = mc::test::world_digest(reference);
+
+    {
+        mc::ecs::EventBus eventBus;
+        World world{runtime.thread_pool_executor(), eventBus, SEED};
+        world.enablePersistence(directory, readExecutor, writeExecutor);
+        mc::test::load_world(world, {0, 0, 0}, RADIUS);
+        REQUIRE(world.getLoadStats().misses == requested);
+        REQUIRE(world.getLoadStats().hits == 0);
+        REQUIRE(mc::test::world_digest(world) == generatedDigest);
+
+        world.getChunks().at(leaves->chunkPos)->setBlock(leaves->x, leaves->y, leaves->z, air);
+        world.markChunkDirty(leaves->chunkPos);
+
+        // Writes held back, so that the save stays in flight
+        std::promise<void> gate;
+        auto blocker = writeExecutor->submit([opened = gate.get_future().share()] { opened.wait(); });
+        world.unloadChunksOutsideRadius(far, 1);
+        bool const unloaded = world.getChunks().empty();
+        bool const inFlight = world.getPersistence()->findPending(leaves->chunkPos) != nullptr;
+        mc::test::load_world(world, {0, 0, 0}, RADIUS);
+        gate.set_value();
+        REQUIRE(unloaded);
+        REQUIRE(inFlight);
+        REQUIRE(committed_from(world, World::LoadSource::PENDING_SAVE) == 1);
+        REQUIRE(world.getLoadStats().hits == 1);
+        REQUIRE(world.getLoadStats().misses == 2 * requested - 1);
+        REQUIRE(mc::test::world_digest(world) == editedDigest);
+
+        world.saveAll();
+        REQUIRE(world.getPersistence()->findPending(leaves->chunkPos) == nullptr);
+        world.unloadChunksOutsideRadius(far, 1);
+        mc::test::load_world(world, {0, 0, 0}, RADIUS);
+        REQUIRE(committed_from(world, World::LoadSource::DISK) == 1);
+        REQUIRE(world.getLoadStats().hits == 2);
+        REQUIRE(world.getLoadStats().misses == 3 * requested - 2);
+        REQUIRE(world.getLoadStats().failures == 0);
+        REQUIRE(committed_from(world, World::LoadSource::GENERATOR) == world.getLoadStats().misses);
+        REQUIRE(mc::test::world_digest(world) == editedDigest);
+    }
+
+    {
+        // Restarted on the same directory
+        mc::ecs::EventBus eventBus;
+        World world{runtime.thread_pool_executor(), eventBus, SEED};
+        world.enablePersistence(directory, readExecutor, writeExecutor);
+        mc::test::load_world(world, {0, 0, 0}, RADIUS);
+        REQUIRE(committed_from(world, World::LoadSource::DISK) == 1);
+        REQUIRE(world.getLoadStats().hits == 1);
+        REQUIRE(world.getLoadStats().misses == requested - 1);
+        REQUIRE(mc::test::world_digest(world) == editedDigest);
+    }
+
+    // An unreadable chunk is generated again, as a miss and a failure
+    std::vector<std::byte> const garbage(64, std::byte{0x5a});
+    RegionStorage{directory / "region"}.write(leaves->chunkPos, garbage);
+
+    mc::ecs::EventBus eventBus;
+    World world{runtime.thread_pool_executor(), eventBus, SEED};
+    world.enablePersistence(directory, readExecutor, writeExecutor);
+    mc::test::load_world(world, {0, 0, 0}, RADIUS);
+    REQUIRE(world.getLoadStats().hits == 0);
+    REQUIRE(world.getLoadStats().misses == requested);
+    REQUIRE(world.getLoadStats().failures == 1);
+    REQUIRE(mc::test::world_digest(world) == generatedDigest);
+}
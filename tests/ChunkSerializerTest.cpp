@@ -0,0 +1,239 @@
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <catch2/catch_test_macros.hpp>
+#include <world/Chunk.hpp>
+#include <world/ChunkGenerator.hpp>
+#include <world/ChunkSerializer.hpp>
+
+namespace
+{
+using namespace mc::world;
+
+bool same_chunk(Chunk const& a, Chunk const& b)
+{
+    if (a.getPosition() != b.getPosition()) return false;
+    for (int y = 0; y < CHUNK_SIZE_Y; ++y)
+        for (int z = 0; z < CHUNK_SIZE_Z; ++z)
+            for (int x = 0; x < CHUNK_SIZE_X; ++x)
+                if (a.getBlockUnchecked(x, y, z).type != b.getBlockUnchecked(x, y, z).type) return false;
+
+    for (auto const type : {HeightmapType::HIGHEST_SOLID, HeightmapType::HIGHEST_NON_TRANSPARENT})
+        for (int z = 0; z < CHUNK_SIZE_Z; ++z)
+            for (int x = 0; x < CHUNK_SIZE_X; ++x)
+                if (a.getHeight(type, x, z) != b.getHeight(type, x, z)) return false;
+    return true;
+}
+
+bool same_decorations(std::vector<ChunkGenerator::Decoration> const& a, std::vector<ChunkGenerator::Decoration> const& b)
+{
+    if (a.size() != b.size()) return false;
+    for (std::size_t i = 0; i < a.size(); ++i)
+    {
+        if (a[i].chunkPos != b[i].chunkPos || a[i].x != b[i].x || a[i].y != b[i].y || a[i].z != b[i].z || a[i].block.type != b[i].block.type)
+            return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Decodes into a chunk holding other blocks, so nothing passes by staying as it was.
+ */
+Chunk decoded_from(std::span<std::byte const> data)
+{
+    Chunk decoded{{7, 0, -7}};
+    decoded.fillRegion({0, 0, 0}, {15, 100, 15}, Block{BlockType::WATER});
+    ChunkSerializer::decode(data, decoded);
+    return decoded;
+}
+
+/**
+ * @brief Hand-made chunks covering the corner cases of the format.
+ */
+std::vector<std::pair<std::string, Chunk>> edge_cases()
+{
+    std::vector<std::pair<std::string, Chunk>> cases;
+    auto const add = [&cases](std::string name, Magnum::Vector3i const& position, std::function<void(Chunk&)> const& build) {
+        Chunk chunk{position};
+        build(chunk);
+        cases.emplace_back(std::move(name), std::move(chunk));
+    };
+
+    add("all air", {0, 0, 0}, [](Chunk&) {});
+    add("all stone", {-1, 0, 1}, [](Chunk& c) { c.fillRegion({0, 0, 0}, {15, 255, 15}, Block{BlockType::STONE}); });
+    add("top block only", {INT32_MAX, 0, INT32_MIN}, [](Chunk& c) { c.setBlock(15, 255, 15, Block{BlockType::SNOW}); });
+    add("checkerboard", {3, 0, 4}, [](Chunk& c) {
+        for (int y = 0; y < CHUNK_SIZE_Y; ++y)
+            for (int z = 0; z < CHUNK_SIZE_Z; ++z)
+                for (int x = 0; x < CHUNK_SIZE_X; ++x)
+                    if ((x + y + z) % 2 == 0) c.setBlockUnchecked(x, y, z, Block{BlockType::DIRT});
+    });
+    add("random, every type", {-5, 0, -9}, [](Chunk& c) {
+        std::mt19937 rng{42};
+        std::uniform_int_distribution<int> type{0, static_cast<int>(BLOCK_TYPE_COUNT) - 1};
+        for (int y = 0; y < 64; ++y)
+            for (int z = 0; z < CHUNK_SIZE_Z; ++z)
+                for (int x = 0; x < CHUNK_SIZE_X; ++x)
+                    c.setBlockUnchecked(x, y, z, Block{static_cast<BlockType>(type(rng))});
+    });
+    add("edited down to one type", {1, 0, 1}, [](Chunk& c) {
+        // Leaves unreferenced palette entries behind, which are not written
+        c.fillRegion({0, 0, 0}, {15, 40, 15}, Block{BlockType::STONE});
+        c.setBlock(3, 20, 3, Block{BlockType::LOG});
+        c.setBlock(4, 20, 3, Block{BlockType::LEAVES});
+        c.setBlock(3, 20, 3, Block{BlockType::STONE});
+        c.setBlock(4, 20, 3, Block{BlockType::STONE});
+    });
+    return cases;
+}
+
+Chunk edited_chunk()
+{
+    return std::move(edge_cases().back().second);
+}
+} // namespace
+
+TEST_CASE("Chunks survive an encode/decode round trip", "[serializer]")
+{
+    SECTION("hand-made edge cases")
+    {
+        for (auto const& [name, chunk] : edge_cases())
+        {
+            INFO(name);
+            auto const encoded = ChunkSerializer::encode(chunk);
+            REQUIRE(ChunkSerializer::peekPosition(encoded) == chunk.getPosition());
+            REQUIRE(same_chunk(chunk, decoded_from(encoded)));
+        }
+    }
+
+    SECTION("generated terrain with features")
+    {
+        ChunkGenerator generator{1337};
+        generator.setBiomesEnabled(true);
+        std::vector<ChunkGenerator::Decoration> overflow;
+        for (int i = 0; i < 16; ++i)
+        {
+            Chunk chunk{{i % 4 * 37, 0, i / 4 * 37}};
+            generator.generate(chunk);
+            generator.generateFeatures(chunk, overflow);
+            INFO("chunk [" << chunk.getPosition().x() << ", " << chunk.getPosition().z() << "]");
+            REQUIRE(same_chunk(chunk, decoded_from(ChunkSerializer::encode(chunk))));
+        }
+    }
+
+    SECTION("decorations placed in other chunks and held from neighbours")
+    {
+        Chunk const chunk = edited_chunk();
+        std::vector<ChunkGenerator::Decoration> const decorations{
+            {chunk.getPosition() + Magnum::Vector3i{-1, 0, 1}, 15, 70, 0, Block{BlockType::LEAVES}},
+            {chunk.getPosition() + Magnum::Vector3i{1, 0, -1}, 0, 255, 15, Block{BlockType::LOG}},
+        };
+        for (uint32_t const decoratedBy : {0u, ChunkGenerator::decorationSourceBit({1, 0, -1}), ChunkGenerator::ALL_DECORATION_SOURCES})
+        {
+            INFO("decorated by " << decoratedBy);
+            Chunk decoded{{0, 0, 0}};
+            std::vector<ChunkGenerator::Decoration> decodedDecorations{decorations.front()};
+            uint32_t decodedBy = ~decoratedBy;
+            ChunkSerializer::decode(ChunkSerializer::encode(chunk, decorations, decoratedBy), decoded, decodedDecorations, decodedBy);
+            REQUIRE(same_chunk(chunk, decoded));
+            REQUIRE(same_decorations(decorations, decodedDecorations));
+            REQUIRE(decodedBy == decoratedBy);
+        }
+    }
+}
+
+TEST_CASE("Chunks written by older format versions stay readable", "[serializer]")
+{
+    Chunk const chunk = edited_chunk();
+    std::vector<ChunkGenerator::Decoration> const decorations{
+        {chunk.getPosition() + Magnum::Vector3i{0, 0, 1}, 4, 80, 0, Block{BlockType::LEAVES}},
+    };
+    Chunk decoded{{0, 0, 0}};
+    std::vector<ChunkGenerator::Decoration> decodedDecorations{{{0, 0, 0}, 0, 0, 0, Block{BlockType::LOG}}};
+    uint32_t decoratedBy = 0;
+
+    SECTION("version 2")
+    {
+        // Version 2 is version 3 without the mask of the neighbours the chunk holds
+        // decorations of, which then counts as every neighbour
+        auto version2 = ChunkSerializer::encode(chunk, decorations, 0);
+        version2[4] = std::byte{2};
+        version2.pop_back();
+        ChunkSerializer::decode(version2, decoded, decodedDecorations, decoratedBy);
+        REQUIRE(same_chunk(chunk, decoded));
+        REQUIRE(same_decorations(decorations, decodedDecorations));
+        REQUIRE(decoratedBy == ChunkGenerator::ALL_DECORATION_SOURCES);
+    }
+
+    SECTION("version 1")
+    {
+        // Version 1 is version 2 without the decoration count
+        auto version1 = ChunkSerializer::encode(chunk, {}, 0);
+        version1[4] = std::byte{1};
+        version1.resize(version1.size() - 2);
+        ChunkSerializer::decode(version1, decoded, decodedDecorations, decoratedBy);
+        REQUIRE(same_chunk(chunk, decoded));
+        REQUIRE(decodedDecorations.empty());
+        REQUIRE(decoratedBy == ChunkGenerator::ALL_DECORATION_SOURCES);
+    }
+}
+
+TEST_CASE("Corrupt chunk data is rejected", "[serializer]")
+{
+    Chunk const chunk = edited_chunk();
+    auto const encoded = ChunkSerializer::encode(chunk);
+    Chunk decoded{{0, 0, 0}};
+
+    SECTION("truncated")
+    {
+        for (std::size_t size = 0; size < encoded.size(); ++size)
+        {
+            INFO("truncated to " << size << " bytes");
+            REQUIRE_THROWS_AS(ChunkSerializer::decode(std::span{encoded}.first(size), decoded), ChunkFormatError);
+        }
+    }
+
+    SECTION("trailing byte")
+    {
+        auto trailing = encoded;
+        trailing.push_back(std::byte{0});
+        REQUIRE_THROWS_AS(ChunkSerializer::decode(trailing, decoded), ChunkFormatError);
+    }
+
+    SECTION("bad magic")
+    {
+        auto badMagic = encoded;
+        badMagic[0] ^= std::byte{0xFF};
+        REQUIRE_THROWS_AS(ChunkSerializer::decode(badMagic, decoded), ChunkFormatError);
+        REQUIRE_THROWS_AS(ChunkSerializer::peekPosition(badMagic), ChunkFormatError);
+    }
+
+    SECTION("newer format version")
+    {
+        auto newerVersion = encoded;
+        newerVersion[4] = static_cast<std::byte>(ChunkSerializer::FORMAT_VERSION + 1);
+        REQUIRE_THROWS_AS(ChunkSerializer::decode(newerVersion, decoded), ChunkFormatError);
+    }
+
+    SECTION("unknown block type")
+    {
+        auto badType = encoded;
+        badType[ChunkSerializer::HEADER_SIZE + 1] = static_cast<std::byte>(BLOCK_TYPE_COUNT);
+        REQUIRE_THROWS_AS(ChunkSerializer::decode(badType, decoded), ChunkFormatError);
+    }
+
+    SECTION("decoration source out of reach")
+    {
+        // The mask is the last field; replace it with the bit after the last neighbour's
+        auto badMask = encoded;
+        badMask.pop_back();
+        for (uint32_t value = ChunkGenerator::ALL_DECORATION_SOURCES + 1; value != 0; value >>= 7)
+            badMask.push_back(static_cast<std::byte>((value & 0x7F) | (value >= 0x80 ? 0x80 : 0)));
+        REQUIRE_THROWS_AS(ChunkSerializer::decode(badMask, decoded), ChunkFormatError);
+    }
+}
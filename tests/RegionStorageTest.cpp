@@ -0,0 +1,30 @@
+#include "TestCommon.hpp"
+
+#include <array>
+#include <cstddef>
+#include <filesystem>
+
+#include <catch2/catch_test_macros.hpp>
+#include <world/RegionFile.hpp>
+#include <world/RegionStorage.hpp>
+
+using namespace mc::world;
+
+TEST_CASE("Looking up regions without a file keeps the open files open", "[persistence]")
+{
+    auto const directory = mc::test::unique_temp_directory("mc_region_storage_test");
+    RegionStorage storage{directory, 1};
+
+    Magnum::Vector3i const chunkPos{1, 0, 2};
+    std::array<std::byte, 16> const data{};
+    storage.write(chunkPos, data);
+
+    for (int i = 1; i <= 8; ++i)
+        REQUIRE_FALSE(storage.contains({i * REGION_SIZE, 0, 0}));
+    REQUIRE(storage.contains(chunkPos));
+
+    // Closing the file would have synced its header; another instance reads it from disk
+    REQUIRE_FALSE(RegionFile{storage.regionPath(RegionFile::regionOf(chunkPos))}.contains(chunkPos));
+    storage.sync();
+    REQUIRE(RegionFile{storage.regionPath(RegionFile::regionOf(chunkPos))}.contains(chunkPos));
+}
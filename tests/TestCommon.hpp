@@ -0,0 +1,95 @@
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <filesystem>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include <Magnum/Math/Vector3.h>
+#include <core/Logger.hpp>
+#include <utils/IVec3Hasher.hpp>
+#include <world/Chunk.hpp>
+#include <world/World.hpp>
+
+namespace mc::test
+{
+
+/**
+ * @brief Initializes the logger once per test run and silences the per-chunk spam produced by the world.
+ */
+inline void init_logging()
+{
+    static bool const initialized = [] {
+        core::Logger::init();
+        core::Logger::get()->set_level(spdlog::level::warn);
+        return true;
+    }();
+    (void)initialized;
+}
+
+/**
+ * @brief Empty directory under the temporary directory, named after @p name and made
+ * unique so that concurrent test runs do not share it.
+ */
+inline std::filesystem::path unique_temp_directory(std::string const& name)
+{
+    auto const ticks = std::chrono::steady_clock::now().time_since_epoch().count();
+    auto const directory = std::filesystem::temp_directory_path() / (name + "-" + std::to_string(ticks));
+    std::filesystem::remove_all(directory);
+    std::filesystem::create_directories(directory);
+    return directory;
+}
+
+/**
+ * @brief Loads every chunk within a circular radius through the regular World path and waits for it.
+ *
+ * @return Number of chunks requested.
+ */
+inline std::size_t load_world(world::World& world, Magnum::Vector3i const& center, int radius)
+{
+    float const r = static_cast<float>(radius) + 0.5f;
+    std::vector<Magnum::Vector3i> positions;
+    for (int x = -radius; x <= radius; ++x)
+    {
+        for (int z = -radius; z <= radius; ++z)
+        {
+            if (static_cast<float>(x * x + z * z) > r * r) continue;
+            positions.push_back(center + Magnum::Vector3i{x, 0, z});
+        }
+    }
+    world.submitChunkLoads(positions);
+
+    while (!world.getPendingChunks().empty())
+    {
+        world.integrateFinishedChunks();
+        std::this_thread::sleep_for(std::chrono::milliseconds{1});
+    }
+    return positions.size();
+}
+
+/**
+ * @brief Hash of every loaded chunk's blocks, independent of the order chunks were loaded in
+ * and of how their sections happen to be encoded.
+ */
+inline uint64_t world_digest(world::World const& world)
+{
+    std::vector<std::pair<Magnum::Vector3i, world::Chunk const*>> chunks(world.getChunks().begin(), world.getChunks().end());
+    std::ranges::sort(chunks, {}, [](auto const& entry) { return std::pair{entry.first.z(), entry.first.x()}; });
+
+    uint64_t digest = 0;
+    for (auto const& [chunkPos, chunk] : chunks)
+    {
+        digest = utils::mix64(digest ^ utils::IVec3Hasher{}(chunkPos));
+        for (int y = 0; y < world::CHUNK_SIZE_Y; ++y)
+            for (int z = 0; z < world::CHUNK_SIZE_Z; ++z)
+                for (int x = 0; x < world::CHUNK_SIZE_X; ++x)
+                    digest = utils::mix64(digest ^ static_cast<uint64_t>(chunk->getBlockUnchecked(x, y, z).type));
+    }
+    return digest;
+}
+
+} // namespace mc::test
@@ -0,0 +1,101 @@
+#include "TestCommon.hpp"
+
+#include <chrono>
+#include <optional>
+#include <ranges>
+#include <thread>
+#include <utility>
+
+#include <catch2/catch_test_macros.hpp>
+#include <concurrencpp/concurrencpp.h>
+#include <ecs/events/EventBus.hpp>
+#include <world/GenerationStage.hpp>
+
+namespace
+{
+using namespace mc;
+
+constexpr int RADIUS = 6;
+constexpr int32_t SEED = 1337;
+
+struct Run
+{
+    uint64_t digest;
+    std::size_t leaves;
+    world::World::GenerationStats stats;
+};
+
+/**
+ * @param oneByOne Submits chunks one at a time in reverse order instead of all at once
+ */
+Run load(concurrencpp::runtime& runtime, std::size_t threads, int regionChunks, bool oneByOne)
+{
+    auto executor = runtime.make_executor<concurrencpp::thread_pool_executor>("test chunks", threads, std::chrono::seconds{10});
+    ecs::EventBus eventBus;
+    world::World world{executor, eventBus, SEED};
+    world.setRegionBatching(regionChunks);
+
+    if (oneByOne)
+    {
+        for (int x = RADIUS; x >= -RADIUS; --x)
+        {
+            for (int z = RADIUS; z >= -RADIUS; --z)
+            {
+                if (static_cast<float>(x * x + z * z) > (RADIUS + 0.5f) * (RADIUS + 0.5f)) continue;
+                world.submitChunkLoad({x, 0, z});
+                world.integrateFinishedChunks();
+            }
+        }
+        while (!world.getPendingChunks().empty())
+        {
+            world.integrateFinishedChunks();
+            std::this_thread::sleep_for(std::chrono::milliseconds{1});
+        }
+    }
+    else
+    {
+        test::load_world(world, {0, 0, 0}, RADIUS);
+    }
+
+    std::size_t leaves = 0;
+    for (auto const* chunk : world.getChunks() | std::views::values)
+        leaves += chunk->countBlocks(world::BlockType::LEAVES);
+
+    Run run{test::world_digest(world), leaves, world.getGenerationStats()};
+    executor->shutdown();
+    return run;
+}
+} // namespace
+
+TEST_CASE("Generation does not depend on worker count, region size or submission order", "[world]")
+{
+    test::init_logging();
+    concurrencpp::runtime runtime;
+
+    std::optional<uint64_t> expected;
+    for (std::size_t const threads : {1, 2, 4})
+    {
+        for (auto const& [regionChunks, oneByOne] : {std::pair{1, false}, std::pair{4, false}, std::pair{4, true}})
+        {
+            INFO(threads << " threads, region " << regionChunks << (oneByOne ? ", reversed" : ", batch"));
+            auto const run = load(runtime, threads, regionChunks, oneByOne);
+
+            // Every stage ran exactly once on every chunk that has completed it
+            std::size_t reached = 0;
+            for (auto stage = world::GenerationStage::FINALIZED; stage > world::GenerationStage::EMPTY;
+                stage = static_cast<world::GenerationStage>(static_cast<int>(stage) - 1))
+            {
+                auto const index = static_cast<std::size_t>(stage);
+                reached += run.stats.chunksAtStage[index];
+                INFO("stage " << world::stage_name(stage));
+                REQUIRE(run.stats.stageRuns[index] == reached);
+            }
+
+            // Trees reach across chunk borders, so they are what an order dependence would break
+            REQUIRE(run.leaves > 0);
+            if (expected)
+                REQUIRE(run.digest == *expected);
+            expected = run.digest;
+        }
+    }
+}